@@ -18,6 +18,7 @@
 #include "devices/I3DDevice.h"
 #include "devices/IDeviceFactory.h"
 #include "devices/ReadDevice.h"
+#include "devices/SoftwareDevice.h"
 #include "Exception.h"
 
 #include <cassert>
@@ -248,6 +249,60 @@ AUD_API void AUD_Device_setVolume(AUD_Device* device, float value)
 	dev->setVolume(value);
 }
 
+AUD_API int AUD_Device_setParameterBatching(AUD_Device* device, int batching)
+{
+	auto dev = std::dynamic_pointer_cast<SoftwareDevice>(device ? *device : DeviceManager::getDevice());
+
+	if(!dev.get())
+		return false;
+
+	dev->setParameterBatching(batching);
+	return true;
+}
+
+AUD_API void AUD_Device_commitParameters(AUD_Device* device)
+{
+	auto dev = std::dynamic_pointer_cast<SoftwareDevice>(device ? *device : DeviceManager::getDevice());
+
+	if(dev.get())
+		dev->commitParameters();
+}
+
+AUD_API int AUD_Device_setVoiceBudget(AUD_Device* device, int max_voices, float virtual_volume)
+{
+	auto dev = std::dynamic_pointer_cast<SoftwareDevice>(device ? *device : DeviceManager::getDevice());
+
+	if(!dev.get())
+		return false;
+
+	dev->setVoiceBudget(max_voices, virtual_volume);
+	return true;
+}
+
+AUD_API int AUD_Device_setRenderThreads(AUD_Device* device, int threads)
+{
+	auto dev = std::dynamic_pointer_cast<SoftwareDevice>(device ? *device : DeviceManager::getDevice());
+
+	if(!dev.get())
+		return false;
+
+	dev->setRenderThreads(threads);
+	return true;
+}
+
+AUD_API int AUD_Device_getVoiceStats(AUD_Device* device, int* real_voices, int* virtual_voices, float* mix_time)
+{
+	auto dev = std::dynamic_pointer_cast<SoftwareDevice>(device ? *device : DeviceManager::getDevice());
+
+	if(!dev.get())
+		return false;
+
+	*real_voices = dev->getRealVoiceCount();
+	*virtual_voices = dev->getVirtualVoiceCount();
+	*mix_time = dev->getMixTime();
+	return true;
+}
+
 AUD_API int AUD_Device_read(AUD_Device* device, unsigned char* buffer, int length)
 {
 	assert(device);
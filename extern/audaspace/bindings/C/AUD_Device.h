@@ -192,6 +192,53 @@ extern AUD_API float AUD_Device_getVolume(AUD_Device* device);
  */
 extern AUD_API void AUD_Device_setVolume(AUD_Device* device, float value);
 
+/**
+ * Enables or disables the batching of the handle parameter updates of a
+ * software mixing device. While batching, the location, velocity, orientation,
+ * volume and pitch of the handles are applied together at the next mix after
+ * AUD_Device_commitParameters.
+ * param device The device to set the batching from.
+ * param batching Whether to batch the parameter updates.
+ * return Whether the device supports the batching.
+ */
+extern AUD_API int AUD_Device_setParameterBatching(AUD_Device* device, int batching);
+
+/**
+ * Commits the handle parameters set since the last commit.
+ * param device The device to commit the parameters of.
+ */
+extern AUD_API void AUD_Device_commitParameters(AUD_Device* device);
+
+/**
+ * Sets the voice budget of a software mixing device. The voices over the
+ * budget, with the lowest priority then the quietest, and the voices quieter
+ * than the virtual volume are virtual: they advance without being mixed.
+ * param device The device to set the voice budget from.
+ * param max_voices The maximum number of real voices, 0 for no limit.
+ * param virtual_volume The volume under which the voices are virtual, negative to disable.
+ * return Whether the device supports the voice budget.
+ */
+extern AUD_API int AUD_Device_setVoiceBudget(AUD_Device* device, int max_voices, float virtual_volume);
+
+/**
+ * Sets the number of threads rendering the voices of a software mixing
+ * device. The voices are read in parallel and mixed in the playing order.
+ * param device The device to set the number of threads from.
+ * param threads The number of threads including the mixing thread, 1 to render on the mixing thread only.
+ * return Whether the device supports parallel rendering.
+ */
+extern AUD_API int AUD_Device_setRenderThreads(AUD_Device* device, int threads);
+
+/**
+ * Retrieves the voice statistics of the last mix of a software mixing device.
+ * param device The device to get the statistics from.
+ * param real_voices The number of voices mixed.
+ * param virtual_voices The number of virtual voices.
+ * param mix_time The duration of the mix in seconds.
+ * return Whether the device provides the statistics.
+ */
+extern AUD_API int AUD_Device_getVoiceStats(AUD_Device* device, int* real_voices, int* virtual_voices, float* mix_time);
+
 /**
  * Reads the next samples into the supplied buffer.
  * \param device The readable device.
@@ -15,6 +15,7 @@
  ******************************************************************************/
 
 #include "devices/I3DHandle.h"
+#include "devices/SoftwareDevice.h"
 #include "Exception.h"
 
 #include <cassert>
@@ -271,6 +272,12 @@ AUD_API int AUD_Handle_setPosition(AUD_Handle* handle, double value)
 	return (*handle)->seek(value);
 }
 
+AUD_API int AUD_Handle_setPriority(AUD_Handle* handle, int value)
+{
+	assert(handle);
+	return SoftwareDevice::setPriority(handle->get(), value);
+}
+
 AUD_API int AUD_Handle_isRelative(AUD_Handle* handle)
 {
 	assert(handle);
@@ -220,6 +220,15 @@ extern AUD_API double AUD_Handle_getPosition(AUD_Handle* handle);
  */
 extern AUD_API int AUD_Handle_setPosition(AUD_Handle* handle, double value);
 
+/**
+ * Sets the priority of a handle of a software mixing device, used to choose
+ * the voices made virtual when the voice budget of the device is exceeded.
+ * param handle The handle to set the priority from.
+ * param value The new priority to set, higher is more important.
+ * return Whether the handle supports priorities.
+ */
+extern AUD_API int AUD_Handle_setPriority(AUD_Handle* handle, int value);
+
 /**
  * Retrieves the relative of a handle.
  * param handle The handle to get the relative from.
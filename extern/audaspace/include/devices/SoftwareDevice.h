@@ -29,8 +29,11 @@
 #include "devices/DefaultSynchronizer.h"
 #include "util/Buffer.h"
 
+#include <atomic>
 #include <list>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 AUD_NAMESPACE_BEGIN
 
@@ -38,6 +41,7 @@ class Mixer;
 class PitchReader;
 class ResampleReader;
 class ChannelMapperReader;
+class ThreadPool;
 
 /**
  * The software device is a generic device with software mixing.
@@ -51,8 +55,44 @@ class ChannelMapperReader;
 class AUD_API SoftwareDevice : public IDevice, public I3DDevice
 {
 protected:
+	/// The parameters of a handle updated in batches.
+	enum BatchFlags
+	{
+		BATCH_LOCATION = 0x01,
+		BATCH_VELOCITY = 0x02,
+		BATCH_ORIENTATION = 0x04,
+		BATCH_VOLUME = 0x08,
+		BATCH_PITCH = 0x10
+	};
+
+	/// Parameters of a handle set while the device batches the parameter updates.
+	struct BatchParameters
+	{
+		/// The parameters set, see BatchFlags.
+		int flags;
+
+		Vector3 location;
+		Vector3 velocity;
+		Quaternion orientation;
+		float volume;
+		float pitch;
+	};
+
+	/// A part of the samples of a voice rendered for a mix, between the loops of the source.
+	struct RenderSegment
+	{
+		/// The position of the part in samples of the mix.
+		int position;
+
+		/// The length of the part in samples.
+		int length;
+
+		/// The volume at the start of the part, ramped to the volume of the voice.
+		float old_volume;
+	};
+
 	/// Saves the data for playback.
-	class AUD_API SoftwareHandle : public IHandle, public I3DHandle
+	class AUD_API SoftwareHandle : public IHandle, public I3DHandle, public std::enable_shared_from_this<SoftwareHandle>
 	{
 	private:
 		// delete copy constructor and operator=
@@ -144,9 +184,33 @@ protected:
 		/// Current status of the handle
 		Status m_status;
 
+		/// The priority of the voice against the other voices when the voice budget is exceeded.
+		int m_priority;
+
+		/// Whether the voice is virtual: its position advances without reading or mixing the source.
+		bool m_virtual;
+
+		/// The position of a virtual voice in samples of the source.
+		double m_virtual_position;
+
 		/// Own device.
 		SoftwareDevice* m_device;
 
+		/// Parameters set since the last commit, only accessed by the thread setting the parameters.
+		BatchParameters m_queued;
+
+		/// Committed parameters waiting for the next mix, protected by the batch mutex of the device.
+		BatchParameters m_committed;
+
+		/// The buffer a real voice is rendered to when rendering in parallel.
+		Buffer m_render_buffer;
+
+		/// The parts of the rendered samples, starting with the first sample of the mix.
+		std::vector<RenderSegment> m_render_segments;
+
+		/// Whether the end of the source was reached while rendering.
+		bool m_render_eos;
+
 		/**
 		 * This method is for internal use only.
 		 * @param keep Whether the sound should be marked stopped or paused.
@@ -154,6 +218,21 @@ protected:
 		 */
 		bool pause(bool keep);
 
+		/**
+		 * Queues a parameter until the next commit of the device.
+		 * @param flag The parameter set.
+		 * @return The queued parameters to write the value to.
+		 */
+		BatchParameters& queueParameter(int flag);
+
+		/**
+		 * Retrieves the batched parameters containing a parameter not applied yet.
+		 * @param flag The parameter to look for.
+		 * @param parameters The parameters found.
+		 * @return Whether the parameter was set since the last mix.
+		 */
+		bool getBatchedParameter(int flag, BatchParameters& parameters);
+
 	public:
 		/**
 		 * Creates a new software handle.
@@ -171,6 +250,40 @@ protected:
 		 */
 		void update();
 
+		/**
+		 * Retrieves whether the voice can be made virtual, which requires a source of known length.
+		 * \return Whether the voice can be made virtual.
+		 */
+		bool isVirtualizable();
+
+		/**
+		 * Makes the voice virtual or real.
+		 * \param virtualize Whether the voice becomes virtual.
+		 */
+		void setVirtual(bool virtualize);
+
+		/**
+		 * Advances the position of a virtual voice without reading the source.
+		 * \param length The length in samples of the device to skip.
+		 * \return Whether the end of the source was reached.
+		 */
+		bool skip(int length);
+
+		/**
+		 * Reads the samples of a real voice for a mix, looping the source if
+		 * needed, and records the parts to mix in the render segments.
+		 * \param buffer The buffer to read to, large enough for length samples of the device.
+		 * \param length The length in samples of the device to read.
+		 * \note The voices are independent and can be rendered in parallel.
+		 */
+		void render(sample_t* buffer, int length);
+
+		/**
+		 * Applies the committed parameters.
+		 * \note This method is only called when the batch mutex of the device is locked.
+		 */
+		void applyCommittedParameters();
+
 		/**
 		 * Sets the audio output specification of the readers.
 		 * \param specs The output specification.
@@ -303,6 +416,70 @@ private:
 	 */
 	std::recursive_mutex m_mutex;
 
+	/**
+	 * Whether the handle parameter updates are batched.
+	 */
+	bool m_batching;
+
+	/**
+	 * The maximum number of real voices, 0 for no limit.
+	 */
+	int m_max_voices;
+
+	/**
+	 * The volume under which the voices are made virtual, negative to never
+	 * make them virtual because they are quiet.
+	 */
+	float m_virtual_volume;
+
+	/**
+	 * The voices candidate to be real, only used while mixing.
+	 */
+	std::vector<SoftwareHandle*> m_voices;
+
+	/**
+	 * The number of real and virtual voices and the time in seconds of the last mix.
+	 */
+	std::atomic<int> m_real_voice_count;
+	std::atomic<int> m_virtual_voice_count;
+	std::atomic<float> m_mix_time;
+
+	/**
+	 * The number of threads rendering the voices, 1 to render on the mixing thread only.
+	 */
+	int m_render_threads;
+
+	/**
+	 * The threads helping the mixing thread to render the voices.
+	 */
+	std::shared_ptr<ThreadPool> m_render_pool;
+
+	/**
+	 * The index of the next real voice to render, shared by the rendering threads.
+	 */
+	std::atomic<int> m_render_index;
+
+	/**
+	 * Renders the real voices not taken by another thread yet.
+	 * \param length The length in samples of the mix.
+	 */
+	void renderVoices(int length);
+
+	/**
+	 * The handles with queued parameters.
+	 */
+	std::vector<std::shared_ptr<SoftwareHandle> > m_queuedHandles;
+
+	/**
+	 * The handles with committed parameters, protected by m_batch_mutex.
+	 */
+	std::vector<std::shared_ptr<SoftwareHandle> > m_committedHandles;
+
+	/**
+	 * The mutex for the committed parameters, only locked while they are copied.
+	 */
+	std::mutex m_batch_mutex;
+
 	/**
 	 * The overall volume of the device.
 	 */
@@ -351,6 +528,96 @@ public:
 	 */
 	void setQuality(ResampleQuality quality);
 
+	/**
+	 * Sets the priority of a specific handle. When there are more audible
+	 * voices than the voice budget of the device, the voices with the lowest
+	 * priority, then the quietest, are made virtual.
+	 * \param handle The handle to set the priority from.
+	 * \param priority The new priority, higher is more important.
+	 * \return Whether the handle is a handle of a software device.
+	 */
+	static bool setPriority(IHandle* handle, int priority);
+
+	/**
+	 * Sets the voice budget of the device. The voices over the budget and the
+	 * voices quieter than the virtual volume are made virtual: their position
+	 * advances but they are not read or mixed until they are real again.
+	 * \param max_voices The maximum number of real voices, 0 for no limit.
+	 * \param virtual_volume The volume under which the voices are virtual,
+	 *        negative to disable.
+	 */
+	void setVoiceBudget(int max_voices, float virtual_volume);
+
+	/**
+	 * Retrieves the maximum number of real voices.
+	 * \return The maximum number of real voices, 0 for no limit.
+	 */
+	int getMaxVoices() const;
+
+	/**
+	 * Retrieves the volume under which the voices are virtual.
+	 * \return The virtual volume, negative if disabled.
+	 */
+	float getVirtualVolume() const;
+
+	/**
+	 * Retrieves the number of voices mixed during the last mix.
+	 * \return The number of real voices.
+	 */
+	int getRealVoiceCount() const;
+
+	/**
+	 * Retrieves the number of voices skipped during the last mix.
+	 * \return The number of virtual voices.
+	 */
+	int getVirtualVoiceCount() const;
+
+	/**
+	 * Retrieves the duration of the last mix.
+	 * \return The mix time in seconds.
+	 */
+	float getMixTime() const;
+
+	/**
+	 * Sets the number of threads rendering the voices. The voices are read,
+	 * including their decoding, resampling and effects, in parallel into
+	 * buffers of their own, then mixed in the playing order so the output
+	 * doesn't depend on the number of threads.
+	 * \param threads The number of threads including the mixing thread, 1 to
+	 *        render on the mixing thread only.
+	 * \note The sources of different handles must not share a reader.
+	 */
+	void setRenderThreads(int threads);
+
+	/**
+	 * Retrieves the number of threads rendering the voices.
+	 * \return The number of threads including the mixing thread.
+	 */
+	int getRenderThreads() const;
+
+	/**
+	 * Enables or disables the batching of the handle parameter updates.
+	 * While batching, the location, velocity, orientation, volume and pitch
+	 * set on the handles are queued and applied all together at the first
+	 * mix after commitParameters(), without locking the device.
+	 * Disabling the batching commits the queued parameters.
+	 * \param batching Whether to batch the parameter updates.
+	 * \note The parameters have to be set and committed from the same thread.
+	 */
+	void setParameterBatching(bool batching);
+
+	/**
+	 * Retrieves whether the handle parameter updates are batched.
+	 * \return Whether the parameter updates are batched.
+	 */
+	bool isParameterBatching() const;
+
+	/**
+	 * Commits the queued handle parameters, called once per update of the
+	 * application, e.g. a frame of a game.
+	 */
+	void commitParameters();
+
 	virtual DeviceSpecs getSpecs() const;
 	virtual std::shared_ptr<IHandle> play(std::shared_ptr<IReader> reader, bool keep = false);
 	virtual std::shared_ptr<IHandle> play(std::shared_ptr<ISound> sound, bool keep = false);
@@ -124,6 +124,13 @@ public:
 	 * \param length The length of the buffer in samples.
 	 */
 	void clear(int length);
+
+	/**
+	 * Returns the name of the instruction set used for mixing, selected at
+	 * runtime for the processor.
+	 * \return The name of the instruction set.
+	 */
+	static const char* getKernelName();
 };
 
 AUD_NAMESPACE_END
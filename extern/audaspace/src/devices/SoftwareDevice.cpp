@@ -20,10 +20,12 @@
 #include "respec/JOSResampleReader.h"
 #include "respec/LinearResampleReader.h"
 #include "respec/Mixer.h"
+#include "util/ThreadPool.h"
 #include "Exception.h"
 #include "ISound.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstring>
 #include <iostream>
@@ -81,8 +83,40 @@ SoftwareDevice::SoftwareHandle::SoftwareHandle(SoftwareDevice* device, std::shar
 	m_reader(reader), m_pitch(pitch), m_resampler(resampler), m_mapper(mapper), m_first_reading(true), m_keep(keep), m_user_pitch(1.0f), m_user_volume(1.0f), m_user_pan(0.0f), m_volume(0.0f), m_old_volume(0.0f), m_loopcount(0),
 	m_relative(true), m_volume_max(1.0f), m_volume_min(0), m_distance_max(std::numeric_limits<float>::max()),
 	m_distance_reference(1.0f), m_attenuation(1.0f), m_cone_angle_outer(M_PI), m_cone_angle_inner(M_PI), m_cone_volume_outer(0),
-	m_flags(RENDER_CONE), m_stop(nullptr), m_stop_data(nullptr), m_status(STATUS_PLAYING), m_device(device)
+	m_flags(RENDER_CONE), m_stop(nullptr), m_stop_data(nullptr), m_status(STATUS_PLAYING),
+	m_priority(0), m_virtual(false), m_virtual_position(0), m_device(device), m_render_eos(false)
 {
+	m_queued.flags = 0;
+	m_committed.flags = 0;
+}
+
+SoftwareDevice::BatchParameters& SoftwareDevice::SoftwareHandle::queueParameter(int flag)
+{
+	if(!m_queued.flags)
+		m_device->m_queuedHandles.push_back(shared_from_this());
+
+	m_queued.flags |= flag;
+
+	return m_queued;
+}
+
+bool SoftwareDevice::SoftwareHandle::getBatchedParameter(int flag, BatchParameters& parameters)
+{
+	if(m_queued.flags & flag)
+	{
+		parameters = m_queued;
+		return true;
+	}
+
+	std::lock_guard<std::mutex> lock(m_device->m_batch_mutex);
+
+	if(m_committed.flags & flag)
+	{
+		parameters = m_committed;
+		return true;
+	}
+
+	return false;
 }
 
 void SoftwareDevice::SoftwareHandle::update()
@@ -254,6 +288,128 @@ void SoftwareDevice::SoftwareHandle::update()
 		m_mapper->setMonoAngle(m_relative ? m_user_pan * M_PI / 2.0 : 0);
 }
 
+bool SoftwareDevice::SoftwareHandle::isVirtualizable()
+{
+	return m_pitch->getLength() >= 0;
+}
+
+void SoftwareDevice::SoftwareHandle::setVirtual(bool virtualize)
+{
+	if(m_virtual == virtualize)
+		return;
+
+	if(virtualize)
+		m_virtual_position = m_pitch->getPosition();
+	else
+	{
+		// the samples of the device are at the rate of the source changed by the pitch
+		m_reader->seek((int)(m_virtual_position * m_device->m_specs.rate / m_pitch->getSpecs().rate));
+		// fade in from silence
+		m_old_volume = 0;
+	}
+
+	m_virtual = virtualize;
+}
+
+bool SoftwareDevice::SoftwareHandle::skip(int length)
+{
+	m_virtual_position += double(length) * m_pitch->getSpecs().rate / m_device->m_specs.rate;
+
+	const int source_length = m_pitch->getLength();
+
+	while(m_virtual_position >= source_length)
+	{
+		if(!m_loopcount || source_length <= 0)
+		{
+			m_virtual_position = source_length;
+			return true;
+		}
+
+		if(m_loopcount > 0)
+			m_loopcount--;
+
+		m_virtual_position -= source_length;
+	}
+
+	return false;
+}
+
+void SoftwareDevice::SoftwareHandle::render(sample_t* buffer, int length)
+{
+	int pos = 0;
+	int len = length;
+	bool eos = false;
+
+	m_render_segments.clear();
+
+	try
+	{
+		m_reader->read(len, eos, buffer);
+
+		// in case of looping
+		while(pos + len < length && m_loopcount && eos)
+		{
+			m_render_segments.push_back({pos, len, m_old_volume});
+
+			m_old_volume = m_volume;
+
+			pos += len;
+
+			if(m_loopcount > 0)
+				m_loopcount--;
+
+			m_reader->seek(0);
+
+			len = length - pos;
+			m_reader->read(len, eos, buffer + pos * m_device->m_specs.channels);
+
+			// prevent endless loop
+			if(!len)
+				break;
+		}
+	}
+	catch(Exception& e)
+	{
+		len = 0;
+		std::cerr << "Caught exception while reading sound data during playback with software mixing: " << e.getMessage() << std::endl;
+	}
+
+	if(len)
+		m_render_segments.push_back({pos, len, m_old_volume});
+
+	m_render_eos = eos;
+}
+
+void SoftwareDevice::SoftwareHandle::applyCommittedParameters()
+{
+	if(m_committed.flags & BATCH_LOCATION)
+		m_location = m_committed.location;
+
+	if(m_committed.flags & BATCH_VELOCITY)
+		m_velocity = m_committed.velocity;
+
+	if(m_committed.flags & BATCH_ORIENTATION)
+		m_orientation = m_committed.orientation;
+
+	if(m_committed.flags & BATCH_VOLUME)
+	{
+		m_user_volume = m_committed.volume;
+
+		if(m_user_volume == 0)
+		{
+			m_old_volume = m_volume = m_user_volume;
+			m_flags |= RENDER_VOLUME;
+		}
+		else
+			m_flags &= ~RENDER_VOLUME;
+	}
+
+	if(m_committed.flags & BATCH_PITCH)
+		m_user_pitch = m_committed.pitch;
+
+	m_committed.flags = 0;
+}
+
 void SoftwareDevice::SoftwareHandle::setSpecs(Specs specs)
 {
 	m_mapper->setChannels(specs.channels);
@@ -373,7 +529,10 @@ bool SoftwareDevice::SoftwareHandle::seek(double position)
 		return false;
 
 	m_pitch->setPitch(m_user_pitch);
-	m_reader->seek((int)(position * m_reader->getSpecs().rate));
+	if(m_virtual)
+		m_virtual_position = position * m_pitch->getSpecs().rate;
+	else
+		m_reader->seek((int)(position * m_reader->getSpecs().rate));
 
 	if(m_status == STATUS_STOPPED)
 		m_status = STATUS_PAUSED;
@@ -391,7 +550,11 @@ double SoftwareDevice::SoftwareHandle::getPosition()
 	if(!m_status)
 		return 0.0f;
 
-	double position = m_reader->getPosition() / (double)m_device->m_specs.rate;
+	double position;
+	if(m_virtual)
+		position = m_virtual_position / m_pitch->getSpecs().rate;
+	else
+		position = m_reader->getPosition() / (double)m_device->m_specs.rate;
 
 	return position;
 }
@@ -403,6 +566,10 @@ Status SoftwareDevice::SoftwareHandle::getStatus()
 
 float SoftwareDevice::SoftwareHandle::getVolume()
 {
+	BatchParameters parameters;
+	if(m_device->m_batching && getBatchedParameter(BATCH_VOLUME, parameters))
+		return parameters.volume;
+
 	return m_user_volume;
 }
 
@@ -410,6 +577,13 @@ bool SoftwareDevice::SoftwareHandle::setVolume(float volume)
 {
 	if(!m_status)
 		return false;
+
+	if(m_device->m_batching)
+	{
+		queueParameter(BATCH_VOLUME).volume = volume;
+		return true;
+	}
+
 	m_user_volume = volume;
 
 	if(volume == 0)
@@ -425,6 +599,10 @@ bool SoftwareDevice::SoftwareHandle::setVolume(float volume)
 
 float SoftwareDevice::SoftwareHandle::getPitch()
 {
+	BatchParameters parameters;
+	if(m_device->m_batching && getBatchedParameter(BATCH_PITCH, parameters))
+		return parameters.pitch;
+
 	return m_user_pitch;
 }
 
@@ -433,7 +611,12 @@ bool SoftwareDevice::SoftwareHandle::setPitch(float pitch)
 	if(!m_status)
 		return false;
 	if(pitch > 0.0f)
-		m_user_pitch = pitch;
+	{
+		if(m_device->m_batching)
+			queueParameter(BATCH_PITCH).pitch = pitch;
+		else
+			m_user_pitch = pitch;
+	}
 	return true;
 }
 
@@ -484,6 +667,10 @@ Vector3 SoftwareDevice::SoftwareHandle::getLocation()
 	if(!m_status)
 		return Vector3();
 
+	BatchParameters parameters;
+	if(m_device->m_batching && getBatchedParameter(BATCH_LOCATION, parameters))
+		return parameters.location;
+
 	return m_location;
 }
 
@@ -492,6 +679,12 @@ bool SoftwareDevice::SoftwareHandle::setLocation(const Vector3& location)
 	if(!m_status)
 		return false;
 
+	if(m_device->m_batching)
+	{
+		queueParameter(BATCH_LOCATION).location = location;
+		return true;
+	}
+
 	m_location = location;
 
 	return true;
@@ -502,6 +695,10 @@ Vector3 SoftwareDevice::SoftwareHandle::getVelocity()
 	if(!m_status)
 		return Vector3();
 
+	BatchParameters parameters;
+	if(m_device->m_batching && getBatchedParameter(BATCH_VELOCITY, parameters))
+		return parameters.velocity;
+
 	return m_velocity;
 }
 
@@ -510,6 +707,12 @@ bool SoftwareDevice::SoftwareHandle::setVelocity(const Vector3& velocity)
 	if(!m_status)
 		return false;
 
+	if(m_device->m_batching)
+	{
+		queueParameter(BATCH_VELOCITY).velocity = velocity;
+		return true;
+	}
+
 	m_velocity = velocity;
 
 	return true;
@@ -520,6 +723,10 @@ Quaternion SoftwareDevice::SoftwareHandle::getOrientation()
 	if(!m_status)
 		return Quaternion();
 
+	BatchParameters parameters;
+	if(m_device->m_batching && getBatchedParameter(BATCH_ORIENTATION, parameters))
+		return parameters.orientation;
+
 	return m_orientation;
 }
 
@@ -528,6 +735,12 @@ bool SoftwareDevice::SoftwareHandle::setOrientation(const Quaternion& orientatio
 	if(!m_status)
 		return false;
 
+	if(m_device->m_batching)
+	{
+		queueParameter(BATCH_ORIENTATION).orientation = orientation;
+		return true;
+	}
+
 	m_orientation = orientation;
 
 	return true;
@@ -719,6 +932,13 @@ void SoftwareDevice::create()
 	m_distance_model = DISTANCE_MODEL_INVERSE_CLAMPED;
 	m_flags = 0;
 	m_quality = ResampleQuality::FASTEST;
+	m_batching = false;
+	m_max_voices = 0;
+	m_virtual_volume = -1;
+	m_real_voice_count = 0;
+	m_virtual_voice_count = 0;
+	m_mix_time = 0;
+	m_render_threads = 1;
 }
 
 void SoftwareDevice::destroy()
@@ -731,72 +951,142 @@ void SoftwareDevice::destroy()
 
 	while(!m_pausedSounds.empty())
 		m_pausedSounds.front()->stop();
+
+	m_queuedHandles.clear();
+	m_committedHandles.clear();
+
+	m_render_pool.reset();
+}
+
+void SoftwareDevice::renderVoices(int length)
+{
+	const int size = length * AUD_SAMPLE_SIZE(m_specs);
+
+	for(int index = m_render_index++; index < int(m_voices.size()); index = m_render_index++)
+	{
+		SoftwareHandle* voice = m_voices[index];
+
+		voice->m_render_buffer.assureSize(size);
+		voice->render(voice->m_render_buffer.getBuffer(), length);
+	}
 }
 
 void SoftwareDevice::mix(data_t* buffer, int length)
 {
+	const auto start = std::chrono::steady_clock::now();
+
 	m_buffer.assureSize(length * AUD_SAMPLE_SIZE(m_specs));
 
 	std::lock_guard<ILockable> lock(*this);
 
 	{
-		std::shared_ptr<SoftwareDevice::SoftwareHandle> sound;
-		int len;
-		int pos;
-		bool eos;
+		std::lock_guard<std::mutex> batch_lock(m_batch_mutex);
+
+		for(auto& handle : m_committedHandles)
+			handle->applyCommittedParameters();
+
+		m_committedHandles.clear();
+	}
+
+	{
 		std::list<std::shared_ptr<SoftwareDevice::SoftwareHandle> > stopSounds;
 		std::list<std::shared_ptr<SoftwareDevice::SoftwareHandle> > pauseSounds;
 		sample_t* buf = m_buffer.getBuffer();
 
 		m_mixer->clear(length);
 
-		// for all sounds
+		m_voices.clear();
+
 		for(auto& sound : m_playingSounds)
 		{
-			// get the buffer from the source
-			pos = 0;
-			len = length;
-			eos = false;
-
 			// update 3D Info
 			sound->update();
 
-			try
-			{
-				sound->m_reader->read(len, eos, buf);
+			// quiet voices become real again over twice the virtual volume to not switch on every mix
+			const float virtual_volume = sound->m_virtual ? m_virtual_volume * 2.0f : m_virtual_volume;
+			if(m_virtual_volume >= 0 && sound->m_volume <= virtual_volume && sound->isVirtualizable())
+				sound->setVirtual(true);
+			else
+				m_voices.push_back(sound.get());
+		}
 
-				// in case of looping
-				while(pos + len < length && sound->m_loopcount && eos)
-				{
-					m_mixer->mix(buf, pos, len, sound->m_volume, sound->m_old_volume);
+		// over the budget, the voices with the lowest priority then the quietest are virtual
+		if(m_max_voices > 0 && m_voices.size() > (size_t)m_max_voices)
+		{
+			std::nth_element(m_voices.begin(), m_voices.begin() + m_max_voices, m_voices.end(),
+							 [](const SoftwareHandle* a, const SoftwareHandle* b)
+			{
+				if(a->m_priority != b->m_priority)
+					return a->m_priority > b->m_priority;
+				return a->m_volume > b->m_volume;
+			});
 
-					sound->m_old_volume = sound->m_volume;
+			// the voices of unknown length can't be virtual and stay over the budget
+			for(auto it = m_voices.begin() + m_max_voices; it != m_voices.end(); it++)
+				(*it)->setVirtual((*it)->isVirtualizable());
 
-					pos += len;
+			m_voices.resize(m_max_voices);
+		}
 
-					if(sound->m_loopcount > 0)
-						sound->m_loopcount--;
+		for(auto& voice : m_voices)
+			voice->setVirtual(false);
 
-					sound->m_reader->seek(0);
+		int virtual_voices = 0;
 
-					len = length - pos;
-					sound->m_reader->read(len, eos, buf);
+		m_voices.clear();
 
-					// prevent endless loop
-					if(!len)
-						break;
-				}
-			}
-			catch(Exception& e)
+		for(auto& sound : m_playingSounds)
+		{
+			if(sound->m_virtual)
 			{
-				len = 0;
-				std::cerr << "Caught exception while reading sound data during playback with software mixing: " << e.getMessage() << std::endl;
+				virtual_voices++;
+				sound->m_render_eos = sound->skip(length);
 			}
+			else
+				m_voices.push_back(sound.get());
+		}
 
-			m_mixer->mix(buf, pos, len, sound->m_volume, sound->m_old_volume);
+		const int real_voices = m_voices.size();
 
+		auto mixVoice = [this](SoftwareHandle* voice, sample_t* buffer)
+		{
+			for(const RenderSegment& segment : voice->m_render_segments)
+				m_mixer->mix(buffer + segment.position * m_specs.channels, segment.position, segment.length, voice->m_volume, segment.old_volume);
+		};
+
+		if(m_render_pool && real_voices > 1)
+		{
+			// the pool threads and the mixing thread take the voices one after the other
+			m_render_index = 0;
+
+			std::vector<std::future<void> > helpers;
+			const int helper_count = std::min(m_render_threads - 1, real_voices - 1);
+
+			for(int i = 0; i < helper_count; i++)
+				helpers.push_back(m_render_pool->enqueue([this, length]() { renderVoices(length); }));
+
+			renderVoices(length);
+
+			for(auto& helper : helpers)
+				helper.get();
+
+			// the voices are mixed in the playing order to always sum the same way
+			for(auto& voice : m_voices)
+				mixVoice(voice, voice->m_render_buffer.getBuffer());
+		}
+		else
+		{
+			for(auto& voice : m_voices)
+			{
+				voice->render(buf, length);
+				mixVoice(voice, buf);
+			}
+		}
+
+		for(auto& sound : m_playingSounds)
+		{
 			// in case the end of the sound is reached
-			if(eos && !sound->m_loopcount)
+			if(sound->m_render_eos && !sound->m_loopcount)
 			{
 				if(sound->m_stop)
 					sound->m_stop(sound->m_stop_data);
@@ -820,7 +1110,12 @@ void SoftwareDevice::mix(data_t* buffer, int length)
 
 		pauseSounds.clear();
 		stopSounds.clear();
+
+		m_real_voice_count = real_voices;
+		m_virtual_voice_count = virtual_voices;
 	}
+
+	m_mix_time = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
 }
 
 void SoftwareDevice::setPanning(IHandle* handle, float pan)
@@ -834,6 +1129,122 @@ void SoftwareDevice::setQuality(ResampleQuality quality)
 	m_quality = quality;
 }
 
+bool SoftwareDevice::setPriority(IHandle* handle, int priority)
+{
+	SoftwareDevice::SoftwareHandle* h = dynamic_cast<SoftwareDevice::SoftwareHandle*>(handle);
+
+	if(!h)
+		return false;
+
+	// the mixing thread sorts the voices by priority under the device lock
+	std::lock_guard<ILockable> lock(*h->m_device);
+
+	h->m_priority = priority;
+	return true;
+}
+
+void SoftwareDevice::setVoiceBudget(int max_voices, float virtual_volume)
+{
+	std::lock_guard<ILockable> lock(*this);
+
+	m_max_voices = std::max(max_voices, 0);
+	m_virtual_volume = virtual_volume;
+}
+
+int SoftwareDevice::getMaxVoices() const
+{
+	return m_max_voices;
+}
+
+float SoftwareDevice::getVirtualVolume() const
+{
+	return m_virtual_volume;
+}
+
+int SoftwareDevice::getRealVoiceCount() const
+{
+	return m_real_voice_count;
+}
+
+int SoftwareDevice::getVirtualVoiceCount() const
+{
+	return m_virtual_voice_count;
+}
+
+float SoftwareDevice::getMixTime() const
+{
+	return m_mix_time;
+}
+
+void SoftwareDevice::setRenderThreads(int threads)
+{
+	std::lock_guard<ILockable> lock(*this);
+
+	threads = std::max(threads, 1);
+
+	if(threads == m_render_threads)
+		return;
+
+	// the mixing thread renders too, the pool only holds the other threads
+	m_render_pool.reset();
+
+	if(threads > 1)
+		m_render_pool = std::shared_ptr<ThreadPool>(new ThreadPool(threads - 1));
+
+	m_render_threads = threads;
+}
+
+int SoftwareDevice::getRenderThreads() const
+{
+	return m_render_threads;
+}
+
+void SoftwareDevice::setParameterBatching(bool batching)
+{
+	if(m_batching && !batching)
+		commitParameters();
+
+	m_batching = batching;
+}
+
+bool SoftwareDevice::isParameterBatching() const
+{
+	return m_batching;
+}
+
+void SoftwareDevice::commitParameters()
+{
+	if(m_queuedHandles.empty())
+		return;
+
+	std::lock_guard<std::mutex> lock(m_batch_mutex);
+
+	for(auto& handle : m_queuedHandles)
+	{
+		const BatchParameters& queued = handle->m_queued;
+		BatchParameters& committed = handle->m_committed;
+
+		if(!committed.flags)
+			m_committedHandles.push_back(handle);
+
+		if(queued.flags & BATCH_LOCATION)
+			committed.location = queued.location;
+		if(queued.flags & BATCH_VELOCITY)
+			committed.velocity = queued.velocity;
+		if(queued.flags & BATCH_ORIENTATION)
+			committed.orientation = queued.orientation;
+		if(queued.flags & BATCH_VOLUME)
+			committed.volume = queued.volume;
+		if(queued.flags & BATCH_PITCH)
+			committed.pitch = queued.pitch;
+
+		committed.flags |= queued.flags;
+		handle->m_queued.flags = 0;
+	}
+
+	m_queuedHandles.clear();
+}
+
 void SoftwareDevice::setSpecs(Specs specs)
 {
 	m_specs.specs = specs;
@@ -15,6 +15,7 @@
  ******************************************************************************/
 
 #include "respec/ConverterReader.h"
+#include "MixerKernels.h"
 
 AUD_NAMESPACE_BEGIN
 
@@ -29,7 +30,7 @@ ConverterReader::ConverterReader(std::shared_ptr<IReader> reader,
 		m_convert = convert_float_u8;
 		break;
 	case FORMAT_S16:
-		m_convert = convert_float_s16;
+		m_convert = getMixerKernels().convert_float_s16;
 		break;
 	case FORMAT_S24:
 #ifdef __BIG_ENDIAN__
@@ -39,7 +40,7 @@ ConverterReader::ConverterReader(std::shared_ptr<IReader> reader,
 #endif
 		break;
 	case FORMAT_S32:
-		m_convert = convert_float_s32;
+		m_convert = getMixerKernels().convert_float_s32;
 		break;
 	case FORMAT_FLOAT32:
 		m_convert = convert_copy<float>;
@@ -15,6 +15,7 @@
  ******************************************************************************/
 
 #include "respec/Mixer.h"
+#include "MixerKernels.h"
 
 #include <algorithm>
 #include <cstring>
@@ -46,7 +47,7 @@ void Mixer::setSpecs(DeviceSpecs specs)
 		m_convert = convert_float_u8;
 		break;
 	case FORMAT_S16:
-		m_convert = convert_float_s16;
+		m_convert = getMixerKernels().convert_float_s16;
 		break;
 	case FORMAT_S24:
 
@@ -57,7 +58,7 @@ void Mixer::setSpecs(DeviceSpecs specs)
 #endif
 		break;
 	case FORMAT_S32:
-		m_convert = convert_float_s32;
+		m_convert = getMixerKernels().convert_float_s32;
 		break;
 	case FORMAT_FLOAT32:
 		m_convert = convert_copy<float>;
@@ -86,8 +87,7 @@ void Mixer::mix(sample_t* buffer, int start, int length, float volume)
 	length = (std::min(m_length, length + start) - start) * m_specs.channels;
 	start *= m_specs.channels;
 
-	for(int i = 0; i < length; i++)
-		out[i + start] += buffer[i] * volume;
+	getMixerKernels().mix(out + start, buffer, length, volume);
 }
 
 void Mixer::mix(sample_t* buffer, int start, int length, float volume_to, float volume_from)
@@ -96,23 +96,27 @@ void Mixer::mix(sample_t* buffer, int start, int length, float volume_to, float
 
 	length = (std::min(m_length, length + start) - start);
 
-	for(int i = 0; i < length; i++)
-	{
-		float volume = volume_from * (1.0f - i / float(length)) + volume_to * (i / float(length));
+	if(length <= 0)
+		return;
 
-		for(int c = 0; c < m_specs.channels; c++)
-			out[(i + start) * m_specs.channels + c] += buffer[i * m_specs.channels + c] * volume;
-	}
+	float step = (volume_to - volume_from) / float(length);
+
+	getMixerKernels().mix_ramp(out + start * m_specs.channels, buffer, length, m_specs.channels, volume_from, step);
 }
 
 void Mixer::read(data_t* buffer, float volume)
 {
 	sample_t* out = m_buffer.getBuffer();
 
-	for(int i = 0; i < m_length * m_specs.channels; i++)
-		out[i] *= volume;
+	if(volume != 1.0f)
+		getMixerKernels().gain(out, m_length * m_specs.channels, volume);
 
 	m_convert(buffer, (data_t*) out, m_length * m_specs.channels);
 }
 
+const char* Mixer::getKernelName()
+{
+	return getMixerKernels().name;
+}
+
 AUD_NAMESPACE_END
@@ -0,0 +1,493 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "MixerKernels.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#include <immintrin.h>
+#define AUD_MIXER_SSE2
+// AVX2 is compiled per function and needs the target attribute of GCC and Clang.
+#if defined(__GNUC__)
+#define AUD_MIXER_AVX2
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define AUD_MIXER_NEON
+#endif
+
+#define S16_FLT 32767.0f
+#define S32_FLT 2147483647.0f
+
+AUD_NAMESPACE_BEGIN
+
+/*
+ * The float to integer conversions match the scalar functions: values at or
+ * below -1 give the minimum and values at or above 1 the maximum integer, the
+ * others are scaled and truncated.
+ */
+
+static void mix_scalar(sample_t* target, const sample_t* source, int length, float volume)
+{
+	for(int i = 0; i < length; i++)
+		target[i] += source[i] * volume;
+}
+
+static void mix_ramp_scalar(sample_t* target, const sample_t* source, int length, int channels, float volume, float step)
+{
+	for(int i = 0; i < length; i++)
+	{
+		float frame_volume = volume + step * i;
+
+		for(int c = 0; c < channels; c++)
+			target[i * channels + c] += source[i * channels + c] * frame_volume;
+	}
+}
+
+/// Mixes the samples from start on, start being the first sample of a frame.
+static inline void mix_ramp_tail(sample_t* target, const sample_t* source, int start, int length, int channels, float volume, float step)
+{
+	for(int i = start; i < length * channels; i++)
+		target[i] += source[i] * (volume + step * (i / channels));
+}
+
+static void gain_scalar(sample_t* buffer, int length, float volume)
+{
+	for(int i = 0; i < length; i++)
+		buffer[i] *= volume;
+}
+
+static const MixerKernels scalar_kernels = {
+	"scalar",
+	mix_scalar,
+	mix_ramp_scalar,
+	gain_scalar,
+	convert_float_s16,
+	convert_float_s32
+};
+
+#ifdef AUD_MIXER_SSE2
+
+static void mix_sse2(sample_t* target, const sample_t* source, int length, float volume)
+{
+	const __m128 v = _mm_set1_ps(volume);
+	int i = 0;
+
+	for(; i + 4 <= length; i += 4)
+		_mm_storeu_ps(target + i, _mm_add_ps(_mm_loadu_ps(target + i), _mm_mul_ps(_mm_loadu_ps(source + i), v)));
+
+	mix_scalar(target + i, source + i, length - i, volume);
+}
+
+static void mix_ramp_sse2(sample_t* target, const sample_t* source, int length, int channels, float volume, float step)
+{
+	const int samples = length * channels;
+	const __m128 v = _mm_set1_ps(volume);
+	const __m128 s = _mm_set1_ps(step);
+	int i = 0;
+
+	if(4 % channels == 0)
+	{
+		// a vector holds whole frames, the lanes get the index of their frame
+		const int frames = 4 / channels;
+		const __m128 increment = _mm_set1_ps(float(frames));
+		__m128 index = _mm_setr_ps(0.0f, float(1 / channels), float(2 / channels), float(3 / channels));
+
+		for(; i + 4 <= samples; i += 4)
+		{
+			const __m128 ramp = _mm_add_ps(v, _mm_mul_ps(s, index));
+			_mm_storeu_ps(target + i, _mm_add_ps(_mm_loadu_ps(target + i), _mm_mul_ps(_mm_loadu_ps(source + i), ramp)));
+			index = _mm_add_ps(index, increment);
+		}
+	}
+	else if(channels >= 4)
+	{
+		for(int frame = 0; frame < length; frame++)
+		{
+			const float frame_volume = volume + step * frame;
+			const __m128 ramp = _mm_set1_ps(frame_volume);
+			int c = 0;
+
+			for(; c + 4 <= channels; c += 4, i += 4)
+				_mm_storeu_ps(target + i, _mm_add_ps(_mm_loadu_ps(target + i), _mm_mul_ps(_mm_loadu_ps(source + i), ramp)));
+
+			for(; c < channels; c++, i++)
+				target[i] += source[i] * frame_volume;
+		}
+	}
+
+	mix_ramp_tail(target, source, i, length, channels, volume, step);
+}
+
+static void gain_sse2(sample_t* buffer, int length, float volume)
+{
+	const __m128 v = _mm_set1_ps(volume);
+	int i = 0;
+
+	for(; i + 4 <= length; i += 4)
+		_mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), v));
+
+	gain_scalar(buffer + i, length - i, volume);
+}
+
+static inline __m128i convert_s16_sse2(__m128 x)
+{
+	const __m128 min = _mm_set1_ps(-1.0f);
+	const __m128 clamped = _mm_min_ps(_mm_max_ps(x, min), _mm_set1_ps(1.0f));
+	const __m128i t = _mm_cvttps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(S16_FLT)));
+
+	// -1 scales to -32767, the all ones mask adds the missing -1
+	return _mm_add_epi32(t, _mm_castps_si128(_mm_cmple_ps(x, min)));
+}
+
+static void convert_float_s16_sse2(data_t* target, data_t* source, int length)
+{
+	int16_t* t = (int16_t*) target;
+	float* s = (float*) source;
+	int i = 0;
+
+	for(; i + 8 <= length; i += 8)
+	{
+		const __m128i low = convert_s16_sse2(_mm_loadu_ps(s + i));
+		const __m128i high = convert_s16_sse2(_mm_loadu_ps(s + i + 4));
+		_mm_storeu_si128((__m128i*)(t + i), _mm_packs_epi32(low, high));
+	}
+
+	convert_float_s16((data_t*)(t + i), (data_t*)(s + i), length - i);
+}
+
+static void convert_float_s32_sse2(data_t* target, data_t* source, int length)
+{
+	int32_t* t = (int32_t*) target;
+	float* s = (float*) source;
+	const __m128 scale = _mm_set1_ps(S32_FLT);
+	const __m128 max = _mm_set1_ps(1.0f);
+	int i = 0;
+
+	for(; i + 4 <= length; i += 4)
+	{
+		const __m128 x = _mm_loadu_ps(s + i);
+		// out of range values convert to the minimum integer, inverting it gives the maximum
+		const __m128i v = _mm_cvttps_epi32(_mm_mul_ps(x, scale));
+		_mm_storeu_si128((__m128i*)(t + i), _mm_xor_si128(v, _mm_castps_si128(_mm_cmpge_ps(x, max))));
+	}
+
+	convert_float_s32((data_t*)(t + i), (data_t*)(s + i), length - i);
+}
+
+static const MixerKernels sse2_kernels = {
+	"SSE2",
+	mix_sse2,
+	mix_ramp_sse2,
+	gain_sse2,
+	convert_float_s16_sse2,
+	convert_float_s32_sse2
+};
+
+#endif
+
+#ifdef AUD_MIXER_AVX2
+
+#define AUD_TARGET_AVX2 __attribute__((target("avx2")))
+
+AUD_TARGET_AVX2 static void mix_avx2(sample_t* target, const sample_t* source, int length, float volume)
+{
+	const __m256 v = _mm256_set1_ps(volume);
+	int i = 0;
+
+	for(; i + 8 <= length; i += 8)
+		_mm256_storeu_ps(target + i, _mm256_add_ps(_mm256_loadu_ps(target + i), _mm256_mul_ps(_mm256_loadu_ps(source + i), v)));
+
+	mix_scalar(target + i, source + i, length - i, volume);
+}
+
+AUD_TARGET_AVX2 static void mix_ramp_avx2(sample_t* target, const sample_t* source, int length, int channels, float volume, float step)
+{
+	const int samples = length * channels;
+	const __m256 v = _mm256_set1_ps(volume);
+	const __m256 s = _mm256_set1_ps(step);
+	int i = 0;
+
+	if(8 % channels == 0)
+	{
+		// a vector holds whole frames, the lanes get the index of their frame
+		const int frames = 8 / channels;
+		const __m256 increment = _mm256_set1_ps(float(frames));
+		__m256 index = _mm256_setr_ps(0.0f, float(1 / channels), float(2 / channels), float(3 / channels),
+									  float(4 / channels), float(5 / channels), float(6 / channels), float(7 / channels));
+
+		for(; i + 8 <= samples; i += 8)
+		{
+			const __m256 ramp = _mm256_add_ps(v, _mm256_mul_ps(s, index));
+			_mm256_storeu_ps(target + i, _mm256_add_ps(_mm256_loadu_ps(target + i), _mm256_mul_ps(_mm256_loadu_ps(source + i), ramp)));
+			index = _mm256_add_ps(index, increment);
+		}
+	}
+	else if(channels >= 4)
+	{
+		for(int frame = 0; frame < length; frame++)
+		{
+			const float frame_volume = volume + step * frame;
+			const __m256 ramp = _mm256_set1_ps(frame_volume);
+			int c = 0;
+
+			for(; c + 8 <= channels; c += 8, i += 8)
+				_mm256_storeu_ps(target + i, _mm256_add_ps(_mm256_loadu_ps(target + i), _mm256_mul_ps(_mm256_loadu_ps(source + i), ramp)));
+
+			for(; c + 4 <= channels; c += 4, i += 4)
+				_mm_storeu_ps(target + i, _mm_add_ps(_mm_loadu_ps(target + i), _mm_mul_ps(_mm_loadu_ps(source + i), _mm256_castps256_ps128(ramp))));
+
+			for(; c < channels; c++, i++)
+				target[i] += source[i] * frame_volume;
+		}
+	}
+
+	mix_ramp_tail(target, source, i, length, channels, volume, step);
+}
+
+AUD_TARGET_AVX2 static void gain_avx2(sample_t* buffer, int length, float volume)
+{
+	const __m256 v = _mm256_set1_ps(volume);
+	int i = 0;
+
+	for(; i + 8 <= length; i += 8)
+		_mm256_storeu_ps(buffer + i, _mm256_mul_ps(_mm256_loadu_ps(buffer + i), v));
+
+	gain_scalar(buffer + i, length - i, volume);
+}
+
+AUD_TARGET_AVX2 static inline __m256i convert_s16_avx2(__m256 x)
+{
+	const __m256 min = _mm256_set1_ps(-1.0f);
+	const __m256 clamped = _mm256_min_ps(_mm256_max_ps(x, min), _mm256_set1_ps(1.0f));
+	const __m256i t = _mm256_cvttps_epi32(_mm256_mul_ps(clamped, _mm256_set1_ps(S16_FLT)));
+
+	// -1 scales to -32767, the all ones mask adds the missing -1
+	return _mm256_add_epi32(t, _mm256_castps_si256(_mm256_cmp_ps(x, min, _CMP_LE_OQ)));
+}
+
+AUD_TARGET_AVX2 static void convert_float_s16_avx2(data_t* target, data_t* source, int length)
+{
+	int16_t* t = (int16_t*) target;
+	float* s = (float*) source;
+	int i = 0;
+
+	for(; i + 16 <= length; i += 16)
+	{
+		const __m256i low = convert_s16_avx2(_mm256_loadu_ps(s + i));
+		const __m256i high = convert_s16_avx2(_mm256_loadu_ps(s + i + 8));
+		// the packing works per 128 bit lane, reorder the 64 bit blocks afterwards
+		const __m256i packed = _mm256_packs_epi32(low, high);
+		_mm256_storeu_si256((__m256i*)(t + i), _mm256_permute4x64_epi64(packed, 0xD8));
+	}
+
+	convert_float_s16_sse2((data_t*)(t + i), (data_t*)(s + i), length - i);
+}
+
+AUD_TARGET_AVX2 static void convert_float_s32_avx2(data_t* target, data_t* source, int length)
+{
+	int32_t* t = (int32_t*) target;
+	float* s = (float*) source;
+	const __m256 scale = _mm256_set1_ps(S32_FLT);
+	const __m256 max = _mm256_set1_ps(1.0f);
+	int i = 0;
+
+	for(; i + 8 <= length; i += 8)
+	{
+		const __m256 x = _mm256_loadu_ps(s + i);
+		// out of range values convert to the minimum integer, inverting it gives the maximum
+		const __m256i v = _mm256_cvttps_epi32(_mm256_mul_ps(x, scale));
+		_mm256_storeu_si256((__m256i*)(t + i), _mm256_xor_si256(v, _mm256_castps_si256(_mm256_cmp_ps(x, max, _CMP_GE_OQ))));
+	}
+
+	convert_float_s32_sse2((data_t*)(t + i), (data_t*)(s + i), length - i);
+}
+
+static const MixerKernels avx2_kernels = {
+	"AVX2",
+	mix_avx2,
+	mix_ramp_avx2,
+	gain_avx2,
+	convert_float_s16_avx2,
+	convert_float_s32_avx2
+};
+
+#endif
+
+#ifdef AUD_MIXER_NEON
+
+static void mix_neon(sample_t* target, const sample_t* source, int length, float volume)
+{
+	const float32x4_t v = vdupq_n_f32(volume);
+	int i = 0;
+
+	for(; i + 4 <= length; i += 4)
+		vst1q_f32(target + i, vmlaq_f32(vld1q_f32(target + i), vld1q_f32(source + i), v));
+
+	mix_scalar(target + i, source + i, length - i, volume);
+}
+
+static void mix_ramp_neon(sample_t* target, const sample_t* source, int length, int channels, float volume, float step)
+{
+	const int samples = length * channels;
+	const float32x4_t v = vdupq_n_f32(volume);
+	const float32x4_t s = vdupq_n_f32(step);
+	int i = 0;
+
+	if(4 % channels == 0)
+	{
+		// a vector holds whole frames, the lanes get the index of their frame
+		const int frames = 4 / channels;
+		const float32x4_t increment = vdupq_n_f32(float(frames));
+		const float lanes[4] = {0.0f, float(1 / channels), float(2 / channels), float(3 / channels)};
+		float32x4_t index = vld1q_f32(lanes);
+
+		for(; i + 4 <= samples; i += 4)
+		{
+			const float32x4_t ramp = vmlaq_f32(v, s, index);
+			vst1q_f32(target + i, vmlaq_f32(vld1q_f32(target + i), vld1q_f32(source + i), ramp));
+			index = vaddq_f32(index, increment);
+		}
+	}
+	else if(channels >= 4)
+	{
+		for(int frame = 0; frame < length; frame++)
+		{
+			const float frame_volume = volume + step * frame;
+			const float32x4_t ramp = vdupq_n_f32(frame_volume);
+			int c = 0;
+
+			for(; c + 4 <= channels; c += 4, i += 4)
+				vst1q_f32(target + i, vmlaq_f32(vld1q_f32(target + i), vld1q_f32(source + i), ramp));
+
+			for(; c < channels; c++, i++)
+				target[i] += source[i] * frame_volume;
+		}
+	}
+
+	mix_ramp_tail(target, source, i, length, channels, volume, step);
+}
+
+static void gain_neon(sample_t* buffer, int length, float volume)
+{
+	const float32x4_t v = vdupq_n_f32(volume);
+	int i = 0;
+
+	for(; i + 4 <= length; i += 4)
+		vst1q_f32(buffer + i, vmulq_f32(vld1q_f32(buffer + i), v));
+
+	gain_scalar(buffer + i, length - i, volume);
+}
+
+static inline int16x4_t convert_s16_neon(float32x4_t x)
+{
+	const float32x4_t min = vdupq_n_f32(-1.0f);
+	const float32x4_t clamped = vminq_f32(vmaxq_f32(x, min), vdupq_n_f32(1.0f));
+	const int32x4_t t = vcvtq_s32_f32(vmulq_f32(clamped, vdupq_n_f32(S16_FLT)));
+
+	// -1 scales to -32767, the all ones mask adds the missing -1
+	return vqmovn_s32(vaddq_s32(t, vreinterpretq_s32_u32(vcleq_f32(x, min))));
+}
+
+static void convert_float_s16_neon(data_t* target, data_t* source, int length)
+{
+	int16_t* t = (int16_t*) target;
+	float* s = (float*) source;
+	int i = 0;
+
+	for(; i + 8 <= length; i += 8)
+		vst1q_s16(t + i, vcombine_s16(convert_s16_neon(vld1q_f32(s + i)), convert_s16_neon(vld1q_f32(s + i + 4))));
+
+	convert_float_s16((data_t*)(t + i), (data_t*)(s + i), length - i);
+}
+
+static void convert_float_s32_neon(data_t* target, data_t* source, int length)
+{
+	int32_t* t = (int32_t*) target;
+	float* s = (float*) source;
+	const float32x4_t scale = vdupq_n_f32(S32_FLT);
+	int i = 0;
+
+	// the conversion saturates the out of range values like the scalar clamping
+	for(; i + 4 <= length; i += 4)
+		vst1q_s32(t + i, vcvtq_s32_f32(vmulq_f32(vld1q_f32(s + i), scale)));
+
+	convert_float_s32((data_t*)(t + i), (data_t*)(s + i), length - i);
+}
+
+static const MixerKernels neon_kernels = {
+	"NEON",
+	mix_neon,
+	mix_ramp_neon,
+	gain_neon,
+	convert_float_s16_neon,
+	convert_float_s32_neon
+};
+
+#endif
+
+static const MixerKernels& selectMixerKernels()
+{
+	const char* forced = std::getenv("AUD_MIXER_KERNELS");
+
+	if(forced && std::strcmp(forced, "scalar") == 0)
+		return scalar_kernels;
+
+#ifdef AUD_MIXER_AVX2
+	if(__builtin_cpu_supports("avx2"))
+		return avx2_kernels;
+#endif
+
+#if defined(AUD_MIXER_SSE2)
+	return sse2_kernels;
+#elif defined(AUD_MIXER_NEON)
+	return neon_kernels;
+#else
+	return scalar_kernels;
+#endif
+}
+
+const MixerKernels& getMixerKernels()
+{
+	static const MixerKernels& kernels = selectMixerKernels();
+
+	return kernels;
+}
+
+std::vector<const MixerKernels*> getSupportedMixerKernels()
+{
+	std::vector<const MixerKernels*> kernels = {&scalar_kernels};
+
+#ifdef AUD_MIXER_SSE2
+	kernels.push_back(&sse2_kernels);
+#endif
+
+#ifdef AUD_MIXER_AVX2
+	if(__builtin_cpu_supports("avx2"))
+		kernels.push_back(&avx2_kernels);
+#endif
+
+#ifdef AUD_MIXER_NEON
+	kernels.push_back(&neon_kernels);
+#endif
+
+	return kernels;
+}
+
+AUD_NAMESPACE_END
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include "Audaspace.h"
+#include "respec/ConverterFunctions.h"
+
+#include <vector>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * The sample loops of the mixer, implemented for the instruction sets of the
+ * processor and selected at runtime.
+ */
+struct MixerKernels
+{
+	/// The name of the instruction set of the kernels.
+	const char* name;
+
+	/**
+	 * Adds a buffer multiplied by a constant volume.
+	 * \param target The buffer to add to.
+	 * \param source The buffer to add.
+	 * \param length The amount of samples.
+	 * \param volume The volume.
+	 */
+	void (*mix)(sample_t* target, const sample_t* source, int length, float volume);
+
+	/**
+	 * Adds a buffer multiplied by a linear volume ramp.
+	 * \param target The buffer to add to.
+	 * \param source The buffer to add.
+	 * \param length The amount of sample frames.
+	 * \param channels The amount of channels of a sample frame.
+	 * \param volume The volume of the first sample frame.
+	 * \param step The volume increment per sample frame.
+	 */
+	void (*mix_ramp)(sample_t* target, const sample_t* source, int length, int channels, float volume, float step);
+
+	/**
+	 * Multiplies a buffer by a volume.
+	 * \param buffer The buffer.
+	 * \param length The amount of samples.
+	 * \param volume The volume.
+	 */
+	void (*gain)(sample_t* buffer, int length, float volume);
+
+	/// Converts from FORMAT_FLOAT32 to FORMAT_S16, same as convert_float_s16.
+	convert_f convert_float_s16;
+
+	/// Converts from FORMAT_FLOAT32 to FORMAT_S32, same as convert_float_s32.
+	convert_f convert_float_s32;
+};
+
+/**
+ * Returns the fastest kernels supported by the processor, selected at the
+ * first call. Setting the environment variable AUD_MIXER_KERNELS to "scalar"
+ * forces the scalar kernels.
+ * \return The mixer kernels.
+ */
+const MixerKernels& getMixerKernels();
+
+/**
+ * Returns all the kernels supported by the processor, to compare them.
+ * \return The supported mixer kernels, the scalar kernels first.
+ */
+std::vector<const MixerKernels*> getSupportedMixerKernels();
+
+AUD_NAMESPACE_END
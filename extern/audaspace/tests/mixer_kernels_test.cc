@@ -0,0 +1,215 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "testing/testing.h"
+
+#include "respec/MixerKernels.h"
+#include "respec/Specification.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using namespace aud;
+
+/*
+ * Every kernel supported by the processor is compared with the scalar one.
+ * The lengths cover the vector bodies and the scalar tails of all the vector
+ * widths. The mixing may differ by the rounding of a fused multiply-add in
+ * the scalar code, the conversions must be exact.
+ */
+
+static const int MAX_LENGTH = 41;
+static const float MIX_TOLERANCE = 1e-6f;
+
+/// Values on and around the clamping limits of the conversions.
+static const float edge_values[] = {
+	-1e10f, -2.0f, -1.0f, std::nextafter(-1.0f, 0.0f), -0.5f, -1e-10f, 0.0f, 1e-10f, 0.5f,
+	std::nextafter(1.0f, 0.0f), 1.0f, std::nextafter(1.0f, 2.0f), 2.0f, 1e10f
+};
+
+static std::vector<sample_t> random_samples(int length, unsigned int seed, float range)
+{
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<float> distribution(-range, range);
+
+	std::vector<sample_t> samples(length);
+	for(sample_t& sample : samples)
+		sample = distribution(generator);
+
+	return samples;
+}
+
+/// Random samples starting with all the edge values.
+static std::vector<sample_t> conversion_samples(unsigned int seed)
+{
+	std::vector<sample_t> samples = random_samples(MAX_LENGTH * 4, seed, 1.5f);
+	std::copy(std::begin(edge_values), std::end(edge_values), samples.begin());
+
+	return samples;
+}
+
+static void expect_samples_near(const std::vector<sample_t>& result, const std::vector<sample_t>& expected, const MixerKernels* kernels)
+{
+	for(size_t i = 0; i < expected.size(); i++)
+		EXPECT_NEAR(result[i], expected[i], MIX_TOLERANCE * std::max(1.0f, std::fabs(expected[i]))) << kernels->name << ", sample " << i;
+}
+
+TEST(audaspace_mixer_kernels, mix)
+{
+	const std::vector<const MixerKernels*> all_kernels = getSupportedMixerKernels();
+	const MixerKernels* scalar = all_kernels.front();
+
+	for(int length = 0; length <= MAX_LENGTH; length++)
+	{
+		const std::vector<sample_t> source = random_samples(length, length, 1.0f);
+		const std::vector<sample_t> target = random_samples(length, length + 1000, 1.0f);
+
+		std::vector<sample_t> expected = target;
+		scalar->mix(expected.data(), source.data(), length, 0.7f);
+
+		for(const MixerKernels* kernels : all_kernels)
+		{
+			std::vector<sample_t> result = target;
+			kernels->mix(result.data(), source.data(), length, 0.7f);
+			expect_samples_near(result, expected, kernels);
+		}
+	}
+}
+
+TEST(audaspace_mixer_kernels, mix_ramp)
+{
+	const std::vector<const MixerKernels*> all_kernels = getSupportedMixerKernels();
+	const MixerKernels* scalar = all_kernels.front();
+
+	for(int channels = 1; channels <= CHANNELS_SURROUND71; channels++)
+	{
+		for(int length = 0; length <= MAX_LENGTH; length++)
+		{
+			const int samples = length * channels;
+			const std::vector<sample_t> source = random_samples(samples, samples, 1.0f);
+			const std::vector<sample_t> target = random_samples(samples, samples + 1000, 1.0f);
+			const float step = length ? -0.9f / length : 0.0f;
+
+			std::vector<sample_t> expected = target;
+			scalar->mix_ramp(expected.data(), source.data(), length, channels, 1.0f, step);
+
+			for(const MixerKernels* kernels : all_kernels)
+			{
+				std::vector<sample_t> result = target;
+				kernels->mix_ramp(result.data(), source.data(), length, channels, 1.0f, step);
+				expect_samples_near(result, expected, kernels);
+			}
+		}
+	}
+}
+
+TEST(audaspace_mixer_kernels, gain)
+{
+	const std::vector<const MixerKernels*> all_kernels = getSupportedMixerKernels();
+	const MixerKernels* scalar = all_kernels.front();
+
+	for(int length = 0; length <= MAX_LENGTH; length++)
+	{
+		const std::vector<sample_t> buffer = random_samples(length, length, 2.0f);
+
+		std::vector<sample_t> expected = buffer;
+		scalar->gain(expected.data(), length, 0.3f);
+
+		for(const MixerKernels* kernels : all_kernels)
+		{
+			std::vector<sample_t> result = buffer;
+			kernels->gain(result.data(), length, 0.3f);
+			expect_samples_near(result, expected, kernels);
+		}
+	}
+}
+
+template <class T>
+static void test_conversion(convert_f MixerKernels::*conversion)
+{
+	const std::vector<const MixerKernels*> all_kernels = getSupportedMixerKernels();
+	const MixerKernels* scalar = all_kernels.front();
+
+	std::vector<sample_t> source = conversion_samples(0);
+
+	// every length, and every start offset of the edge values in the vectors
+	for(int offset = 0; offset < 8; offset++)
+	{
+		for(int length = 0; length <= MAX_LENGTH; length++)
+		{
+			sample_t* samples = source.data() + offset;
+
+			std::vector<T> expected(length);
+			(scalar->*conversion)((data_t*) expected.data(), (data_t*) samples, length);
+
+			for(const MixerKernels* kernels : all_kernels)
+			{
+				std::vector<T> result(length);
+				(kernels->*conversion)((data_t*) result.data(), (data_t*) samples, length);
+
+				for(int i = 0; i < length; i++)
+					EXPECT_EQ(result[i], expected[i]) << kernels->name << ", value " << samples[i];
+			}
+		}
+	}
+}
+
+TEST(audaspace_mixer_kernels, convert_float_s16)
+{
+	test_conversion<int16_t>(&MixerKernels::convert_float_s16);
+}
+
+TEST(audaspace_mixer_kernels, convert_float_s32)
+{
+	test_conversion<int32_t>(&MixerKernels::convert_float_s32);
+}
+
+TEST(audaspace_mixer_kernels, convert_edge_values)
+{
+	// the limits of the scalar conversions, which the other kernels are compared to
+	const int count = sizeof(edge_values) / sizeof(*edge_values);
+	std::vector<sample_t> source(std::begin(edge_values), std::end(edge_values));
+	std::vector<int16_t> s16(count);
+	std::vector<int32_t> s32(count);
+
+	for(const MixerKernels* kernels : getSupportedMixerKernels())
+	{
+		kernels->convert_float_s16((data_t*) s16.data(), (data_t*) source.data(), count);
+		kernels->convert_float_s32((data_t*) s32.data(), (data_t*) source.data(), count);
+
+		for(int i = 0; i < count; i++)
+		{
+			if(source[i] <= -1.0f)
+			{
+				EXPECT_EQ(s16[i], INT16_MIN) << kernels->name << ", value " << source[i];
+				EXPECT_EQ(s32[i], INT32_MIN) << kernels->name << ", value " << source[i];
+			}
+			else if(source[i] >= 1.0f)
+			{
+				EXPECT_EQ(s16[i], INT16_MAX) << kernels->name << ", value " << source[i];
+				EXPECT_EQ(s32[i], INT32_MAX) << kernels->name << ", value " << source[i];
+			}
+			else
+			{
+				EXPECT_EQ(s16[i], int16_t(source[i] * 32767.0f)) << kernels->name << ", value " << source[i];
+			}
+		}
+	}
+}
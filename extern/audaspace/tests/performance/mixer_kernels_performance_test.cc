@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "testing/testing.h"
+
+#include "respec/MixerKernels.h"
+#include "respec/Specification.h"
+
+#include "BLI_timeit.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace aud;
+
+/*
+ * Mixing of the voices of a device buffer with each kernel supported by the
+ * processor, as done by the mixer: half of the voices ramp their volume like
+ * voices changing volume or fading, the sum is scaled by the master volume
+ * and converted to the device format.
+ */
+
+static const int VOICES = 64;
+static const int LENGTH = 1024;
+static const int ITERATIONS = 2000;
+
+static void mix_voices(int channels)
+{
+	std::mt19937 generator(0);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+	std::vector<sample_t> source(LENGTH * channels * VOICES);
+	for(sample_t& sample : source)
+		sample = distribution(generator);
+
+	std::vector<sample_t> buffer(LENGTH * channels);
+	std::vector<int16_t> output(LENGTH * channels);
+
+	for(const MixerKernels* kernels : getSupportedMixerKernels())
+	{
+		SCOPED_TIMER(std::string(kernels->name) + ", " + std::to_string(channels) + " channels");
+
+		for(int i = 0; i < ITERATIONS; i++)
+		{
+			std::fill(buffer.begin(), buffer.end(), 0.0f);
+
+			for(int voice = 0; voice < VOICES; voice++)
+			{
+				const sample_t* voice_source = source.data() + voice * LENGTH * channels;
+
+				if(voice & 1)
+					kernels->mix_ramp(buffer.data(), voice_source, LENGTH, channels, 0.5f, -0.25f / LENGTH);
+				else
+					kernels->mix(buffer.data(), voice_source, LENGTH * channels, 0.25f);
+			}
+
+			kernels->gain(buffer.data(), LENGTH * channels, 0.8f);
+			kernels->convert_float_s16((data_t*) output.data(), (data_t*) buffer.data(), LENGTH * channels);
+		}
+	}
+}
+
+TEST(audaspace_mixer_kernels, mix_mono)
+{
+	mix_voices(CHANNELS_MONO);
+}
+
+TEST(audaspace_mixer_kernels, mix_stereo)
+{
+	mix_voices(CHANNELS_STEREO);
+}
+
+TEST(audaspace_mixer_kernels, mix_surround51)
+{
+	mix_voices(CHANNELS_SURROUND51);
+}
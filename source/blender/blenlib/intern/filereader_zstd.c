@@ -11,9 +11,63 @@
 
 #include "BLI_filereader.h"
 #include "BLI_math_base.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "MEM_guardedalloc.h"
 
+/** Maximum number of frames decompressed ahead of the read position. */
+#define ZSTD_READAHEAD_FRAMES_MAX 16
+
+typedef enum eZstdFrameState {
+  ZSTD_FRAME_EMPTY,
+  /** The compressed data is read, the decompression is waiting for a thread. */
+  ZSTD_FRAME_QUEUED,
+  ZSTD_FRAME_RUNNING,
+  ZSTD_FRAME_DONE,
+} eZstdFrameState;
+
+/** A frame of the read-ahead window. */
+typedef struct ZstdReadaheadSlot {
+  /** Frame read or queued, -1 for none, only accessed by the reading thread. */
+  int frame;
+  /** Protected by the mutex of the read-ahead, the buffers are only accessed by the thread which
+   * changed the state from #ZSTD_FRAME_QUEUED to #ZSTD_FRAME_RUNNING. */
+  eZstdFrameState state;
+  /** The frame was read and decompressed successfully. */
+  bool ok;
+
+  ZSTD_DCtx *ctx;
+  char *compressed_data;
+  size_t compressed_size;
+  size_t compressed_capacity;
+  char *content;
+  size_t content_size;
+  size_t content_capacity;
+} ZstdReadaheadSlot;
+
+/**
+ * Decompression of the frames following the read position on worker threads.
+ * Frame `i` is kept in slot `i % slots_num`, the reading thread reads the compressed data and
+ * replaces the frames before the read position by the following ones. The frames are only read
+ * ahead when the reading enters the frame following the previous one, random accesses (e.g. the
+ * lazy reads of a linked library) only read and decompress the frame they need.
+ */
+typedef struct ZstdReadahead {
+  ZstdReadaheadSlot *slots;
+  int slots_num;
+
+  /** Frame decompressed in its slot and its content, -1 for none, read without locking. */
+  int current_frame;
+  const char *current_content;
+  /** Frame of the previous access, to detect the sequential reading. */
+  int last_frame;
+
+  TaskPool *pool;
+  ThreadMutex mutex;
+  ThreadCondition cond;
+} ZstdReadahead;
+
 typedef struct {
   FileReader reader;
 
@@ -30,6 +84,9 @@ typedef struct {
 
     char *cached_content;
     int cached_frame;
+
+    /** Only set when the frames are decompressed ahead, replaces the cached frame. */
+    ZstdReadahead *readahead;
   } seek;
 } ZstdReader;
 
@@ -153,9 +210,200 @@ static int zstd_frame_from_pos(ZstdReader *zstd, size_t pos)
   return low;
 }
 
+static bool zstd_read_compressed_frame(ZstdReader *zstd, int frame, char *compressed_data)
+{
+  size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
+
+  return (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) >= 0 &&
+          zstd->base->read(zstd->base, compressed_data, compressed_size) ==
+              (int64_t)compressed_size);
+}
+
+static void zstd_readahead_decompress(ZstdReadaheadSlot *slot)
+{
+  size_t res = ZSTD_decompressDCtx(slot->ctx,
+                                   slot->content,
+                                   slot->content_size,
+                                   slot->compressed_data,
+                                   slot->compressed_size);
+  slot->ok = !ZSTD_isError(res) && res >= slot->content_size;
+}
+
+static void zstd_readahead_task(TaskPool *__restrict pool, void *taskdata)
+{
+  ZstdReadahead *readahead = BLI_task_pool_user_data(pool);
+  ZstdReadaheadSlot *slot = taskdata;
+
+  /* The frame may have been taken by the reading thread or replaced since the task was pushed. */
+  BLI_mutex_lock(&readahead->mutex);
+  const bool queued = (slot->state == ZSTD_FRAME_QUEUED);
+  if (queued) {
+    slot->state = ZSTD_FRAME_RUNNING;
+  }
+  BLI_mutex_unlock(&readahead->mutex);
+
+  if (!queued) {
+    return;
+  }
+
+  zstd_readahead_decompress(slot);
+
+  BLI_mutex_lock(&readahead->mutex);
+  slot->state = ZSTD_FRAME_DONE;
+  BLI_condition_notify_all(&readahead->cond);
+  BLI_mutex_unlock(&readahead->mutex);
+}
+
+/**
+ * Wait for the decompression of a slot running on a worker thread. A frame still waiting for a
+ * thread is decompressed on the calling thread if \a decompress is set, otherwise dropped, so that
+ * the reading never waits for a task not started.
+ */
+static void zstd_readahead_finish(ZstdReadahead *readahead,
+                                  ZstdReadaheadSlot *slot,
+                                  bool decompress)
+{
+  BLI_mutex_lock(&readahead->mutex);
+  while (slot->state == ZSTD_FRAME_RUNNING) {
+    BLI_condition_wait(&readahead->cond, &readahead->mutex);
+  }
+  const bool queued = (slot->state == ZSTD_FRAME_QUEUED);
+  if (queued) {
+    slot->state = decompress ? ZSTD_FRAME_RUNNING : ZSTD_FRAME_EMPTY;
+  }
+  BLI_mutex_unlock(&readahead->mutex);
+
+  if (!decompress) {
+    slot->frame = -1;
+  }
+  else if (queued) {
+    zstd_readahead_decompress(slot);
+
+    BLI_mutex_lock(&readahead->mutex);
+    slot->state = ZSTD_FRAME_DONE;
+    BLI_mutex_unlock(&readahead->mutex);
+  }
+}
+
+/** Read the compressed data of a frame into a finished slot and queue its decompression. */
+static void zstd_readahead_queue(ZstdReader *zstd, ZstdReadaheadSlot *slot, int frame, bool push)
+{
+  ZstdReadahead *readahead = zstd->seek.readahead;
+
+  slot->frame = frame;
+  slot->compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
+  slot->content_size = zstd->seek.uncompressed_ofs[frame + 1] - zstd->seek.uncompressed_ofs[frame];
+
+  if (slot->compressed_capacity < slot->compressed_size) {
+    MEM_SAFE_FREE(slot->compressed_data);
+    slot->compressed_data = MEM_mallocN(slot->compressed_size, __func__);
+    slot->compressed_capacity = slot->compressed_size;
+  }
+  if (slot->content_capacity < slot->content_size) {
+    MEM_SAFE_FREE(slot->content);
+    slot->content = MEM_mallocN(slot->content_size, __func__);
+    slot->content_capacity = slot->content_size;
+  }
+
+  /* A task pushed for a previous frame of the slot may take the frame as soon as it's queued. */
+  const bool ok = zstd_read_compressed_frame(zstd, frame, slot->compressed_data);
+  slot->ok = ok;
+
+  BLI_mutex_lock(&readahead->mutex);
+  slot->state = ok ? ZSTD_FRAME_QUEUED : ZSTD_FRAME_DONE;
+  BLI_mutex_unlock(&readahead->mutex);
+
+  if (ok && push) {
+    BLI_task_pool_push(readahead->pool, zstd_readahead_task, slot, false, NULL);
+  }
+}
+
+static const char *zstd_readahead_ensure(ZstdReader *zstd, int frame)
+{
+  ZstdReadahead *readahead = zstd->seek.readahead;
+
+  /* The frame of the previous reads, its slot is only replaced when entering another frame. */
+  if (frame == readahead->current_frame) {
+    return readahead->current_content;
+  }
+
+  ZstdReadaheadSlot *slot = &readahead->slots[frame % readahead->slots_num];
+
+  if (slot->frame != frame) {
+    /* Not read ahead, after a seek or at the first read. */
+    zstd_readahead_finish(readahead, slot, false);
+    zstd_readahead_queue(zstd, slot, frame, false);
+  }
+  zstd_readahead_finish(readahead, slot, true);
+
+  readahead->current_frame = slot->ok ? frame : -1;
+  readahead->current_content = slot->ok ? slot->content : NULL;
+
+  const bool sequential = (frame == readahead->last_frame + 1);
+  readahead->last_frame = frame;
+  if (!sequential) {
+    return readahead->current_content;
+  }
+
+  /* Queue the following frames in the slots of the frames before. */
+  for (int i = 1; i < readahead->slots_num && frame + i < zstd->seek.frames_num; i++) {
+    ZstdReadaheadSlot *next = &readahead->slots[(frame + i) % readahead->slots_num];
+    if (next->frame == frame + i) {
+      continue;
+    }
+    zstd_readahead_finish(readahead, next, false);
+    zstd_readahead_queue(zstd, next, frame + i, true);
+  }
+
+  return readahead->current_content;
+}
+
+static void zstd_readahead_init(ZstdReader *zstd, int slots_num)
+{
+  ZstdReadahead *readahead = MEM_callocN(sizeof(ZstdReadahead), __func__);
+
+  readahead->slots = MEM_calloc_arrayN(slots_num, sizeof(ZstdReadaheadSlot), __func__);
+  readahead->slots_num = slots_num;
+  readahead->current_frame = -1;
+  readahead->last_frame = -1;
+  for (int i = 0; i < slots_num; i++) {
+    readahead->slots[i].frame = -1;
+    readahead->slots[i].ctx = ZSTD_createDCtx();
+  }
+
+  readahead->pool = BLI_task_pool_create(readahead, TASK_PRIORITY_LOW);
+  BLI_mutex_init(&readahead->mutex);
+  BLI_condition_init(&readahead->cond);
+
+  zstd->seek.readahead = readahead;
+}
+
+static void zstd_readahead_free(ZstdReadahead *readahead)
+{
+  /* Drop the queued frames and wait for the running ones. */
+  BLI_task_pool_cancel(readahead->pool);
+  BLI_task_pool_free(readahead->pool);
+
+  for (int i = 0; i < readahead->slots_num; i++) {
+    ZstdReadaheadSlot *slot = &readahead->slots[i];
+    ZSTD_freeDCtx(slot->ctx);
+    MEM_SAFE_FREE(slot->compressed_data);
+    MEM_SAFE_FREE(slot->content);
+  }
+  MEM_freeN(readahead->slots);
+
+  BLI_mutex_end(&readahead->mutex);
+  BLI_condition_end(&readahead->cond);
+  MEM_freeN(readahead);
+}
+
 /* Ensure that the currently loaded frame is the correct one. */
 static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
 {
+  if (zstd->seek.readahead) {
+    return zstd_readahead_ensure(zstd, frame);
+  }
+
   if (zstd->seek.cached_frame == frame) {
     /* Cached frame matches, so just return it. */
     return zstd->seek.cached_content;
@@ -170,9 +418,7 @@ static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
 
   char *uncompressed_data = MEM_mallocN(uncompressed_size, __func__);
   char *compressed_data = MEM_mallocN(compressed_size, __func__);
-  if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
-      zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size)
-  {
+  if (!zstd_read_compressed_frame(zstd, frame, compressed_data)) {
     MEM_freeN(compressed_data);
     MEM_freeN(uncompressed_data);
     return NULL;
@@ -285,6 +531,9 @@ static void zstd_close(FileReader *reader)
     if (zstd->seek.cached_content) {
       MEM_freeN(zstd->seek.cached_content);
     }
+    if (zstd->seek.readahead) {
+      zstd_readahead_free(zstd->seek.readahead);
+    }
   }
   else {
     MEM_freeN((void *)zstd->in_buf.src);
@@ -323,3 +572,17 @@ FileReader *BLI_filereader_new_zstd(FileReader *base)
 
   return (FileReader *)zstd;
 }
+
+FileReader *BLI_filereader_new_zstd_readahead(FileReader *base)
+{
+  ZstdReader *zstd = (ZstdReader *)BLI_filereader_new_zstd(base);
+
+  /* Two frames per thread keep the workers busy, the window is bounded to limit its memory. */
+  const int threads_num = BLI_system_thread_count();
+  if (zstd->reader.seek && threads_num > 1 && zstd->seek.frames_num > 1) {
+    zstd_readahead_init(
+        zstd, min_ii(min_ii(threads_num * 2, ZSTD_READAHEAD_FRAMES_MAX), zstd->seek.frames_num));
+  }
+
+  return (FileReader *)zstd;
+}
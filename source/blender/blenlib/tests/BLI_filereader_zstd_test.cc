@@ -0,0 +1,190 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <zstd.h>
+
+#include "testing/testing.h"
+
+#include "BLI_filereader.h"
+#include "BLI_fileops.hh"
+#include "BLI_path_util.h"
+#include "BLI_rand.hh"
+#include "BLI_system.h"
+#include "BLI_tempfile.h"
+#include "BLI_threads.h"
+#include "BLI_vector.hh"
+
+#include BLI_SYSTEM_PID_H
+
+namespace blender::tests {
+
+/* Frames of different sizes, more than the read-ahead window holds. */
+static constexpr int FRAMES_NUM = 40;
+
+/**
+ * Compare the reads of a seekable multi-frame file by the read-ahead reader with the reads by the
+ * plain `Zstd` reader, which decompresses the frames one at a time on demand.
+ */
+class FileReaderZstdTest : public testing::Test {
+ public:
+  std::string temp_dir;
+  std::string filepath;
+  Vector<char> content;
+
+  FileReader *reader_plain = nullptr;
+  FileReader *reader_readahead = nullptr;
+
+  void SetUp() override
+  {
+    BLI_threadapi_init();
+    /* The frames are only read ahead with several threads. */
+    BLI_system_num_threads_override_set(4);
+
+    char temp_dir_c[FILE_MAX];
+    BLI_temp_directory_path_get(temp_dir_c, sizeof(temp_dir_c));
+    temp_dir = std::string(temp_dir_c) + SEP_STR + "blender_filereader_zstd_test_" +
+               std::to_string(getpid());
+    BLI_dir_create_recursive(temp_dir.c_str());
+    filepath = temp_dir + SEP_STR + "frames.zst";
+
+    write_seekable_file();
+
+    reader_plain = BLI_filereader_new_zstd(
+        BLI_filereader_new_file(BLI_open(filepath.c_str(), O_BINARY | O_RDONLY, 0)));
+    reader_readahead = BLI_filereader_new_zstd_readahead(
+        BLI_filereader_new_file(BLI_open(filepath.c_str(), O_BINARY | O_RDONLY, 0)));
+    ASSERT_NE(reader_plain->seek, nullptr);
+    ASSERT_NE(reader_readahead->seek, nullptr);
+  }
+
+  void TearDown() override
+  {
+    reader_plain->close(reader_plain);
+    reader_readahead->close(reader_readahead);
+    BLI_delete(temp_dir.c_str(), true, true);
+    BLI_system_num_threads_override_set(0);
+  }
+
+  /** Write the frames followed by the seek table, as #BLO_write_file does. */
+  void write_seekable_file()
+  {
+    RandomNumberGenerator rng(0);
+    Vector<uint32_t> seek_table;
+
+    FILE *file = BLI_fopen(filepath.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+
+    for (int frame = 0; frame < FRAMES_NUM; frame++) {
+      Vector<char> frame_content(1000 + rng.get_int32(4000));
+      for (char &c : frame_content) {
+        /* Compressible but not uniform data. */
+        c = char(rng.get_int32(16));
+      }
+
+      Vector<char> compressed(ZSTD_compressBound(frame_content.size()));
+      const size_t compressed_size = ZSTD_compress(
+          compressed.data(), compressed.size(), frame_content.data(), frame_content.size(), 3);
+      ASSERT_FALSE(ZSTD_isError(compressed_size));
+      fwrite(compressed.data(), 1, compressed_size, file);
+
+      seek_table.append(uint32_t(compressed_size));
+      seek_table.append(uint32_t(frame_content.size()));
+      content.extend(frame_content);
+    }
+
+    /* The seek table is a skippable frame, stored in little endian as the test machines. */
+    const uint32_t header[2] = {0x184D2A5E, uint32_t(seek_table.size() * 4 + 9)};
+    const uint32_t frames_num = FRAMES_NUM;
+    const char flags = 0;
+    const uint32_t magic = 0x8F92EAB1;
+    fwrite(header, sizeof(header), 1, file);
+    fwrite(seek_table.data(), sizeof(uint32_t), seek_table.size(), file);
+    fwrite(&frames_num, sizeof(frames_num), 1, file);
+    fwrite(&flags, 1, 1, file);
+    fwrite(&magic, sizeof(magic), 1, file);
+
+    ASSERT_EQ(fclose(file), 0);
+  }
+
+  /** Seek both readers and check they agree on the new position. */
+  void seek(off64_t offset, int whence)
+  {
+    const off64_t pos_plain = reader_plain->seek(reader_plain, offset, whence);
+    const off64_t pos_readahead = reader_readahead->seek(reader_readahead, offset, whence);
+    EXPECT_EQ(pos_plain, pos_readahead);
+  }
+
+  /** Read with both readers and check they return the same bytes as the file content. */
+  void read(size_t size)
+  {
+    const off64_t offset = reader_plain->offset;
+    EXPECT_EQ(reader_readahead->offset, offset);
+
+    Vector<char> buffer_plain(size), buffer_readahead(size);
+    const int64_t read_plain = reader_plain->read(reader_plain, buffer_plain.data(), size);
+    const int64_t read_readahead = reader_readahead->read(
+        reader_readahead, buffer_readahead.data(), size);
+
+    const int64_t expected = std::min<int64_t>(size, content.size() - offset);
+    EXPECT_EQ(read_plain, expected);
+    ASSERT_EQ(read_readahead, expected);
+    EXPECT_EQ(reader_readahead->offset, reader_plain->offset);
+    EXPECT_EQ(memcmp(buffer_readahead.data(), buffer_plain.data(), expected), 0);
+    EXPECT_EQ(memcmp(buffer_readahead.data(), content.data() + offset, expected), 0);
+  }
+};
+
+TEST_F(FileReaderZstdTest, ReadSequential)
+{
+  /* Reads smaller and larger than the frames, crossing their boundaries. */
+  while (reader_plain->offset < off64_t(content.size())) {
+    read(777);
+  }
+  read(100);
+
+  seek(0, SEEK_SET);
+  read(content.size());
+}
+
+TEST_F(FileReaderZstdTest, ReadSeekForward)
+{
+  for (off64_t offset = 0; offset < off64_t(content.size()); offset += 5000) {
+    seek(offset, SEEK_SET);
+    read(300);
+  }
+
+  /* Skipping a few frames after a sequential read. */
+  seek(0, SEEK_SET);
+  read(10000);
+  seek(20000, SEEK_CUR);
+  read(10000);
+}
+
+TEST_F(FileReaderZstdTest, ReadSeekBackward)
+{
+  for (off64_t offset = content.size() - 1000; offset >= 0; offset -= 3000) {
+    seek(offset, SEEK_SET);
+    read(2000);
+  }
+
+  /* Back into the frame before, then sequential again. */
+  seek(-4000, SEEK_END);
+  read(1000);
+  seek(-3000, SEEK_CUR);
+  read(content.size());
+}
+
+TEST_F(FileReaderZstdTest, ReadSeekRandom)
+{
+  RandomNumberGenerator rng(1);
+  for (int i = 0; i < 500; i++) {
+    seek(rng.get_int32(content.size()), SEEK_SET);
+    read(rng.get_int32(12000));
+  }
+}
+
+}  // namespace blender::tests
@@ -249,6 +249,20 @@ void BLO_datablock_info_linklist_free(LinkNode * /*BLODataBlockInfo*/ datablock_
  * \return A handle on success, or NULL on failure.
  */
 BlendHandle *BLO_blendhandle_from_file(const char *filepath, BlendFileReadReport *reports);
+/**
+ * Open a blendhandle from a file path for linking only some of its data-blocks.
+ *
+ * The headers of the blocks of the file are cached in an index next to it (`<filepath>.bidx`),
+ * so that following openings don't read the whole file: only the data of the linked data-blocks
+ * and their dependencies is read, on demand. The index is written when missing or out of date,
+ * if the directory is writable.
+ *
+ * \param filepath: The file path to open.
+ * \param reports: Report errors in opening the file.
+ * \return A handle on success, or NULL on failure.
+ */
+BlendHandle *BLO_blendhandle_from_file_indexed(const char *filepath,
+                                               BlendFileReadReport *reports);
 /**
  * Open a blendhandle from memory.
  *
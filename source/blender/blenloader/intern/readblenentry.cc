@@ -75,6 +75,16 @@ BlendHandle *BLO_blendhandle_from_file(const char *filepath, BlendFileReadReport
   return bh;
 }
 
+BlendHandle *BLO_blendhandle_from_file_indexed(const char *filepath,
+                                               BlendFileReadReport *reports)
+{
+  BlendHandle *bh;
+
+  bh = (BlendHandle *)blo_filedata_from_file_indexed(filepath, reports);
+
+  return bh;
+}
+
 BlendHandle *BLO_blendhandle_from_memory(const void *mem,
                                          int memsize,
                                          BlendFileReadReport *reports)
@@ -6,6 +6,7 @@
  * \ingroup blenloader
  */
 
+#include <atomic>
 #include <cctype> /* for isdigit. */
 #include <cerrno>
 #include <climits>
@@ -55,8 +56,10 @@
 #include "BLI_map.hh"
 #include "BLI_memarena.h"
 #include "BLI_mempool.h"
+#include "BLI_system.h"
 #include "BLI_threads.h"
 #include "BLI_time.h"
+#include BLI_SYSTEM_PID_H
 
 #include "BLT_translation.hh"
 
@@ -1162,9 +1165,14 @@ static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
   return fd;
 }
 
+/**
+ * \param readahead: Decompress the following parts of compressed files on worker threads, for
+ * reading whole files.
+ */
 static FileData *blo_filedata_from_file_descriptor(const char *filepath,
                                                    BlendFileReadReport *reports,
-                                                   int filedes)
+                                                   int filedes,
+                                                   const bool readahead)
 {
   char header[7];
   FileReader *rawfile = BLI_filereader_new_file(filedes);
@@ -1212,7 +1220,8 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
     }
   }
   else if (BLI_file_magic_is_zstd(header)) {
-    file = BLI_filereader_new_zstd(rawfile);
+    file = readahead ? BLI_filereader_new_zstd_readahead(rawfile) :
+                       BLI_filereader_new_zstd(rawfile);
     if (file != nullptr) {
       rawfile = nullptr; /* The `Zstd` #FileReader takes ownership of `rawfile`. */
     }
@@ -1243,7 +1252,9 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
   return fd;
 }
 
-static FileData *blo_filedata_from_file_open(const char *filepath, BlendFileReadReport *reports)
+static FileData *blo_filedata_from_file_open(const char *filepath,
+                                             BlendFileReadReport *reports,
+                                             const bool readahead)
 {
   errno = 0;
   const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
@@ -1255,12 +1266,12 @@ static FileData *blo_filedata_from_file_open(const char *filepath, BlendFileRead
                 errno ? strerror(errno) : RPT_("unknown error reading file"));
     return nullptr;
   }
-  return blo_filedata_from_file_descriptor(filepath, reports, file);
+  return blo_filedata_from_file_descriptor(filepath, reports, file, readahead);
 }
 
 FileData *blo_filedata_from_file(const char *filepath, BlendFileReadReport *reports)
 {
-  FileData *fd = blo_filedata_from_file_open(filepath, reports);
+  FileData *fd = blo_filedata_from_file_open(filepath, reports, true);
   if (fd != nullptr) {
     /* needed for library_append and read_libraries */
     STRNCPY(fd->relabase, filepath);
@@ -1277,7 +1288,7 @@ FileData *blo_filedata_from_file(const char *filepath, BlendFileReadReport *repo
 static FileData *blo_filedata_from_file_minimal(const char *filepath)
 {
   BlendFileReadReport read_report{};
-  FileData *fd = blo_filedata_from_file_open(filepath, &read_report);
+  FileData *fd = blo_filedata_from_file_open(filepath, &read_report, false);
   if (fd != nullptr) {
     decode_blender_header(fd);
     if (fd->flags & FD_FLAGS_FILE_OK) {
@@ -1403,6 +1414,242 @@ void blo_filedata_free(FileData *fd)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Block Header Index
+ *
+ * Opening a file walks the header of every block to find the DNA at the end of the file, which
+ * for large compressed libraries means decompressing the whole file even when only a few
+ * data-blocks are linked. The index stores the result of this walk next to the library: the
+ * headers and offsets of all the blocks and the content of the non #BLO_CODE_DATA blocks (IDs,
+ * DNA...), which are the ones kept in memory by #get_bhead. Reading it rebuilds the same list of
+ * #BHeadN without the walk, the content of the #BLO_CODE_DATA blocks of the linked data-blocks
+ * and their dependencies is then read on demand.
+ *
+ * The index is a local cache, stored in the native byte order and pointer size, and is rejected
+ * when the size or the modification time of the library changed. The modification time is
+ * compared with the sub-second precision of the file system, where the platform provides it.
+ * \{ */
+
+#define BHEAD_INDEX_EXT ".bidx"
+#define BHEAD_INDEX_VERSION 2
+
+struct BHeadIndexHeader {
+  char magic[8];
+  int version;
+  int endian_order;
+  int pointer_size;
+  int bhead_count;
+  int64_t file_size;
+  int64_t file_mtime;
+  int64_t file_mtime_nsec;
+};
+
+struct BHeadIndexEntry {
+  int code, len;
+  uint64_t old;
+  int SDNAnr, nr;
+  /** Offset of the content in the library, 0 when the content follows the entry. */
+  int64_t file_offset;
+};
+
+static void bhead_index_header_init(BHeadIndexHeader *header, const BLI_stat_t *st)
+{
+  memset(header, 0, sizeof(*header));
+  memcpy(header->magic, "BLENBIDX", sizeof(header->magic));
+  header->version = BHEAD_INDEX_VERSION;
+  header->endian_order = ENDIAN_ORDER;
+  header->pointer_size = int(sizeof(void *));
+  header->file_size = int64_t(st->st_size);
+  header->file_mtime = int64_t(st->st_mtime);
+#if defined(__APPLE__)
+  header->file_mtime_nsec = int64_t(st->st_mtimespec.tv_nsec);
+#elif !defined(WIN32)
+  header->file_mtime_nsec = int64_t(st->st_mtim.tv_nsec);
+#endif
+}
+
+/**
+ * Read the block list of \a fd from an index opened at its first entry.
+ * \return False if the index is truncated or has blocks outside of the library, the list is then
+ * left empty.
+ */
+static bool bhead_index_read(FileData *fd, FILE *index, const int bhead_count)
+{
+  /* The offsets are in the decompressed data for compressed libraries, not in the file. */
+  const off64_t offset_backup = fd->file->offset;
+  const off64_t file_size = fd->file->seek(fd->file, 0, SEEK_END);
+  if (file_size == -1 || fd->file->seek(fd->file, offset_backup, SEEK_SET) == -1) {
+    return false;
+  }
+
+  for (int i = 0; i < bhead_count; i++) {
+    BHeadIndexEntry entry;
+    if (fread(&entry, sizeof(entry), 1, index) != 1 || entry.len < 0 || entry.len > file_size) {
+      break;
+    }
+    /* Blocks read on demand must have their header and content inside the library. */
+    if (entry.file_offset != 0 && (entry.file_offset < int64_t(sizeof(BHead)) ||
+                                   entry.file_offset + entry.len > file_size))
+    {
+      break;
+    }
+
+    BHead bhead;
+    bhead.code = entry.code;
+    bhead.len = entry.len;
+    bhead.old = (const void *)uintptr_t(entry.old);
+    bhead.SDNAnr = entry.SDNAnr;
+    bhead.nr = entry.nr;
+
+    const bool has_data = (entry.file_offset == 0);
+    BHeadN *new_bhead = static_cast<BHeadN *>(
+        MEM_mallocN(sizeof(BHeadN) + (has_data ? size_t(bhead.len) : 0), "new_bhead"));
+    new_bhead->next = new_bhead->prev = nullptr;
+    new_bhead->file_offset = off64_t(entry.file_offset);
+    new_bhead->has_data = has_data;
+    new_bhead->is_memchunk_identical = false;
+    new_bhead->bhead = bhead;
+
+    if (has_data && bhead.len != 0 && fread(new_bhead + 1, size_t(bhead.len), 1, index) != 1) {
+      MEM_freeN(new_bhead);
+      break;
+    }
+
+    BLI_addtail(&fd->bhead_list, new_bhead);
+  }
+
+  if (BLI_listbase_count(&fd->bhead_list) != bhead_count ||
+      static_cast<BHeadN *>(fd->bhead_list.last)->bhead.code != BLO_CODE_ENDB)
+  {
+    BLI_freelistN(&fd->bhead_list);
+    return false;
+  }
+
+  /* The whole file is known, #get_bhead must not read past the header. */
+  fd->is_eof = true;
+  return true;
+}
+
+/**
+ * Write the block list of \a fd, which must have been read up to #BLO_CODE_ENDB.
+ * The index is written to a temporary file renamed at the end, so that readers never see a
+ * partial index. The temporary name is unique to the process and the call, as the same library
+ * can be indexed by several instances or threads at once.
+ */
+static void bhead_index_write(FileData *fd, const char *index_path, const BLI_stat_t *st)
+{
+  static std::atomic<unsigned int> temp_counter = 0;
+
+  char index_path_temp[FILE_MAX + 32];
+  SNPRINTF(index_path_temp, "%s@%d_%u", index_path, abs(getpid()), temp_counter++);
+
+  FILE *index = BLI_fopen(index_path_temp, "wb");
+  if (index == nullptr) {
+    /* Libraries in read-only directories are just not indexed. */
+    CLOG_INFO(&LOG, 2, "Unable to write block index '%s'", index_path);
+    return;
+  }
+
+  BHeadIndexHeader header;
+  bhead_index_header_init(&header, st);
+  header.bhead_count = BLI_listbase_count(&fd->bhead_list);
+
+  bool ok = (fwrite(&header, sizeof(header), 1, index) == 1);
+  LISTBASE_FOREACH (BHeadN *, new_bhead, &fd->bhead_list) {
+    if (!ok) {
+      break;
+    }
+
+    const BHead &bhead = new_bhead->bhead;
+    BHeadIndexEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.code = bhead.code;
+    entry.len = bhead.len;
+    entry.old = uint64_t(uintptr_t(bhead.old));
+    entry.SDNAnr = bhead.SDNAnr;
+    entry.nr = bhead.nr;
+    entry.file_offset = new_bhead->has_data ? 0 : int64_t(new_bhead->file_offset);
+
+    ok = (fwrite(&entry, sizeof(entry), 1, index) == 1);
+    if (ok && new_bhead->has_data && bhead.len != 0) {
+      ok = (fwrite(new_bhead + 1, size_t(bhead.len), 1, index) == 1);
+    }
+  }
+
+  ok = (fclose(index) == 0) && ok;
+  if (!ok || BLI_rename_overwrite(index_path_temp, index_path) != 0) {
+    CLOG_INFO(&LOG, 2, "Unable to write block index '%s'", index_path);
+    BLI_delete(index_path_temp, false, false);
+  }
+}
+
+FileData *blo_filedata_from_file_indexed(const char *filepath, BlendFileReadReport *reports)
+{
+  BLI_stat_t st;
+  if (BLI_stat(filepath, &st) == -1) {
+    return blo_filedata_from_file(filepath, reports);
+  }
+
+  char index_path[FILE_MAX + 8];
+  SNPRINTF(index_path, "%s" BHEAD_INDEX_EXT, filepath);
+
+  /* Check the index before opening the library: without it the file is read sequentially and
+   * benefits from the read-ahead, with it only the linked blocks are read. */
+  BHeadIndexHeader header;
+  FILE *index = BLI_fopen(index_path, "rb");
+  if (index != nullptr) {
+    BHeadIndexHeader header_expected;
+    bhead_index_header_init(&header_expected, &st);
+    if (fread(&header, sizeof(header), 1, index) != 1 ||
+        memcmp(header.magic, header_expected.magic, sizeof(header.magic)) != 0 ||
+        header.version != header_expected.version ||
+        header.endian_order != header_expected.endian_order ||
+        header.pointer_size != header_expected.pointer_size ||
+        header.file_size != header_expected.file_size ||
+        header.file_mtime != header_expected.file_mtime ||
+        header.file_mtime_nsec != header_expected.file_mtime_nsec || header.bhead_count <= 0)
+    {
+      fclose(index);
+      index = nullptr;
+    }
+  }
+
+  FileData *fd = blo_filedata_from_file_open(filepath, reports, index == nullptr);
+  if (fd == nullptr) {
+    if (index != nullptr) {
+      fclose(index);
+    }
+    return nullptr;
+  }
+  STRNCPY(fd->relabase, filepath);
+
+  /* Blocks can only be read on demand from seekable files, other files are kept in memory. */
+  const bool use_index = (fd->file->seek != nullptr);
+  bool index_valid = false;
+  if (index != nullptr) {
+    index_valid = use_index && bhead_index_read(fd, index, header.bhead_count);
+    fclose(index);
+  }
+
+  fd = blo_decode_and_check(fd, reports->reports);
+  if (fd == nullptr || !use_index || index_valid) {
+    return fd;
+  }
+
+  /* Read the remaining block headers to index the whole file. */
+  for (BHead *bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+    /* pass */
+  }
+  const BHeadN *last = static_cast<const BHeadN *>(fd->bhead_list.last);
+  if (last != nullptr && last->bhead.code == BLO_CODE_ENDB) {
+    bhead_index_write(fd, index_path, &st);
+  }
+
+  return fd;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Read Thumbnail from Blend File
  * \{ */
@@ -155,6 +155,11 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath);
  * cannot be called with relative paths anymore!
  */
 FileData *blo_filedata_from_file(const char *filepath, BlendFileReadReport *reports);
+/**
+ * Same as #blo_filedata_from_file, but rebuilds the block list from an index cached next to the
+ * file when it's up to date, and writes the index otherwise.
+ */
+FileData *blo_filedata_from_file_indexed(const char *filepath, BlendFileReadReport *reports);
 FileData *blo_filedata_from_memory(const void *mem, int memsize, BlendFileReadReport *reports);
 FileData *blo_filedata_from_memfile(MemFile *memfile,
                                     const BlendFileReadParams *params,
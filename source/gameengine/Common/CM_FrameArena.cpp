@@ -0,0 +1,113 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_FrameArena.cpp
+ *  \ingroup common
+ */
+
+#include "CM_FrameArena.h"
+
+#include <algorithm>
+
+#include "MEM_guardedalloc.h"
+
+CM_FrameArena *CM_FrameArena::m_active = nullptr;
+
+CM_FrameArena::CM_FrameArena() : m_current(0), m_stats({0, 0, 0}), m_lastStats({0, 0, 0})
+{
+  for (Generation &generation : m_generations) {
+    generation.m_offset = 0;
+  }
+}
+
+CM_FrameArena::~CM_FrameArena()
+{
+  for (Generation &generation : m_generations) {
+    for (const Block &block : generation.m_blocks) {
+      MEM_freeN(block.m_data);
+    }
+  }
+
+  if (m_active == this) {
+    m_active = nullptr;
+  }
+}
+
+void *CM_FrameArena::AllocateBlock(size_t size, size_t alignment)
+{
+  Generation &generation = m_generations[m_current];
+
+  // The blocks grow geometrically to make few heap calls in a frame of unusual needs.
+  const size_t lastSize = generation.m_blocks.empty() ? 0 : generation.m_blocks.back().m_size;
+  const size_t blockSize = std::max({MIN_BLOCK_SIZE, lastSize * 2, size + alignment});
+
+  Block block;
+  block.m_data = (char *)MEM_mallocN(blockSize, "CM_FrameArena");
+  block.m_size = blockSize;
+  generation.m_blocks.push_back(block);
+  generation.m_offset = 0;
+  ++m_stats.m_heapCalls;
+
+  return Allocate(size, alignment);
+}
+
+void CM_FrameArena::EndFrame()
+{
+  m_lastStats = m_stats;
+  m_stats = {0, 0, 0};
+
+  // The generation of the frame before the ended frame is now free.
+  m_current = 1 - m_current;
+  Generation &generation = m_generations[m_current];
+
+  // Merge the blocks of a frame which needed several into one block of their total size.
+  if (generation.m_blocks.size() > 1) {
+    size_t totalSize = 0;
+    for (const Block &block : generation.m_blocks) {
+      totalSize += block.m_size;
+      MEM_freeN(block.m_data);
+    }
+
+    Block block;
+    block.m_data = (char *)MEM_mallocN(totalSize, "CM_FrameArena");
+    block.m_size = totalSize;
+    generation.m_blocks.assign(1, block);
+    ++m_stats.m_heapCalls;
+  }
+
+  generation.m_offset = 0;
+}
+
+const CM_FrameArena::Stats &CM_FrameArena::GetLastFrameStats() const
+{
+  return m_lastStats;
+}
+
+CM_FrameArena *CM_FrameArena::GetActive()
+{
+  return m_active;
+}
+
+void CM_FrameArena::SetActive(CM_FrameArena *arena)
+{
+  m_active = arena;
+}
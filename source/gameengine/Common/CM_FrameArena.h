@@ -0,0 +1,168 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_FrameArena.h
+ *  \ingroup common
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+/** Bump allocator of the transient allocations of the engine frames.
+ *
+ * Allocations are carved from large blocks and never freed individually, the memory of a frame
+ * is released at once by EndFrame(). The memory allocated during a frame stays valid until the
+ * end of the next frame, for data produced by the physics of a frame and read by the logic of
+ * the next one (e.g. collision data). The blocks are kept from frame to frame, so that frames
+ * with similar needs make no heap call.
+ *
+ * The arena isn't thread safe, it's only used by the main thread. The destructors of the objects
+ * allocated in the arena are not called.
+ */
+class CM_FrameArena {
+ public:
+  struct Stats {
+    /// Number of allocations served by the arena.
+    unsigned int m_allocations;
+    /// Number of bytes allocated.
+    size_t m_bytes;
+    /// Number of blocks allocated from the heap.
+    unsigned int m_heapCalls;
+  };
+
+  /// Size of the first block of a frame.
+  static constexpr size_t MIN_BLOCK_SIZE = 64 * 1024;
+
+ private:
+  struct Block {
+    char *m_data;
+    size_t m_size;
+  };
+
+  /// The blocks of a frame, the allocations are done in the last block.
+  struct Generation {
+    std::vector<Block> m_blocks;
+    /// Position of the next allocation in the last block.
+    size_t m_offset;
+  };
+
+  Generation m_generations[2];
+  /// Index of the generation of the current frame.
+  unsigned short m_current;
+
+  Stats m_stats;
+  Stats m_lastStats;
+
+  static CM_FrameArena *m_active;
+
+  void *AllocateBlock(size_t size, size_t alignment);
+
+ public:
+  CM_FrameArena();
+  ~CM_FrameArena();
+
+  CM_FrameArena(const CM_FrameArena &other) = delete;
+  CM_FrameArena &operator=(const CM_FrameArena &other) = delete;
+
+  inline void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+  {
+    Generation &generation = m_generations[m_current];
+    if (!generation.m_blocks.empty()) {
+      const Block &block = generation.m_blocks.back();
+      const uintptr_t begin = (uintptr_t)block.m_data;
+      const uintptr_t address = (begin + generation.m_offset + alignment - 1) &
+                                ~(uintptr_t)(alignment - 1);
+      if (address + size <= begin + block.m_size) {
+        generation.m_offset = address + size - begin;
+        ++m_stats.m_allocations;
+        m_stats.m_bytes += size;
+        return (void *)address;
+      }
+    }
+
+    return AllocateBlock(size, alignment);
+  }
+
+  template<class T, class... Args> inline T *New(Args &&...args)
+  {
+    return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  /// Allocate an array of trivial types, the elements are not initialized.
+  template<class T> inline T *NewArray(size_t count)
+  {
+    return static_cast<T *>(Allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  /// Release the memory of the frame before the current frame and start a new frame.
+  void EndFrame();
+
+  /// Return the statistics of the last ended frame.
+  const Stats &GetLastFrameStats() const;
+
+  /// The arena of the running engine.
+  static CM_FrameArena *GetActive();
+  static void SetActive(CM_FrameArena *arena);
+};
+
+/// STL allocator using the active frame arena, for containers of a frame.
+template<class T> class CM_FrameAllocator {
+ public:
+  using value_type = T;
+
+  CM_FrameArena *m_arena;
+
+  CM_FrameAllocator() noexcept : m_arena(CM_FrameArena::GetActive())
+  {
+  }
+
+  template<class U>
+  CM_FrameAllocator(const CM_FrameAllocator<U> &other) noexcept : m_arena(other.m_arena)
+  {
+  }
+
+  T *allocate(size_t count)
+  {
+    return static_cast<T *>(m_arena->Allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  void deallocate(T * /*ptr*/, size_t /*count*/) noexcept
+  {
+  }
+
+  template<class U> bool operator==(const CM_FrameAllocator<U> &other) const noexcept
+  {
+    return m_arena == other.m_arena;
+  }
+
+  template<class U> bool operator!=(const CM_FrameAllocator<U> &other) const noexcept
+  {
+    return m_arena != other.m_arena;
+  }
+};
+
+template<class T> using CM_FrameVector = std::vector<T, CM_FrameAllocator<T>>;
@@ -0,0 +1,449 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_PoolAllocator.cpp
+ *  \ingroup common
+ */
+
+#include "CM_PoolAllocator.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "CM_Thread.h"
+
+/* Size classes of 16 bytes steps up to 128 bytes, then of four steps per power of two up to
+ * MAX_SIZE, the rounding wastes at most a quarter of a block. */
+static constexpr unsigned int NUM_CLASSES = 28;
+static constexpr unsigned int MAX_SLOTS = CM_PoolAllocator::MAX_SIZE / CM_PoolAllocator::ALIGNMENT;
+/// Size of the memory allocated at once for a pool.
+static constexpr size_t SLAB_SIZE = 64 * 1024;
+
+static constexpr std::array<unsigned int, NUM_CLASSES> class_sizes()
+{
+  std::array<unsigned int, NUM_CLASSES> sizes = {};
+  unsigned int size = 0;
+  unsigned int power = 128;
+  for (unsigned int i = 0; i < NUM_CLASSES; ++i) {
+    if (size >= power * 2) {
+      power *= 2;
+    }
+    size += (size < 128) ? 16 : power / 4;
+    sizes[i] = size;
+  }
+  return sizes;
+}
+
+static constexpr std::array<unsigned int, NUM_CLASSES> classSizes = class_sizes();
+
+/// Size class of each multiple of the alignment.
+static constexpr std::array<unsigned char, MAX_SLOTS + 1> class_indices()
+{
+  std::array<unsigned char, MAX_SLOTS + 1> indices = {};
+  unsigned int index = 0;
+  for (unsigned int slot = 0; slot <= MAX_SLOTS; ++slot) {
+    while (classSizes[index] < slot * CM_PoolAllocator::ALIGNMENT) {
+      ++index;
+    }
+    indices[slot] = index;
+  }
+  return indices;
+}
+
+static constexpr std::array<unsigned char, MAX_SLOTS + 1> classIndices = class_indices();
+
+static_assert(classSizes[NUM_CLASSES - 1] == CM_PoolAllocator::MAX_SIZE,
+              "The last size class must be the maximum size");
+
+static inline unsigned int class_index(size_t size)
+{
+  return classIndices[(size + CM_PoolAllocator::ALIGNMENT - 1) / CM_PoolAllocator::ALIGNMENT];
+}
+
+/// Number of blocks moved at once between a thread cache and a pool.
+static inline unsigned int batch_size(unsigned int index)
+{
+  return std::clamp(8192u / classSizes[index], 4u, 64u);
+}
+
+namespace {
+
+struct FreeBlock {
+  FreeBlock *m_next;
+};
+
+/// Blocks of a size class shared by all the threads.
+struct Pool {
+  CM_ThreadSpinLock m_lock;
+  FreeBlock *m_free = nullptr;
+  /// Part of the last slab not yet cut in blocks.
+  char *m_slab = nullptr;
+  char *m_slabEnd = nullptr;
+
+  /// Return a free block, cutting it in a new slab if needed, with the pool locked.
+  FreeBlock *Pop(unsigned int index);
+};
+
+struct ThreadCache;
+
+struct Pools {
+  Pool m_pools[NUM_CLASSES];
+  std::atomic<uint64_t> m_reservedBytes{0};
+
+  /// Caches of the running threads and counters of the exited threads, protected by m_mutex.
+  CM_ThreadMutex m_mutex;
+  std::vector<ThreadCache *> m_caches;
+  CM_PoolAllocator::Stats m_exitedStats = {};
+};
+
+/// The pools are never destructed, objects can be freed by threads exiting after the statics.
+static Pools &get_pools()
+{
+  static Pools *pools = new Pools();
+  return *pools;
+}
+
+/// Counter only written by its thread, read by any thread.
+struct Counter {
+  std::atomic<uint64_t> m_value{0};
+
+  inline void Add(uint64_t value)
+  {
+    m_value.store(m_value.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+
+  inline uint64_t Get() const
+  {
+    return m_value.load(std::memory_order_relaxed);
+  }
+};
+
+struct ThreadCache {
+  struct Bin {
+    FreeBlock *m_free = nullptr;
+    unsigned int m_count = 0;
+  };
+
+  Bin m_bins[NUM_CLASSES];
+
+  Counter m_allocations;
+  Counter m_frees;
+  Counter m_largeAllocations;
+  Counter m_allocatedBytes;
+  Counter m_freedBytes;
+  Counter m_allocatedBlockBytes;
+  Counter m_freedBlockBytes;
+
+  ThreadCache();
+  ~ThreadCache();
+
+  /// Move up to count blocks of a bin to its pool.
+  void Flush(unsigned int index, unsigned int count);
+  /// Move a batch of blocks of a pool to a bin, cutting them in a new slab if needed.
+  void Refill(unsigned int index);
+};
+
+ThreadCache::ThreadCache()
+{
+  Pools &pools = get_pools();
+  pools.m_mutex.Lock();
+  pools.m_caches.push_back(this);
+  pools.m_mutex.Unlock();
+}
+
+ThreadCache::~ThreadCache()
+{
+  for (unsigned int i = 0; i < NUM_CLASSES; ++i) {
+    Flush(i, m_bins[i].m_count);
+  }
+
+  Pools &pools = get_pools();
+  pools.m_mutex.Lock();
+  CM_PoolAllocator::Stats &stats = pools.m_exitedStats;
+  stats.m_allocations += m_allocations.Get();
+  stats.m_frees += m_frees.Get();
+  stats.m_largeAllocations += m_largeAllocations.Get();
+  stats.m_requestedBytes += m_allocatedBytes.Get() - m_freedBytes.Get();
+  stats.m_blockBytes += m_allocatedBlockBytes.Get() - m_freedBlockBytes.Get();
+  pools.m_caches.erase(std::find(pools.m_caches.begin(), pools.m_caches.end(), this));
+  pools.m_mutex.Unlock();
+}
+
+void ThreadCache::Flush(unsigned int index, unsigned int count)
+{
+  Bin &bin = m_bins[index];
+  if (count == 0) {
+    return;
+  }
+
+  FreeBlock *first = bin.m_free;
+  FreeBlock *last = first;
+  for (unsigned int i = 1; i < count; ++i) {
+    last = last->m_next;
+  }
+  bin.m_free = last->m_next;
+  bin.m_count -= count;
+
+  Pool &pool = get_pools().m_pools[index];
+  pool.m_lock.Lock();
+  last->m_next = pool.m_free;
+  pool.m_free = first;
+  pool.m_lock.Unlock();
+}
+
+void ThreadCache::Refill(unsigned int index)
+{
+  Bin &bin = m_bins[index];
+  const unsigned int batch = batch_size(index);
+  Pool &pool = get_pools().m_pools[index];
+
+  pool.m_lock.Lock();
+  while (bin.m_count < batch) {
+    FreeBlock *block = pool.Pop(index);
+    if (!block) {
+      break;
+    }
+    block->m_next = bin.m_free;
+    bin.m_free = block;
+    ++bin.m_count;
+  }
+  pool.m_lock.Unlock();
+}
+
+FreeBlock *Pool::Pop(unsigned int index)
+{
+  FreeBlock *block = m_free;
+  if (block) {
+    m_free = block->m_next;
+    return block;
+  }
+
+  const size_t size = classSizes[index];
+  if ((size_t)(m_slabEnd - m_slab) < size) {
+    // The end of the previous slab too small for a block is lost.
+    m_slab = (char *)std::malloc(SLAB_SIZE);
+    if (!m_slab) {
+      m_slabEnd = nullptr;
+      return nullptr;
+    }
+    m_slabEnd = m_slab + SLAB_SIZE;
+    get_pools().m_reservedBytes.fetch_add(SLAB_SIZE, std::memory_order_relaxed);
+  }
+
+  block = (FreeBlock *)m_slab;
+  m_slab += size;
+  return block;
+}
+
+/** Cache of the thread, created at its first allocation and destructed at its exit.
+ * The objects freed by the thread after are directly returned to the pools. */
+static thread_local ThreadCache *threadCache = nullptr;
+static thread_local bool threadExited = false;
+
+struct ThreadCacheOwner {
+  ~ThreadCacheOwner()
+  {
+    delete threadCache;
+    threadCache = nullptr;
+    threadExited = true;
+  }
+};
+
+static thread_local ThreadCacheOwner threadCacheOwner;
+
+static inline ThreadCache *get_thread_cache()
+{
+  if (!threadCache && !threadExited) {
+    // Construct the owner to destruct the cache at the exit of the thread.
+    (void)&threadCacheOwner;
+    threadCache = new ThreadCache();
+  }
+  return threadCache;
+}
+
+}  // namespace
+
+bool CM_PoolAllocator::m_enabled = false;
+
+void CM_PoolAllocator::SetEnabled(bool enabled)
+{
+  m_enabled = enabled;
+}
+
+bool CM_PoolAllocator::GetEnabled()
+{
+  return m_enabled;
+}
+
+void *CM_PoolAllocator::Allocate(size_t size)
+{
+  ThreadCache *cache = get_thread_cache();
+  if (!cache) {
+    return AllocateExited(size);
+  }
+
+  cache->m_allocations.Add(1);
+  cache->m_allocatedBytes.Add(size);
+
+  if (!m_enabled || size > MAX_SIZE) {
+    if (m_enabled) {
+      cache->m_largeAllocations.Add(1);
+    }
+    cache->m_allocatedBlockBytes.Add(size);
+    return ::operator new(size);
+  }
+
+  const unsigned int index = class_index(size);
+  ThreadCache::Bin &bin = cache->m_bins[index];
+  if (!bin.m_free) {
+    cache->Refill(index);
+    if (!bin.m_free) {
+      throw std::bad_alloc();
+    }
+  }
+
+  FreeBlock *block = bin.m_free;
+  bin.m_free = block->m_next;
+  --bin.m_count;
+  cache->m_allocatedBlockBytes.Add(classSizes[index]);
+
+  return block;
+}
+
+void CM_PoolAllocator::Free(void *ptr, size_t size)
+{
+  if (!ptr) {
+    return;
+  }
+
+  ThreadCache *cache = get_thread_cache();
+  if (!cache) {
+    FreeExited(ptr, size);
+    return;
+  }
+
+  cache->m_frees.Add(1);
+  cache->m_freedBytes.Add(size);
+
+  if (!m_enabled || size > MAX_SIZE) {
+    cache->m_freedBlockBytes.Add(size);
+    ::operator delete(ptr);
+    return;
+  }
+
+  // A block freed by another thread than its allocator joins the cache of the freeing thread.
+  const unsigned int index = class_index(size);
+  ThreadCache::Bin &bin = cache->m_bins[index];
+  FreeBlock *block = (FreeBlock *)ptr;
+  block->m_next = bin.m_free;
+  bin.m_free = block;
+  ++bin.m_count;
+  cache->m_freedBlockBytes.Add(classSizes[index]);
+
+  const unsigned int batch = batch_size(index);
+  if (bin.m_count > batch * 2) {
+    cache->Flush(index, batch);
+  }
+}
+
+void *CM_PoolAllocator::AllocateExited(size_t size)
+{
+  void *ptr = nullptr;
+  size_t blockSize = size;
+  Pools &pools = get_pools();
+  if (!m_enabled || size > MAX_SIZE) {
+    ptr = ::operator new(size);
+  }
+  else {
+    const unsigned int index = class_index(size);
+    Pool &pool = pools.m_pools[index];
+    pool.m_lock.Lock();
+    ptr = pool.Pop(index);
+    pool.m_lock.Unlock();
+    if (!ptr) {
+      throw std::bad_alloc();
+    }
+    blockSize = classSizes[index];
+  }
+
+  pools.m_mutex.Lock();
+  Stats &stats = pools.m_exitedStats;
+  ++stats.m_allocations;
+  if (m_enabled && size > MAX_SIZE) {
+    ++stats.m_largeAllocations;
+  }
+  stats.m_requestedBytes += size;
+  stats.m_blockBytes += blockSize;
+  pools.m_mutex.Unlock();
+
+  return ptr;
+}
+
+void CM_PoolAllocator::FreeExited(void *ptr, size_t size)
+{
+  size_t blockSize = size;
+  Pools &pools = get_pools();
+  if (!m_enabled || size > MAX_SIZE) {
+    ::operator delete(ptr);
+  }
+  else {
+    const unsigned int index = class_index(size);
+    Pool &pool = pools.m_pools[index];
+    FreeBlock *block = (FreeBlock *)ptr;
+    pool.m_lock.Lock();
+    block->m_next = pool.m_free;
+    pool.m_free = block;
+    pool.m_lock.Unlock();
+    blockSize = classSizes[index];
+  }
+
+  pools.m_mutex.Lock();
+  Stats &stats = pools.m_exitedStats;
+  ++stats.m_frees;
+  stats.m_requestedBytes -= size;
+  stats.m_blockBytes -= blockSize;
+  pools.m_mutex.Unlock();
+}
+
+CM_PoolAllocator::Stats CM_PoolAllocator::GetStats()
+{
+  Pools &pools = get_pools();
+  pools.m_mutex.Lock();
+  Stats stats = pools.m_exitedStats;
+  for (const ThreadCache *cache : pools.m_caches) {
+    stats.m_allocations += cache->m_allocations.Get();
+    stats.m_frees += cache->m_frees.Get();
+    stats.m_largeAllocations += cache->m_largeAllocations.Get();
+    stats.m_requestedBytes += cache->m_allocatedBytes.Get() - cache->m_freedBytes.Get();
+    stats.m_blockBytes += cache->m_allocatedBlockBytes.Get() - cache->m_freedBlockBytes.Get();
+  }
+  pools.m_mutex.Unlock();
+
+  stats.m_enabled = m_enabled;
+  stats.m_reservedBytes = pools.m_reservedBytes.load(std::memory_order_relaxed);
+
+  return stats;
+}
@@ -0,0 +1,97 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_PoolAllocator.h
+ *  \ingroup common
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/** Allocator of the engine objects created and deleted at run time (values, scene graph nodes,
+ * game objects, logic bricks...).
+ *
+ * When enabled the objects are allocated in pools of fixed size blocks, one pool per size class.
+ * Each thread keeps a cache of free blocks per size class, the shared pools are only locked to
+ * move a batch of blocks from or to a cache. The blocks have no header, the size of an object
+ * is given back when it's freed, and the memory of the pools is reused but never released.
+ * When disabled the objects are allocated by the default operator new.
+ *
+ * In both modes the allocations are counted to compare the memory use and the number of
+ * allocations of the two modes.
+ */
+class CM_PoolAllocator {
+ public:
+  /// Size of the largest size class, the larger objects use the default operator new.
+  static constexpr size_t MAX_SIZE = 4096;
+  /// Alignment of the blocks.
+  static constexpr size_t ALIGNMENT = 16;
+
+  struct Stats {
+    bool m_enabled;
+    /// Number of allocations and frees since the start.
+    uint64_t m_allocations;
+    uint64_t m_frees;
+    /// Number of allocations larger than the size classes.
+    uint64_t m_largeAllocations;
+    /// Bytes of the live objects.
+    uint64_t m_requestedBytes;
+    /// Bytes of the blocks of the live objects, including the rounding to the size class.
+    uint64_t m_blockBytes;
+    /// Bytes reserved by the pools, used or free.
+    uint64_t m_reservedBytes;
+  };
+
+ private:
+  static bool m_enabled;
+
+  /// Allocate and free without the cache of the thread, after its exit.
+  static void *AllocateExited(size_t size);
+  static void FreeExited(void *ptr, size_t size);
+
+ public:
+  /** Enable or disable the pools, only before the first allocation of an engine object as
+   * the objects must be freed in the mode they were allocated.
+   */
+  static void SetEnabled(bool enabled);
+  static bool GetEnabled();
+
+  static void *Allocate(size_t size);
+  static void Free(void *ptr, size_t size);
+
+  /// Return the counters summed over all the threads.
+  static Stats GetStats();
+};
+
+/// Allocate the instances of a class and its subclasses with CM_PoolAllocator.
+#define CM_POOL_ALLOC_FUNCS \
+ public: \
+  static void *operator new(size_t size) \
+  { \
+    return CM_PoolAllocator::Allocate(size); \
+  } \
+  static void operator delete(void *ptr, size_t size) \
+  { \
+    CM_PoolAllocator::Free(ptr, size); \
+  }
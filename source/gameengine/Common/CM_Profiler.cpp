@@ -0,0 +1,289 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Common/CM_Profiler.cpp
+ *  \ingroup common
+ */
+
+#include "CM_Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+CM_Clock CM_Profiler::m_clock;
+std::vector<CM_Profiler::Zone> CM_Profiler::m_zones;
+std::vector<unsigned int> CM_Profiler::m_roots;
+std::vector<unsigned int> CM_Profiler::m_categories;
+std::vector<unsigned int> CM_Profiler::m_stack;
+int CM_Profiler::m_category = -1;
+bool CM_Profiler::m_measuring = false;
+bool CM_Profiler::m_enabled = false;
+unsigned int CM_Profiler::m_numFrames = 0;
+
+unsigned int CM_Profiler::NewZone(const char *name, int parent)
+{
+  const unsigned int index = m_zones.size();
+
+  m_zones.emplace_back();
+  Zone &zone = m_zones.back();
+  zone.m_name = name;
+  zone.m_parent = parent;
+  zone.m_start = 0;
+  zone.m_time = 0;
+  zone.m_calls = 0;
+  zone.m_frameTimes.fill(0.0f);
+  zone.m_frameCalls.fill(0);
+
+  if (parent == -1) {
+    m_roots.push_back(index);
+  }
+  else {
+    m_zones[parent].m_children.push_back(index);
+  }
+
+  return index;
+}
+
+void CM_Profiler::CloseZones(CM_Clock::Rep now)
+{
+  for (unsigned int index : m_stack) {
+    Zone &zone = m_zones[index];
+    zone.m_time += now - zone.m_start;
+  }
+  m_stack.clear();
+}
+
+bool CM_Profiler::IsEnabled()
+{
+  return m_enabled;
+}
+
+void CM_Profiler::SetEnabled(bool enabled)
+{
+  m_enabled = enabled;
+}
+
+void CM_Profiler::Reset()
+{
+  m_zones.clear();
+  m_roots.clear();
+  m_categories.clear();
+  m_stack.clear();
+  m_category = -1;
+  m_measuring = false;
+  m_enabled = false;
+  m_numFrames = 0;
+}
+
+unsigned int CM_Profiler::AddCategory(const std::string &name)
+{
+  m_categories.push_back(NewZone(name.c_str(), -1));
+  return m_categories.size() - 1;
+}
+
+void CM_Profiler::StartCategory(unsigned int category)
+{
+  const CM_Clock::Rep now = m_clock.GetTimeNano();
+  // The zones can't overlap two categories.
+  CloseZones(now);
+
+  if (m_category != -1) {
+    Zone &previous = m_zones[m_category];
+    previous.m_time += now - previous.m_start;
+  }
+
+  m_category = m_categories[category];
+  Zone &zone = m_zones[m_category];
+  zone.m_start = now;
+  ++zone.m_calls;
+}
+
+void CM_Profiler::EndCategory()
+{
+  const CM_Clock::Rep now = m_clock.GetTimeNano();
+  CloseZones(now);
+
+  if (m_category != -1) {
+    Zone &zone = m_zones[m_category];
+    zone.m_time += now - zone.m_start;
+    m_category = -1;
+  }
+}
+
+void CM_Profiler::BeginZone(const char *name)
+{
+  const int parent = m_stack.empty() ? m_category : m_stack.back();
+  const std::vector<unsigned int> &siblings = (parent == -1) ? m_roots :
+                                                                m_zones[parent].m_children;
+
+  int index = -1;
+  for (unsigned int sibling : siblings) {
+    if (strcmp(m_zones[sibling].m_name.c_str(), name) == 0) {
+      index = sibling;
+      break;
+    }
+  }
+
+  if (index == -1) {
+    index = NewZone(name, parent);
+  }
+
+  Zone &zone = m_zones[index];
+  ++zone.m_calls;
+  m_stack.push_back(index);
+  // Read the clock last to not measure the zone lookup.
+  zone.m_start = m_clock.GetTimeNano();
+}
+
+void CM_Profiler::BeginZone(const std::string &name)
+{
+  BeginZone(name.c_str());
+}
+
+void CM_Profiler::EndZone()
+{
+  const CM_Clock::Rep now = m_clock.GetTimeNano();
+
+  // The zones were already closed by a category change.
+  if (m_stack.empty()) {
+    return;
+  }
+
+  Zone &zone = m_zones[m_stack.back()];
+  zone.m_time += now - zone.m_start;
+  m_stack.pop_back();
+}
+
+void CM_Profiler::NextFrame()
+{
+  const CM_Clock::Rep now = m_clock.GetTimeNano();
+
+  // The running category and zones continue in the next frame.
+  if (m_category != -1) {
+    Zone &zone = m_zones[m_category];
+    zone.m_time += now - zone.m_start;
+    zone.m_start = now;
+  }
+  for (unsigned int index : m_stack) {
+    Zone &zone = m_zones[index];
+    zone.m_time += now - zone.m_start;
+    zone.m_start = now;
+  }
+
+  const unsigned int slot = m_numFrames % NUM_FRAMES;
+  for (Zone &zone : m_zones) {
+    zone.m_frameTimes[slot] = zone.m_time * 1e-9;
+    zone.m_frameCalls[slot] = zone.m_calls;
+    zone.m_time = 0;
+    zone.m_calls = 0;
+  }
+
+  ++m_numFrames;
+  m_measuring = m_enabled;
+}
+
+const std::vector<CM_Profiler::Zone> &CM_Profiler::GetZones()
+{
+  return m_zones;
+}
+
+const std::vector<unsigned int> &CM_Profiler::GetRoots()
+{
+  return m_roots;
+}
+
+unsigned int CM_Profiler::GetNumCategories()
+{
+  return m_categories.size();
+}
+
+unsigned int CM_Profiler::GetCategoryZone(unsigned int category)
+{
+  return m_categories[category];
+}
+
+double CM_Profiler::GetLastFrameTime(unsigned int zone)
+{
+  if (m_numFrames == 0) {
+    return 0.0;
+  }
+
+  return m_zones[zone].m_frameTimes[(m_numFrames - 1) % NUM_FRAMES];
+}
+
+CM_Profiler::Stats CM_Profiler::GetStats(unsigned int index)
+{
+  Stats stats = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+  const unsigned int numFrames = std::min(m_numFrames, NUM_FRAMES);
+  if (numFrames == 0) {
+    return stats;
+  }
+
+  const Zone &zone = m_zones[index];
+
+  // Average of the last frames, from the most recent one.
+  const unsigned int numAverageFrames = std::min(numFrames, NUM_AVERAGE_FRAMES);
+  for (unsigned int i = 1; i <= numAverageFrames; ++i) {
+    const unsigned int slot = (m_numFrames - i) % NUM_FRAMES;
+    stats.m_average += zone.m_frameTimes[slot];
+    stats.m_calls += zone.m_frameCalls[slot];
+  }
+  stats.m_average /= numAverageFrames;
+  stats.m_calls /= numAverageFrames;
+
+  // Percentiles of all the frames kept.
+  std::array<float, NUM_FRAMES> times;
+  std::copy_n(zone.m_frameTimes.begin(), numFrames, times.begin());
+
+  const auto percentile = [&times, numFrames](double p) {
+    const unsigned int rank = std::max(1u, (unsigned int)std::ceil(p * numFrames));
+    float *nth = times.data() + (rank - 1);
+    std::nth_element(times.data(), nth, times.data() + numFrames);
+    return (double)*nth;
+  };
+
+  stats.m_p50 = percentile(0.5);
+  stats.m_p95 = percentile(0.95);
+  stats.m_p99 = percentile(0.99);
+
+  return stats;
+}
+
+double CM_Profiler::GetAverageFrameTime()
+{
+  const unsigned int numFrames = std::min(std::min(m_numFrames, NUM_FRAMES), NUM_AVERAGE_FRAMES);
+  if (numFrames == 0) {
+    return 0.0;
+  }
+
+  double time = 0.0;
+  for (unsigned int index : m_categories) {
+    const Zone &zone = m_zones[index];
+    for (unsigned int i = 1; i <= numFrames; ++i) {
+      time += zone.m_frameTimes[(m_numFrames - i) % NUM_FRAMES];
+    }
+  }
+
+  return time / numFrames;
+}
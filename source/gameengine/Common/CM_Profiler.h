@@ -0,0 +1,164 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_Profiler.h
+ *  \ingroup common
+ */
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "CM_Clock.h"
+
+/** Hierarchical frame profiler.
+ *
+ * The categories are root zones covering the whole frame, the engine switches from one
+ * category to another and their time is always measured. The scoped zones nest in the running
+ * category and in the other open zones, they are measured only when the profiler is enabled.
+ * The time and the number of calls of each zone during the last frames are kept in ring
+ * buffers.
+ *
+ * The profiler must only be used from the main thread.
+ */
+class CM_Profiler {
+ public:
+  /// Number of frames kept for each zone.
+  static constexpr unsigned int NUM_FRAMES = 128;
+  /// Number of last frames used for the averages.
+  static constexpr unsigned int NUM_AVERAGE_FRAMES = 25;
+
+  struct Zone {
+    std::string m_name;
+    /// Index of the parent zone, -1 for the root zones.
+    int m_parent;
+    std::vector<unsigned int> m_children;
+    /// Start of the running measurement.
+    CM_Clock::Rep m_start;
+    /// Time and calls in the current frame.
+    CM_Clock::Rep m_time;
+    unsigned int m_calls;
+    /// Times in seconds and calls of the last frames.
+    std::array<float, NUM_FRAMES> m_frameTimes;
+    std::array<unsigned int, NUM_FRAMES> m_frameCalls;
+  };
+
+  struct Stats {
+    /// Average and percentiles of the time per frame in seconds.
+    double m_average;
+    double m_p50;
+    double m_p95;
+    double m_p99;
+    /// Average number of calls per frame.
+    double m_calls;
+  };
+
+ private:
+  static CM_Clock m_clock;
+  static std::vector<Zone> m_zones;
+  /// Zones without parent, categories included.
+  static std::vector<unsigned int> m_roots;
+  /// Zone of each category.
+  static std::vector<unsigned int> m_categories;
+  /// Open scoped zones.
+  static std::vector<unsigned int> m_stack;
+  /// Running category, -1 for none.
+  static int m_category;
+  /// Zones are measured in the current frame.
+  static bool m_measuring;
+  /// Zones are measured from the next frame.
+  static bool m_enabled;
+  /// Number of frames measured.
+  static unsigned int m_numFrames;
+
+  static unsigned int NewZone(const char *name, int parent);
+  /// Close all the open zones.
+  static void CloseZones(CM_Clock::Rep now);
+
+ public:
+  /// Return true if the scoped zones are measured in the current frame.
+  static inline bool IsMeasuring()
+  {
+    return m_measuring;
+  }
+
+  static bool IsEnabled();
+  /// Enable or disable the scoped zones, the change is applied at the next frame.
+  static void SetEnabled(bool enabled);
+
+  /// Remove all the zones and categories and disable the scoped zones.
+  static void Reset();
+
+  /// Add a category, its index is the number of categories added before.
+  static unsigned int AddCategory(const std::string &name);
+  /// Stop the running category and start measuring a category.
+  static void StartCategory(unsigned int category);
+  /// Stop the running category.
+  static void EndCategory();
+
+  static void BeginZone(const char *name);
+  static void BeginZone(const std::string &name);
+  static void EndZone();
+
+  /// Store the measurements of the current frame in the ring buffers.
+  static void NextFrame();
+
+  static const std::vector<Zone> &GetZones();
+  static const std::vector<unsigned int> &GetRoots();
+  static unsigned int GetNumCategories();
+  static unsigned int GetCategoryZone(unsigned int category);
+  /// Time in seconds of a zone in the last frame.
+  static double GetLastFrameTime(unsigned int zone);
+  static Stats GetStats(unsigned int zone);
+  /// Average frame time in seconds, sum of the average of the categories.
+  static double GetAverageFrameTime();
+};
+
+/// Zone measured from its construction to its destruction.
+class CM_ProfileZone {
+ private:
+  bool m_active;
+
+ public:
+  explicit CM_ProfileZone(const char *name) : m_active(CM_Profiler::IsMeasuring())
+  {
+    if (m_active) {
+      CM_Profiler::BeginZone(name);
+    }
+  }
+
+  explicit CM_ProfileZone(const std::string &name) : m_active(CM_Profiler::IsMeasuring())
+  {
+    if (m_active) {
+      CM_Profiler::BeginZone(name);
+    }
+  }
+
+  ~CM_ProfileZone()
+  {
+    if (m_active) {
+      CM_Profiler::EndZone();
+    }
+  }
+};
@@ -0,0 +1,262 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Common/CM_Trace.cpp
+ *  \ingroup common
+ */
+
+#include "CM_Trace.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "CM_Message.h"
+
+CM_Clock CM_Trace::m_clock;
+std::atomic<bool> CM_Trace::m_capturing(false);
+std::atomic<unsigned int> CM_Trace::m_capture(0);
+unsigned int CM_Trace::m_mainThread = 0;
+std::string CM_Trace::m_filePath;
+std::vector<std::unique_ptr<CM_Trace::ThreadBuffer>> CM_Trace::m_buffers;
+CM_ThreadMutex CM_Trace::m_mutex;
+thread_local CM_Trace::ThreadBuffer *CM_Trace::m_threadBuffer = nullptr;
+
+CM_Trace::Chunk::Chunk() : m_size(0), m_next(nullptr)
+{
+}
+
+CM_Trace::ThreadBuffer::ThreadBuffer(unsigned int id)
+    : m_id(id), m_capture(0), m_first(nullptr), m_last(nullptr), m_numChunks(0), m_dropped(0)
+{
+}
+
+CM_Trace::ThreadBuffer::~ThreadBuffer()
+{
+  Reset(0);
+}
+
+void CM_Trace::ThreadBuffer::Reset(unsigned int capture)
+{
+  Chunk *chunk = m_first.load(std::memory_order_relaxed);
+  while (chunk) {
+    Chunk *next = chunk->m_next.load(std::memory_order_relaxed);
+    delete chunk;
+    chunk = next;
+  }
+
+  m_last = nullptr;
+  m_numChunks = 0;
+  m_dropped.store(0, std::memory_order_relaxed);
+  m_first.store(nullptr, std::memory_order_relaxed);
+  // Publish the empty buffer before the capture index read by the writer of the file.
+  m_capture.store(capture, std::memory_order_release);
+}
+
+CM_Trace::ThreadBuffer *CM_Trace::GetThreadBuffer()
+{
+  if (!m_threadBuffer) {
+    m_mutex.Lock();
+    m_buffers.emplace_back(new ThreadBuffer(m_buffers.size() + 1));
+    m_threadBuffer = m_buffers.back().get();
+    m_mutex.Unlock();
+  }
+
+  // The buffers are reset by their own thread at the first event of a new capture.
+  const unsigned int capture = m_capture.load(std::memory_order_acquire);
+  if (m_threadBuffer->m_capture.load(std::memory_order_relaxed) != capture) {
+    m_threadBuffer->Reset(capture);
+  }
+
+  return m_threadBuffer;
+}
+
+bool CM_Trace::Start(const std::string &filePath)
+{
+  if (IsCapturing()) {
+    return false;
+  }
+
+  m_filePath = filePath;
+  m_capture.fetch_add(1, std::memory_order_release);
+  m_mainThread = GetThreadBuffer()->m_id;
+  m_capturing.store(true, std::memory_order_release);
+
+  return true;
+}
+
+bool CM_Trace::Stop()
+{
+  if (!IsCapturing()) {
+    return false;
+  }
+
+  m_capturing.store(false, std::memory_order_release);
+
+  return WriteFile();
+}
+
+const std::string &CM_Trace::GetFilePath()
+{
+  return m_filePath;
+}
+
+CM_Clock::Rep CM_Trace::GetTime()
+{
+  return m_clock.GetTimeNano();
+}
+
+void CM_Trace::AddZone(const char *name, CM_Clock::Rep start, CM_Clock::Rep end)
+{
+  // The zone ended after the capture.
+  if (!IsCapturing()) {
+    return;
+  }
+
+  ThreadBuffer *buffer = GetThreadBuffer();
+
+  Chunk *chunk = buffer->m_last;
+  unsigned int size = chunk ? chunk->m_size.load(std::memory_order_relaxed) : CHUNK_SIZE;
+  if (size == CHUNK_SIZE) {
+    if (buffer->m_numChunks == MAX_CHUNKS) {
+      buffer->m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    Chunk *next = new Chunk();
+    if (chunk) {
+      chunk->m_next.store(next, std::memory_order_release);
+    }
+    else {
+      buffer->m_first.store(next, std::memory_order_release);
+    }
+    buffer->m_last = chunk = next;
+    ++buffer->m_numChunks;
+    size = 0;
+  }
+
+  Event &event = chunk->m_events[size];
+  event.m_start = start;
+  event.m_duration = end - start;
+  strncpy(event.m_name, name, MAX_NAME_LENGTH);
+  event.m_name[MAX_NAME_LENGTH] = '\0';
+
+  // Publish the event to the writer of the file.
+  chunk->m_size.store(size + 1, std::memory_order_release);
+}
+
+/// Write a time in nanoseconds as microseconds, the unit of the trace format.
+static void write_time(std::ofstream &file, CM_Clock::Rep time)
+{
+  char str[32];
+  snprintf(str, sizeof(str), "%lld.%03lld", (long long)(time / 1000), (long long)(time % 1000));
+  file << str;
+}
+
+static void write_string(std::ofstream &file, const char *str)
+{
+  file << '"';
+  for (const char *c = str; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      file << '\\' << *c;
+    }
+    else if ((unsigned char)*c < 0x20) {
+      file << ' ';
+    }
+    else {
+      file << *c;
+    }
+  }
+  file << '"';
+}
+
+bool CM_Trace::WriteFile()
+{
+  std::ofstream file(m_filePath, std::ios::trunc);
+  if (!file) {
+    CM_Error("can't write trace file \"" << m_filePath << "\"");
+    return false;
+  }
+
+  const unsigned int capture = m_capture.load(std::memory_order_relaxed);
+  unsigned int numEvents = 0;
+  unsigned int numDropped = 0;
+
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  m_mutex.Lock();
+
+  bool first = true;
+  for (const std::unique_ptr<ThreadBuffer> &buffer : m_buffers) {
+    if (buffer->m_capture.load(std::memory_order_acquire) != capture) {
+      continue;
+    }
+
+    file << (first ? "\n" : ",\n");
+    first = false;
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->m_id
+         << ",\"args\":{\"name\":\"";
+    if (buffer->m_id == m_mainThread) {
+      file << "Main";
+    }
+    else {
+      file << "Thread " << buffer->m_id;
+    }
+    file << "\"}}";
+
+    for (Chunk *chunk = buffer->m_first.load(std::memory_order_acquire); chunk;
+         chunk = chunk->m_next.load(std::memory_order_acquire))
+    {
+      const unsigned int size = chunk->m_size.load(std::memory_order_acquire);
+      for (unsigned int i = 0; i < size; ++i) {
+        const Event &event = chunk->m_events[i];
+        file << ",\n{\"name\":";
+        write_string(file, event.m_name);
+        file << ",\"cat\":\"bge\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->m_id << ",\"ts\":";
+        write_time(file, event.m_start);
+        file << ",\"dur\":";
+        write_time(file, event.m_duration);
+        file << "}";
+      }
+      numEvents += size;
+    }
+
+    numDropped += buffer->m_dropped.load(std::memory_order_relaxed);
+  }
+
+  m_mutex.Unlock();
+
+  file << "\n]}\n";
+  file.close();
+
+  if (!file) {
+    CM_Error("can't write trace file \"" << m_filePath << "\"");
+    return false;
+  }
+
+  CM_Message("Trace written to \"" << m_filePath << "\": " << numEvents << " events");
+  if (numDropped > 0) {
+    CM_Warning("trace buffers full, " << numDropped << " events dropped");
+  }
+
+  return true;
+}
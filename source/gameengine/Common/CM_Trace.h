@@ -0,0 +1,147 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_Trace.h
+ *  \ingroup common
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CM_Clock.h"
+#include "CM_Thread.h"
+
+/** Timeline capture of the engine frames, written in the Chrome trace event format.
+ *
+ * Each thread records its zones in its own buffer of event chunks, an event is published by
+ * incrementing the chunk size so the recording never locks. The buffers are read when the
+ * capture is stopped to write the trace file, readable by the Chrome tracing and Perfetto
+ * viewers.
+ */
+class CM_Trace {
+ public:
+  /// Maximum length of a zone name, longer names are truncated.
+  static constexpr unsigned int MAX_NAME_LENGTH = 47;
+  /// Number of events per chunk.
+  static constexpr unsigned int CHUNK_SIZE = 4096;
+  /// Maximum number of chunks per thread and capture, the events over are dropped.
+  static constexpr unsigned int MAX_CHUNKS = 256;
+
+ private:
+  struct Event {
+    CM_Clock::Rep m_start;
+    CM_Clock::Rep m_duration;
+    char m_name[MAX_NAME_LENGTH + 1];
+  };
+
+  struct Chunk {
+    Event m_events[CHUNK_SIZE];
+    /// Number of events written, stored after the event.
+    std::atomic<unsigned int> m_size;
+    std::atomic<Chunk *> m_next;
+
+    Chunk();
+  };
+
+  struct ThreadBuffer {
+    unsigned int m_id;
+    /// Capture of the events in the chunks.
+    std::atomic<unsigned int> m_capture;
+    std::atomic<Chunk *> m_first;
+    /// Chunk written, only used by the owner thread.
+    Chunk *m_last;
+    unsigned int m_numChunks;
+    /// Number of events dropped because the buffer is full.
+    std::atomic<unsigned int> m_dropped;
+
+    ThreadBuffer(unsigned int id);
+    ~ThreadBuffer();
+
+    /// Free the chunks and start recording a new capture.
+    void Reset(unsigned int capture);
+  };
+
+  static CM_Clock m_clock;
+  static std::atomic<bool> m_capturing;
+  /// Index of the running or last capture.
+  static std::atomic<unsigned int> m_capture;
+  /// Thread which started the capture.
+  static unsigned int m_mainThread;
+  static std::string m_filePath;
+  /// Buffers of all the threads which recorded events, protected by m_mutex.
+  static std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+  static CM_ThreadMutex m_mutex;
+  static thread_local ThreadBuffer *m_threadBuffer;
+
+  /// Return the buffer of the calling thread, ready for the running capture.
+  static ThreadBuffer *GetThreadBuffer();
+
+  static bool WriteFile();
+
+ public:
+  static inline bool IsCapturing()
+  {
+    return m_capturing.load(std::memory_order_relaxed);
+  }
+
+  /** Start a capture written to a file when stopped.
+   * \return False if a capture is already running.
+   */
+  static bool Start(const std::string &filePath);
+  /** Stop the running capture and write its file.
+   * \return False if no capture is running or the file can't be written.
+   */
+  static bool Stop();
+  static const std::string &GetFilePath();
+
+  /// Return the current time of the capture clock.
+  static CM_Clock::Rep GetTime();
+  /// Record a zone in the buffer of the calling thread.
+  static void AddZone(const char *name, CM_Clock::Rep start, CM_Clock::Rep end);
+};
+
+/// Zone recorded from its construction to its destruction when a capture is running.
+class CM_TraceZone {
+ private:
+  const char *m_name;
+  CM_Clock::Rep m_start;
+
+ public:
+  explicit CM_TraceZone(const char *name)
+      : m_name(CM_Trace::IsCapturing() ? name : nullptr), m_start(0)
+  {
+    if (m_name) {
+      m_start = CM_Trace::GetTime();
+    }
+  }
+
+  ~CM_TraceZone()
+  {
+    if (m_name) {
+      CM_Trace::AddZone(m_name, m_start, CM_Trace::GetTime());
+    }
+  }
+};
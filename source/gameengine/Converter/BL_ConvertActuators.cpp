@@ -41,6 +41,7 @@
 #endif
 
 /* This little block needed for linking to Blender... */
+#include "BLI_hash.h"
 #include "BLI_math_rotation.h"
 #include "BKE_context.hh"
 #include "BKE_text.h"
@@ -747,8 +748,15 @@ void BL_ConvertActuators(const char *maggiename,
 
         unsigned long seedArg = randAct->seed;
         if (seedArg == 0) {
-          seedArg = (int)(ketsjiEngine->GetRealTime() * 100000.0);
-          seedArg ^= (intptr_t)randAct;
+          if (ketsjiEngine->GetRandomSeed() != 0) {
+            // Reproducible seed, different for each actuator.
+            seedArg = ketsjiEngine->GetRandomSeed() ^ BLI_hash_string(objectname.c_str()) ^
+                      BLI_hash_string(bact->name);
+          }
+          else {
+            seedArg = (int)(ketsjiEngine->GetRealTime() * 100000.0);
+            seedArg ^= (intptr_t)randAct;
+          }
         }
         SCA_RandomActuator::KX_RANDOMACT_MODE modeArg = SCA_RandomActuator::KX_RANDOMACT_NODEF;
         SCA_RandomActuator *tmprandomact;
@@ -35,6 +35,8 @@
 
 #include "BL_Converter.h"
 
+#include <algorithm>
+
 #include "BKE_context.hh"
 #include "BKE_idtype.hh"
 #include "BKE_lib_id.hh"
@@ -49,7 +51,9 @@
 #include "DNA_scene_types.h"
 
 #include "BL_DataConversion.h"
+#include "BL_MeshCache.h"
 #include "BL_SceneConverter.h"
+#include "CM_Trace.h"
 #include "DummyPhysicsEnvironment.h"
 #include "EXP_StringValue.h"
 #include "KX_GameObject.h"
@@ -60,13 +64,32 @@
 #include "SCA_ActionActuator.h"
 
 #ifdef WITH_BULLET
+#  include "CcdBvhCache.h"
 #  include "CcdPhysicsEnvironment.h"
+#  include "CcdShapeCache.h"
 #endif
 
 #ifdef WITH_PYTHON
 #  include "Texture.h"  // For FreeAllTextures.
 #endif                  // WITH_PYTHON
 
+static void merge_stage_times(std::vector<BL_SceneConverter::StageTime> &dst,
+                              const std::vector<BL_SceneConverter::StageTime> &src)
+{
+  for (const BL_SceneConverter::StageTime &stage : src) {
+    const auto it = std::find_if(
+        dst.begin(), dst.end(), [&stage](const BL_SceneConverter::StageTime &other) {
+          return other.m_name == stage.m_name;
+        });
+    if (it == dst.end()) {
+      dst.push_back(stage);
+    }
+    else {
+      it->m_time += stage.m_time;
+    }
+  }
+}
+
 BL_Converter::SceneSlot::SceneSlot() = default;
 
 BL_Converter::SceneSlot::SceneSlot(const BL_SceneConverter *converter)
@@ -88,6 +111,7 @@ void BL_Converter::SceneSlot::Merge(BL_Converter::SceneSlot &other)
                        std::make_move_iterator(other.m_meshobjects.begin()),
                        std::make_move_iterator(other.m_meshobjects.end()));
   m_actionToInterp.insert(other.m_actionToInterp.begin(), other.m_actionToInterp.end());
+  merge_stage_times(m_stageTimes, other.m_stageTimes);
 }
 
 void BL_Converter::SceneSlot::Merge(const BL_SceneConverter *converter)
@@ -98,6 +122,7 @@ void BL_Converter::SceneSlot::Merge(const BL_SceneConverter *converter)
   for (RAS_MeshObject *meshobj : converter->m_meshobjects) {
     m_meshobjects.emplace_back(meshobj);
   }
+  merge_stage_times(m_stageTimes, converter->m_stageTimes);
 }
 
 BL_Converter::BL_Converter(Main *maggie, KX_KetsjiEngine *engine)
@@ -335,8 +360,19 @@ void BL_Converter::AddScenesToMergeQueue(KX_LibLoadStatus *status)
   m_threadinfo.m_mutex.Unlock();
 }
 
+bool BL_Converter::IsLoadFinished(KX_LibLoadStatus *status)
+{
+  m_threadinfo.m_mutex.Lock();
+  const bool finished = status->IsFinished();
+  m_threadinfo.m_mutex.Unlock();
+
+  return finished;
+}
+
 static void async_convert(TaskPool *pool, void *ptr, int /*threadid*/)
 {
+  CM_TraceZone traceZone("AsyncConvert");
+
   KX_Scene *new_scene = nullptr;
   KX_LibLoadStatus *status = (KX_LibLoadStatus *)ptr;
   std::vector<Scene *> *scenes = (std::vector<Scene *> *)status->GetData();
@@ -364,6 +400,7 @@ KX_LibLoadStatus *BL_Converter::LinkBlendFileMemory(void *data,
                                                            int length,
                                                            const char *path,
                                                            char *group,
+                                                           const std::vector<std::string> &names,
                                                            KX_Scene *scene_merge,
                                                            char **err_str,
                                                            short options)
@@ -371,16 +408,21 @@ KX_LibLoadStatus *BL_Converter::LinkBlendFileMemory(void *data,
   BlendHandle *bpy_openlib = BLO_blendhandle_from_memory(data, length, nullptr);
 
   // Error checking is done in LinkBlendFile
-  return LinkBlendFile(bpy_openlib, path, group, scene_merge, err_str, options);
+  return LinkBlendFile(bpy_openlib, path, group, names, scene_merge, err_str, options);
 }
 
-KX_LibLoadStatus *BL_Converter::LinkBlendFilePath(
-    const char *filepath, char *group, KX_Scene *scene_merge, char **err_str, short options)
+KX_LibLoadStatus *BL_Converter::LinkBlendFilePath(const char *filepath,
+                                                  char *group,
+                                                  const std::vector<std::string> &names,
+                                                  KX_Scene *scene_merge,
+                                                  char **err_str,
+                                                  short options)
 {
-  BlendHandle *bpy_openlib = BLO_blendhandle_from_file(filepath, nullptr);
+  BlendFileReadReport bf_reports = {nullptr};
+  BlendHandle *bpy_openlib = BLO_blendhandle_from_file_indexed(filepath, &bf_reports);
 
   // Error checking is done in LinkBlendFile
-  return LinkBlendFile(bpy_openlib, filepath, group, scene_merge, err_str, options);
+  return LinkBlendFile(bpy_openlib, filepath, group, names, scene_merge, err_str, options);
 }
 
 static void load_datablocks(Main *main_tmp, BlendHandle *bpy_openlib, const char *path, int idcode)
@@ -401,9 +443,26 @@ static void load_datablocks(Main *main_tmp, BlendHandle *bpy_openlib, const char
   BLI_linklist_free(names, free);  // free linklist *and* each node's data
 }
 
+/// Link only the named data-blocks, found by name without listing all the data-blocks of the type.
+static void load_named_datablocks(Main *main_tmp,
+                                  BlendHandle *bpy_openlib,
+                                  const char *path,
+                                  int idcode,
+                                  const std::vector<std::string> &names)
+{
+  for (const std::string &name : names) {
+    struct LibraryLink_Params liblink_params;
+    if (!BLO_library_link_named_part(
+            main_tmp, &bpy_openlib, idcode, name.c_str(), &liblink_params)) {
+      CM_Warning("data-block \"" << name << "\" not found in library \"" << path << "\"");
+    }
+  }
+}
+
 KX_LibLoadStatus *BL_Converter::LinkBlendFile(BlendHandle *bpy_openlib,
                                                      const char *path,
                                                      char *group,
+                                                     const std::vector<std::string> &names,
                                                      KX_Scene *scene_merge,
                                                      char **err_str,
                                                      short options)
@@ -444,7 +503,12 @@ KX_LibLoadStatus *BL_Converter::LinkBlendFile(BlendHandle *bpy_openlib,
   struct LibraryLink_Params liblink_params;
   Main *main_tmp = BLO_library_link_begin(&bpy_openlib, (char *)path, &liblink_params);
 
-  load_datablocks(main_tmp, bpy_openlib, path, idcode);
+  if (names.empty()) {
+    load_datablocks(main_tmp, bpy_openlib, path, idcode);
+  }
+  else {
+    load_named_datablocks(main_tmp, bpy_openlib, path, idcode, names);
+  }
 
   if (idcode == ID_SCE && options & LIB_LOAD_LOAD_SCRIPTS) {
     load_datablocks(main_tmp, bpy_openlib, path, ID_TXT);
@@ -572,11 +636,7 @@ bool BL_Converter::FreeBlendFile(Main *maggie)
 
   // If the given library is currently in loading, we do nothing.
   if (m_status_map.count(maggie->filepath)) {
-    m_threadinfo.m_mutex.Lock();
-    const bool finished = m_status_map[maggie->filepath]->IsFinished();
-    m_threadinfo.m_mutex.Unlock();
-
-    if (!finished) {
+    if (!IsLoadFinished(m_status_map[maggie->filepath])) {
       CM_Error("Library (" << maggie->filepath
                            << ") is currently being loaded asynchronously, and cannot be freed "
                               "until this process is done");
@@ -890,6 +950,9 @@ void BL_Converter::PrintStats()
         CM_Message("\t\t materials: " << sceneSlot.m_materials.size());
     CM_Message("\t\t meshes: " << sceneSlot.m_meshobjects.size());
     CM_Message("\t\t interpolators: " << sceneSlot.m_interpolators.size());
+    for (const BL_SceneConverter::StageTime &stage : sceneSlot.m_stageTimes) {
+      CM_Message("\t\t conversion " << stage.m_name << ": " << stage.m_time * 1000.0 << " ms");
+    }
   }
 
   CM_Message(std::endl << "Total:");
@@ -897,4 +960,14 @@ void BL_Converter::PrintStats()
   CM_Message("\t materials: " << nummat);
   CM_Message("\t meshes: " << nummesh);
   CM_Message("\t interpolators: " << numinter);
+
+  if (BL_MeshCache::IsEnabled()) {
+    BL_MeshCache::PrintStats();
+  }
+#ifdef WITH_BULLET
+  if (CcdBvhCache::IsEnabled()) {
+    CcdBvhCache::PrintStats();
+  }
+  CcdShapeCache::PrintStats();
+#endif
 }
@@ -32,16 +32,17 @@
 #pragma once
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include "BL_ScalarInterpolator.h"
+#include "BL_SceneConverter.h"
 #include "CM_Thread.h"
 #include "EXP_ListValue.h"
 #include "KX_BlenderMaterial.h"
 #include "RAS_MeshObject.h"
 
 class EXP_StringValue;
-class BL_SceneConverter;
 class KX_KetsjiEngine;
 class KX_LibLoadStatus;
 class KX_BlenderMaterial;
@@ -66,6 +67,9 @@ class BL_Converter {
 
     std::map<bAction *, BL_InterpolatorList *> m_actionToInterp;
 
+    /// Accumulated duration of the conversion stages, libloads included.
+    std::vector<BL_SceneConverter::StageTime> m_stageTimes;
+
     SceneSlot();
     SceneSlot(const BL_SceneConverter *converter);
     ~SceneSlot();
@@ -124,14 +128,24 @@ class BL_Converter {
                                         int length,
                                         const char *path,
                                         char *group,
+                                        const std::vector<std::string> &names,
                                         KX_Scene *scene_merge,
                                         char **err_str,
                                         short options);
-  KX_LibLoadStatus *LinkBlendFilePath(
-      const char *path, char *group, KX_Scene *scene_merge, char **err_str, short options);
+  /// The headers of the blocks of the file are indexed next to it to link named data-blocks.
+  KX_LibLoadStatus *LinkBlendFilePath(const char *path,
+                                      char *group,
+                                      const std::vector<std::string> &names,
+                                      KX_Scene *scene_merge,
+                                      char **err_str,
+                                      short options);
+  /** \param names The names of the data-blocks of the group to link, all of them when empty.
+   * The data-blocks they use are linked too.
+   */
   KX_LibLoadStatus *LinkBlendFile(BlendHandle *bpy_openlib,
                                   const char *path,
                                   char *group,
+                                  const std::vector<std::string> &names,
                                   KX_Scene *scene_merge,
                                   char **err_str,
                                   short options);
@@ -146,6 +160,8 @@ class BL_Converter {
   void MergeAsyncLoads();
   void FinalizeAsyncLoads();
   void AddScenesToMergeQueue(KX_LibLoadStatus *status);
+  /// Return true when the load of status is finished, under the lock of the merge queue.
+  bool IsLoadFinished(KX_LibLoadStatus *status);
 
   void PrintStats();
 
@@ -70,6 +70,7 @@
 #include "BKE_modifier.hh"
 #include "BKE_object.hh"
 #include "BKE_scene.hh"
+#include "BLI_task.h"
 #include "DEG_depsgraph_query.hh"
 #include "DNA_actuator_types.h"
 #include "DNA_meshdata_types.h"
@@ -84,12 +85,15 @@
 #include "BL_ConvertControllers.h"
 #include "BL_ConvertProperties.h"
 #include "BL_ConvertSensors.h"
+#include "BL_MeshCache.h"
+#include "CM_Clock.h"
 #include "KX_BlenderMaterial.h"
 #include "KX_BoneParentNodeRelationship.h"
 #include "KX_Camera.h"
 #include "KX_ClientObjectInfo.h"
 #include "KX_EmptyObject.h"
 #include "KX_FontObject.h"
+#include "KX_KetsjiEngine.h"
 #include "KX_Light.h"
 #include "KX_LodManager.h"
 #include "KX_MotionState.h"
@@ -101,6 +105,7 @@
 #include "RAS_ICanvas.h"
 #include "RAS_Vertex.h"
 #ifdef WITH_BULLET
+#  include "CcdBvhCache.h"
 #  include "CcdPhysicsEnvironment.h"
 #endif
 
@@ -350,34 +355,22 @@ static int GetPolygonMaterialIndex(const VArray<int> mat_indices, const Mesh *me
   return r;
 }
 
-/* blenderobj can be nullptr, make sure its checked for */
-RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
-                               Object *blenderobj,
-                               KX_Scene *scene,
-                               RAS_Rasterizer *rasty,
-                               BL_SceneConverter *converter,
-                               bool libloading,
-                               bool converting_during_runtime)
-{
-  RAS_MeshObject *meshobj;
-  int lightlayer = blenderobj ? blenderobj->lay : (1 << 20) - 1;  // all layers if no object.
-
-  // Without checking names, we get some reuse we don't want that can cause
-  // problems with material LoDs.
-  if (blenderobj && ((meshobj = converter->FindGameMesh(mesh /*, ob->lay*/)) != nullptr)) {
-    const std::string bge_name = meshobj->GetName();
-    const std::string blender_name = ((ID *)blenderobj->data)->name + 2;
-    if (bge_name == blender_name) {
-      return meshobj;
-    }
-  }
-
-  // Get Mesh data
-  bContext *C = KX_GetActiveEngine()->GetContext();
-  Depsgraph *depsgraph = CTX_data_depsgraph_on_load(C);
-  Object *ob_eval = DEG_get_evaluated_object(depsgraph, blenderobj);
-  Mesh *final_me = (Mesh *)ob_eval->data;
+struct ConvertedMaterial {
+  Material *ma;
+  RAS_MeshMaterial *meshmat;
+  bool visible;
+  bool twoside;
+  bool collider;
+  bool wire;
+};
 
+/// Convert the vertices and polygons of an evaluated mesh in the materials of a mesh object.
+static void BL_ConvertMeshPolygons(Mesh *final_me,
+                                   RAS_MeshObject *meshobj,
+                                   const std::vector<ConvertedMaterial> &convertedMats,
+                                   unsigned short uvLayers,
+                                   unsigned short colorLayers)
+{
   BKE_mesh_tessface_ensure(final_me);
 
   const blender::Span<blender::float3> positions = final_me->vert_positions();
@@ -387,37 +380,6 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
   const int totfaces = final_me->totface_legacy;
   const int *mfaceToMpoly = (int *)CustomData_get_layer(&final_me->fdata_legacy, CD_ORIGINDEX);
 
-  /* Extract available layers.
-   * Get the active color and uv layer. */
-  const short activeUv = CustomData_get_active_layer(&final_me->corner_data, CD_PROP_FLOAT2);
-  const short activeColor = CustomData_get_active_layer(&final_me->corner_data,
-                                                        CD_PROP_BYTE_COLOR);
-
-  RAS_MeshObject::LayersInfo layersInfo;
-  layersInfo.activeUv = (activeUv == -1) ? 0 : activeUv;
-  layersInfo.activeColor = (activeColor == -1) ? 0 : activeColor;
-
-  const unsigned short uvLayers = CustomData_number_of_layers(&final_me->corner_data,
-                                                              CD_PROP_FLOAT2);
-  const unsigned short colorLayers = CustomData_number_of_layers(&final_me->corner_data,
-                                                                 CD_PROP_BYTE_COLOR);
-
-  // Extract UV loops.
-  for (unsigned short i = 0; i < uvLayers; ++i) {
-    const std::string name = CustomData_get_layer_name(&final_me->corner_data, CD_PROP_FLOAT2, i);
-    const float(*uv)[2] = (const float(*)[2])CustomData_get_layer_n(
-        &final_me->corner_data, CD_PROP_FLOAT2, i);
-    layersInfo.layers.push_back({uv, nullptr, i, name});
-  }
-  // Extract color loops.
-  for (unsigned short i = 0; i < colorLayers; ++i) {
-    const std::string name = CustomData_get_layer_name(
-        &final_me->corner_data, CD_PROP_BYTE_COLOR, i);
-    MLoopCol *col = (MLoopCol *)CustomData_get_layer_n(
-        &final_me->corner_data, CD_PROP_BYTE_COLOR, i);
-    layersInfo.layers.push_back({nullptr, col, i, name});
-  }
-
   blender::Span<float3> loop_nors_dst;
   float(*loop_normals)[3] = (float(*)[3])CustomData_get_layer(&final_me->corner_data, CD_NORMAL);
   const bool do_loop_nors = (loop_normals == nullptr);
@@ -458,51 +420,7 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
     tangent = (float(*)[4])CustomData_get_layer(&final_me->corner_data, CD_TANGENT);
   }
 
-  meshobj = new RAS_MeshObject(mesh, final_me->verts_num, blenderobj, layersInfo);
-  meshobj->m_sharedvertex_map.resize(totverts);
-
-  // Initialize vertex format with used uv and color layers.
-  RAS_VertexFormat vertformat;
-  vertformat.uvSize = max_ii(1, uvLayers);
-  vertformat.colorSize = max_ii(1, colorLayers);
-
-  struct ConvertedMaterial {
-    Material *ma;
-    RAS_MeshMaterial *meshmat;
-    bool visible;
-    bool twoside;
-    bool collider;
-    bool wire;
-  };
-
-  const unsigned short totmat = max_ii(final_me->totcol, 1);
-  std::vector<ConvertedMaterial> convertedMats(totmat);
-
-  // Convert all the materials contained in the mesh.
-  for (unsigned short i = 0; i < totmat; ++i) {
-    Material *ma = nullptr;
-    if (blenderobj) {
-      ma = BKE_object_material_get(ob_eval, i + 1);
-    }
-    else {
-      ma = final_me->mat ? final_me->mat[i] : nullptr;
-    }
-    // Check for blender material
-    if (!ma) {
-      ma = BKE_material_default_empty();
-    }
-
-    RAS_MaterialBucket *bucket = BL_material_from_mesh(
-        ma, lightlayer, scene, rasty, converter, converting_during_runtime);
-    RAS_MeshMaterial *meshmat = meshobj->AddMaterial(bucket, i, vertformat);
-
-    convertedMats[i] = {ma,
-                        meshmat,
-                        ((ma->game.flag & GEMAT_INVISIBLE) == 0),
-                        ((ma->game.flag & GEMAT_BACKCULL) == 0),
-                        ((ma->game.flag & GEMAT_NOPHYSICS) == 0),
-                        bucket->IsWire()};
-  }
+  const RAS_MeshObject::LayersInfo &layersInfo = meshobj->GetLayersInfo();
 
   std::vector<std::vector<unsigned int>> mpolyToMface(final_me->faces().size());
   // Generate a list of all mfaces wrapped by a mpoly.
@@ -577,7 +495,42 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
       meshobj->AddPolygon(meshmat, nverts, indices, mat.visible, mat.collider, mat.twoside);
     }
   }
+}
+
+/// Convert the geometry of a mesh object, from the mesh cache when enabled.
+static void BL_ConvertMeshGeometry(Mesh *final_me,
+                                   RAS_MeshObject *meshobj,
+                                   const RAS_VertexFormat &vertformat,
+                                   const std::vector<ConvertedMaterial> &convertedMats,
+                                   unsigned short uvLayers,
+                                   unsigned short colorLayers)
+{
+  if (BL_MeshCache::IsEnabled()) {
+    const unsigned short totmat = convertedMats.size();
+    std::vector<unsigned short> materialFlags(totmat);
+    for (unsigned short i = 0; i < totmat; ++i) {
+      const ConvertedMaterial &mat = convertedMats[i];
+      materialFlags[i] = (mat.visible ? BL_MeshCache::MATERIAL_VISIBLE : 0) |
+                         (mat.twoside ? BL_MeshCache::MATERIAL_TWOSIDE : 0) |
+                         (mat.collider ? BL_MeshCache::MATERIAL_COLLIDER : 0) |
+                         (mat.wire ? BL_MeshCache::MATERIAL_WIRE : 0);
+    }
+
+    // Skip the tessellation, the tangents computation and the vertices sharing for cached meshes.
+    const BL_MeshCache::Key key = BL_MeshCache::ComputeKey(final_me, vertformat, materialFlags);
+    if (!BL_MeshCache::Load(key, meshobj)) {
+      BL_ConvertMeshPolygons(final_me, meshobj, convertedMats, uvLayers, colorLayers);
+      BL_MeshCache::Store(key, meshobj);
+    }
+  }
+  else {
+    BL_ConvertMeshPolygons(final_me, meshobj, convertedMats, uvLayers, colorLayers);
+  }
+}
 
+/// Create the display arrays of a converted mesh object and finalize its materials.
+static void BL_FinalizeMesh(RAS_MeshObject *meshobj, bool libloading)
+{
   // keep meshobj->m_sharedvertex_map for reinstance phys mesh.
   // 2.49a and before it did: meshobj->m_sharedvertex_map.clear();
   // but this didnt save much ram. - Campbell
@@ -592,6 +545,155 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
       mmat->GetBucket()->GetPolyMaterial()->OnConstruction();
     }
   }
+}
+
+static void convert_deferred_meshes_task(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  std::vector<BL_SceneConverter::DeferredMesh *> *meshes =
+      (std::vector<BL_SceneConverter::DeferredMesh *> *)taskdata;
+  for (BL_SceneConverter::DeferredMesh *mesh : *meshes) {
+    mesh->m_convert();
+  }
+}
+
+/** Convert the geometry of the deferred meshes in parallel and finalize them.
+ * Conversions modifying the same evaluated mesh (tessellation, tangents) are run in the same task.
+ */
+static void BL_ConvertDeferredMeshes(BL_SceneConverter *converter)
+{
+  std::vector<BL_SceneConverter::DeferredMesh> meshes = converter->TakeDeferredMeshes();
+  if (meshes.empty()) {
+    return;
+  }
+
+  std::map<Mesh *, std::vector<BL_SceneConverter::DeferredMesh *>> groups;
+  for (BL_SceneConverter::DeferredMesh &mesh : meshes) {
+    groups[mesh.m_mesh].push_back(&mesh);
+  }
+
+  TaskPool *pool = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
+  for (auto &pair : groups) {
+    BLI_task_pool_push(pool, convert_deferred_meshes_task, &pair.second, false, nullptr);
+  }
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
+
+  // The display arrays and materials may use GPU resources, they are finalized on this thread.
+  for (const BL_SceneConverter::DeferredMesh &mesh : meshes) {
+    BL_FinalizeMesh(mesh.m_meshobj, mesh.m_libloading);
+  }
+}
+
+/* blenderobj can be nullptr, make sure its checked for */
+RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
+                               Object *blenderobj,
+                               KX_Scene *scene,
+                               RAS_Rasterizer *rasty,
+                               BL_SceneConverter *converter,
+                               bool libloading,
+                               bool converting_during_runtime)
+{
+  RAS_MeshObject *meshobj;
+  int lightlayer = blenderobj ? blenderobj->lay : (1 << 20) - 1;  // all layers if no object.
+
+  // Without checking names, we get some reuse we don't want that can cause
+  // problems with material LoDs.
+  if (blenderobj && ((meshobj = converter->FindGameMesh(mesh /*, ob->lay*/)) != nullptr)) {
+    const std::string bge_name = meshobj->GetName();
+    const std::string blender_name = ((ID *)blenderobj->data)->name + 2;
+    if (bge_name == blender_name) {
+      return meshobj;
+    }
+  }
+
+  // Get Mesh data
+  bContext *C = KX_GetActiveEngine()->GetContext();
+  Depsgraph *depsgraph = CTX_data_depsgraph_on_load(C);
+  Object *ob_eval = DEG_get_evaluated_object(depsgraph, blenderobj);
+  Mesh *final_me = (Mesh *)ob_eval->data;
+
+  /* Extract available layers.
+   * Get the active color and uv layer. */
+  const short activeUv = CustomData_get_active_layer(&final_me->corner_data, CD_PROP_FLOAT2);
+  const short activeColor = CustomData_get_active_layer(&final_me->corner_data,
+                                                        CD_PROP_BYTE_COLOR);
+
+  RAS_MeshObject::LayersInfo layersInfo;
+  layersInfo.activeUv = (activeUv == -1) ? 0 : activeUv;
+  layersInfo.activeColor = (activeColor == -1) ? 0 : activeColor;
+
+  const unsigned short uvLayers = CustomData_number_of_layers(&final_me->corner_data,
+                                                              CD_PROP_FLOAT2);
+  const unsigned short colorLayers = CustomData_number_of_layers(&final_me->corner_data,
+                                                                 CD_PROP_BYTE_COLOR);
+
+  // Extract UV loops.
+  for (unsigned short i = 0; i < uvLayers; ++i) {
+    const std::string name = CustomData_get_layer_name(&final_me->corner_data, CD_PROP_FLOAT2, i);
+    const float(*uv)[2] = (const float(*)[2])CustomData_get_layer_n(
+        &final_me->corner_data, CD_PROP_FLOAT2, i);
+    layersInfo.layers.push_back({uv, nullptr, i, name});
+  }
+  // Extract color loops.
+  for (unsigned short i = 0; i < colorLayers; ++i) {
+    const std::string name = CustomData_get_layer_name(
+        &final_me->corner_data, CD_PROP_BYTE_COLOR, i);
+    MLoopCol *col = (MLoopCol *)CustomData_get_layer_n(
+        &final_me->corner_data, CD_PROP_BYTE_COLOR, i);
+    layersInfo.layers.push_back({nullptr, col, i, name});
+  }
+
+  meshobj = new RAS_MeshObject(mesh, final_me->verts_num, blenderobj, layersInfo);
+  meshobj->m_sharedvertex_map.resize(final_me->verts_num);
+
+  // Initialize vertex format with used uv and color layers.
+  RAS_VertexFormat vertformat;
+  vertformat.uvSize = max_ii(1, uvLayers);
+  vertformat.colorSize = max_ii(1, colorLayers);
+
+  const unsigned short totmat = max_ii(final_me->totcol, 1);
+  std::vector<ConvertedMaterial> convertedMats(totmat);
+
+  // Convert all the materials contained in the mesh.
+  for (unsigned short i = 0; i < totmat; ++i) {
+    Material *ma = nullptr;
+    if (blenderobj) {
+      ma = BKE_object_material_get(ob_eval, i + 1);
+    }
+    else {
+      ma = final_me->mat ? final_me->mat[i] : nullptr;
+    }
+    // Check for blender material
+    if (!ma) {
+      ma = BKE_material_default_empty();
+    }
+
+    RAS_MaterialBucket *bucket = BL_material_from_mesh(
+        ma, lightlayer, scene, rasty, converter, converting_during_runtime);
+    RAS_MeshMaterial *meshmat = meshobj->AddMaterial(bucket, i, vertformat);
+
+    convertedMats[i] = {ma,
+                        meshmat,
+                        ((ma->game.flag & GEMAT_INVISIBLE) == 0),
+                        ((ma->game.flag & GEMAT_BACKCULL) == 0),
+                        ((ma->game.flag & GEMAT_NOPHYSICS) == 0),
+                        bucket->IsWire()};
+  }
+
+  if (converter->GetDeferMeshes()) {
+    // The geometry is converted in parallel with the other meshes of the scene.
+    converter->DeferMesh({meshobj,
+                          final_me,
+                          [=]() {
+                            BL_ConvertMeshGeometry(
+                                final_me, meshobj, vertformat, convertedMats, uvLayers, colorLayers);
+                          },
+                          libloading});
+  }
+  else {
+    BL_ConvertMeshGeometry(final_me, meshobj, vertformat, convertedMats, uvLayers, colorLayers);
+    BL_FinalizeMesh(meshobj, libloading);
+  }
 
   converter->RegisterGameMesh(meshobj, mesh);
   return meshobj;
@@ -1220,6 +1322,7 @@ static void bl_ConvertBlenderObject_Single(BL_SceneConverter *converter,
 
   if (isInActiveLayer) {
     objectlist->Add(CM_AddRef(gameobj));
+    kxscene->GetActivityCullingManager().Register(gameobj);
     // tf.Add(gameobj->GetSGNode());
 
     gameobj->NodeUpdateGS(0);
@@ -1366,6 +1469,23 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
   bool converting_during_runtime = single_object != nullptr;
   bool converting_instance_col_at_runtime = single_object && single_object->instance_collection && converter->FindGameObject(single_object) == nullptr;
 
+  /* The stages of full scene conversions are timed, the mesh geometries are converted
+   * in parallel once all the objects are created. */
+  CM_Clock stageClock;
+  const auto endStage = [&stageClock, converter](const std::string &name) {
+    converter->AddStageTime(name, stageClock.GetTimeSecond());
+    stageClock.Reset();
+  };
+
+#ifdef WITH_BULLET
+  const unsigned int bvhCacheHits = CcdBvhCache::GetHits();
+  const unsigned int bvhCacheMisses = CcdBvhCache::GetMisses();
+#endif
+
+  if (!single_object) {
+    converter->SetDeferMeshes(true);
+  }
+
   // Let's support scene set.
   // Beware of name conflict in linked data, it will not crash but will create confusion
   // in Python scripting and in certain actuators (replace mesh). Linked scene *should* have
@@ -1483,6 +1603,13 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
     }
   }
 
+  if (!single_object) {
+    endStage("objects");
+    BL_ConvertDeferredMeshes(converter);
+    converter->SetDeferMeshes(false);
+    endStage("meshes");
+  }
+
   // non-camera objects not supported as camera currently
   if (blenderscene->camera && blenderscene->camera->type == OB_CAMERA &&
       CTX_wm_region_view3d(KX_GetActiveEngine()->GetContext())->persp == RV3D_CAMOB) {
@@ -1609,6 +1736,18 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
       kxscene->GetPhysicsEnvironment()->SetNumTimeSubSteps(blenderscene->gm.physubstep);
   }
 
+  if (!single_object) {
+    endStage("hierarchy");
+
+    // Build the shared triangle mesh shapes in parallel before creating the physics objects.
+    std::vector<KX_GameObject *> physicsObjects;
+    for (KX_GameObject *gameobj : sumolist) {
+      physicsObjects.push_back(gameobj);
+    }
+    kxscene->GetPhysicsEnvironment()->PrepareMeshShapes(kxscene, physicsObjects);
+    endStage("physics shapes");
+  }
+
   // Create physics information.
   for (unsigned short i = 0; i < 2; ++i) {
     const bool processCompoundChildren = (i == 1);
@@ -1633,6 +1772,11 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
     }
   }
 
+  if (!single_object) {
+    kxscene->GetPhysicsEnvironment()->ClearPreparedMeshShapes();
+    endStage("physics objects");
+  }
+
   // create physics joints
   for (KX_GameObject *gameobj : sumolist) {
     PHY_IPhysicsEnvironment *physEnv = kxscene->GetPhysicsEnvironment();
@@ -1866,4 +2010,23 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
       }
     }
   }
+
+  if (!single_object) {
+    endStage("logic");
+
+    if (ketsjiEngine->GetFlag(KX_KetsjiEngine::SHOW_PROFILE)) {
+      CM_Message("Scene " << kxscene->GetName() << " conversion:");
+      for (const BL_SceneConverter::StageTime &stage : converter->GetStageTimes()) {
+        CM_Message("\t" << stage.m_name << ": " << stage.m_time * 1000.0 << " ms");
+      }
+#ifdef WITH_BULLET
+      if (CcdBvhCache::IsEnabled()) {
+        CM_Message("\tcollision BVH cache: " << (CcdBvhCache::GetHits() - bvhCacheHits)
+                                             << " loaded, "
+                                             << (CcdBvhCache::GetMisses() - bvhCacheMisses)
+                                             << " built");
+      }
+#endif
+    }
+  }
 }
@@ -0,0 +1,503 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Converter/BL_MeshCache.cpp
+ *  \ingroup bgeconv
+ */
+
+#include "BL_MeshCache.h"
+
+#include <cstring>
+#include <fcntl.h>
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#include <xxhash.h>
+
+#include "BKE_appdir.hh"
+#include "BKE_customdata.hh"
+#include "BKE_mesh.hh"
+#include "BLI_fileops.h"
+#include "BLI_mmap.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "DNA_mesh_types.h"
+
+#include "CM_Message.h"
+#include "RAS_IDisplayArray.h"
+#include "RAS_MeshObject.h"
+#include "RAS_Polygon.h"
+
+/// Increase when the conversion or the file layout changes to invalidate old entries.
+static const unsigned int MESH_CACHE_VERSION = 1;
+static const char MESH_CACHE_MAGIC[8] = {'B', 'G', 'E', 'M', 'E', 'S', 'H', '\0'};
+
+/// All the data of a cache file are 4 bytes sized for direct access in the mapped memory.
+struct MeshCacheHeader {
+  char magic[8];
+  uint64_t key;
+  uint32_t version;
+  uint32_t uvSize;
+  uint32_t colorSize;
+  uint32_t numMaterials;
+  uint32_t numPolygons;
+  uint32_t numOrigVertices;
+};
+
+struct MeshCacheMaterial {
+  uint32_t numVertices;
+  /// Number of line indices, non-zero only for wire materials.
+  uint32_t numLineIndices;
+};
+
+struct MeshCacheVertexInfo {
+  uint32_t origIndex;
+  uint32_t flag;
+};
+
+struct MeshCachePolygon {
+  uint32_t material;
+  uint16_t numVertices;
+  uint16_t flags;
+  uint32_t offsets[4];
+};
+
+bool BL_MeshCache::m_enabled = false;
+std::string BL_MeshCache::m_directory;
+std::atomic<unsigned int> BL_MeshCache::m_hits(0);
+std::atomic<unsigned int> BL_MeshCache::m_misses(0);
+std::atomic<unsigned int> BL_MeshCache::m_stores(0);
+
+/// Number of floats of a cached vertex.
+static unsigned int vertex_float_size(const RAS_VertexFormat &format)
+{
+  // Position, normal, tangent, uvs and colors.
+  return 3 + 3 + 4 + format.uvSize * 2 + format.colorSize;
+}
+
+bool BL_MeshCache::IsEnabled()
+{
+  return m_enabled;
+}
+
+void BL_MeshCache::SetEnabled(bool enabled)
+{
+  m_enabled = enabled;
+  // Resolve the directory before any parallel mesh conversion.
+  if (m_enabled) {
+    GetDirectory();
+  }
+}
+
+const std::string &BL_MeshCache::GetDirectory()
+{
+  if (m_directory.empty()) {
+    char path[FILE_MAX];
+    if (!BKE_appdir_folder_caches(path, sizeof(path))) {
+      BLI_strncpy(path, BKE_tempdir_base(), sizeof(path));
+    }
+    BLI_path_append(path, sizeof(path), "bge_mesh");
+    m_directory = path;
+  }
+  return m_directory;
+}
+
+void BL_MeshCache::SetDirectory(const std::string &directory)
+{
+  m_directory = directory;
+}
+
+std::string BL_MeshCache::GetFilePath(Key key)
+{
+  std::stringstream name;
+  name << std::hex << key << ".bgemesh";
+
+  char path[FILE_MAX];
+  BLI_path_join(path, sizeof(path), GetDirectory().c_str(), name.str().c_str());
+  return path;
+}
+
+static void hash_layers(XXH3_state_t *state,
+                        const CustomData *data,
+                        eCustomDataType type,
+                        unsigned int size)
+{
+  const int num = CustomData_number_of_layers(data, type);
+  XXH3_64bits_update(state, &num, sizeof(num));
+  for (int i = 0; i < num; ++i) {
+    const char *name = CustomData_get_layer_name(data, type, i);
+    XXH3_64bits_update(state, name, strlen(name));
+    const void *layer = CustomData_get_layer_n(data, type, i);
+    if (layer) {
+      XXH3_64bits_update(state, layer, size_t(CustomData_sizeof(type)) * size);
+    }
+  }
+}
+
+static void hash_named_layer(XXH3_state_t *state,
+                             const CustomData *data,
+                             eCustomDataType type,
+                             const char *name,
+                             unsigned int size)
+{
+  const void *layer = CustomData_get_layer_named(data, type, name);
+  const bool exists = (layer != nullptr);
+  XXH3_64bits_update(state, &exists, sizeof(exists));
+  if (exists) {
+    XXH3_64bits_update(state, layer, size_t(CustomData_sizeof(type)) * size);
+  }
+}
+
+template<class T> static void hash_span(XXH3_state_t *state, const blender::Span<T> &span)
+{
+  const size_t size = span.size();
+  XXH3_64bits_update(state, &size, sizeof(size));
+  if (size > 0) {
+    XXH3_64bits_update(state, span.data(), span.size_in_bytes());
+  }
+}
+
+BL_MeshCache::Key BL_MeshCache::ComputeKey(const Mesh *mesh,
+                                           const RAS_VertexFormat &format,
+                                           const std::vector<unsigned short> &materialFlags)
+{
+  XXH3_state_t *state = XXH3_createState();
+  XXH3_64bits_reset(state);
+
+  XXH3_64bits_update(state, &MESH_CACHE_VERSION, sizeof(MESH_CACHE_VERSION));
+  XXH3_64bits_update(state, &format, sizeof(format));
+  XXH3_64bits_update(state, materialFlags.data(), materialFlags.size() * sizeof(unsigned short));
+
+  // Topology and positions.
+  hash_span(state, mesh->vert_positions());
+  hash_span(state, mesh->edges());
+  hash_span(state, mesh->face_offsets());
+  hash_span(state, mesh->corner_verts());
+  hash_span(state, mesh->corner_edges());
+
+  // Attributes read by the conversion or used to compute normals and tangents.
+  const CustomData *corner_data = &mesh->corner_data;
+  const short activeLayers[2] = {
+      short(CustomData_get_active_layer(corner_data, CD_PROP_FLOAT2)),
+      short(CustomData_get_active_layer(corner_data, CD_PROP_BYTE_COLOR))};
+  XXH3_64bits_update(state, activeLayers, sizeof(activeLayers));
+  hash_layers(state, corner_data, CD_PROP_FLOAT2, mesh->corners_num);
+  hash_layers(state, corner_data, CD_PROP_BYTE_COLOR, mesh->corners_num);
+  hash_layers(state, corner_data, CD_NORMAL, mesh->corners_num);
+  hash_layers(state, corner_data, CD_CUSTOMLOOPNORMAL, mesh->corners_num);
+  hash_layers(state, &mesh->vert_data, CD_ORCO, mesh->verts_num);
+  hash_named_layer(state, &mesh->face_data, CD_PROP_BOOL, "sharp_face", mesh->faces_num);
+  hash_named_layer(state, &mesh->face_data, CD_PROP_INT32, "material_index", mesh->faces_num);
+  hash_named_layer(state, &mesh->edge_data, CD_PROP_BOOL, "sharp_edge", mesh->edges_num);
+
+  const Key key = XXH3_64bits_digest(state);
+  XXH3_freeState(state);
+
+  return key;
+}
+
+bool BL_MeshCache::Load(Key key, RAS_MeshObject *meshobj)
+{
+  const std::string path = GetFilePath(key);
+  const int file = BLI_open(path.c_str(), O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    ++m_misses;
+    return false;
+  }
+
+  BLI_mmap_file *mmap = BLI_mmap_open(file);
+  close(file);
+  if (!mmap) {
+    ++m_misses;
+    return false;
+  }
+
+  const char *data = (const char *)BLI_mmap_get_pointer(mmap);
+  const char *end = data + BLI_mmap_get_length(mmap);
+
+  // Return a pointer to the next size bytes of the file or nullptr if the file is too short.
+  auto take = [&data, end](size_t size) -> const char * {
+    if (!data || size > size_t(end - data)) {
+      data = nullptr;
+      return nullptr;
+    }
+    const char *ptr = data;
+    data += size;
+    return ptr;
+  };
+
+  const unsigned int nummat = meshobj->NumMaterials();
+  const unsigned int numOrigVertices = meshobj->m_sharedvertex_map.size();
+
+  struct MaterialData {
+    const MeshCacheMaterial *header;
+    const float *vertices;
+    const MeshCacheVertexInfo *infos;
+    const uint32_t *lines;
+  };
+  std::vector<MaterialData> materials(nummat);
+  const MeshCachePolygon *polygons = nullptr;
+
+  /* Validate the whole file before modifying the mesh object, a corrupted or outdated
+   * entry is only a cache miss. */
+  const MeshCacheHeader *header = (const MeshCacheHeader *)take(sizeof(MeshCacheHeader));
+  bool valid = (header && memcmp(header->magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC)) == 0 &&
+                header->key == key && header->version == MESH_CACHE_VERSION &&
+                header->numMaterials == nummat && header->numOrigVertices == numOrigVertices);
+
+  const RAS_VertexFormat format = {valid ? header->uvSize : 0, valid ? header->colorSize : 0};
+  const unsigned int vertexSize = vertex_float_size(format);
+
+  for (unsigned int i = 0; i < nummat && valid; ++i) {
+    MaterialData &mat = materials[i];
+    mat.header = (const MeshCacheMaterial *)take(sizeof(MeshCacheMaterial));
+    if (!mat.header ||
+        meshobj->GetMeshMaterial(i)->GetDisplayArray()->GetFormat() != format)
+    {
+      valid = false;
+      break;
+    }
+
+    const unsigned int numvert = mat.header->numVertices;
+    mat.vertices = (const float *)take(sizeof(float) * vertexSize * numvert);
+    mat.infos = (const MeshCacheVertexInfo *)take(sizeof(MeshCacheVertexInfo) * numvert);
+    mat.lines = (const uint32_t *)take(sizeof(uint32_t) * mat.header->numLineIndices);
+    if (!data) {
+      valid = false;
+      break;
+    }
+
+    for (unsigned int j = 0; j < numvert && valid; ++j) {
+      valid = (mat.infos[j].origIndex < numOrigVertices);
+    }
+    for (unsigned int j = 0; j < mat.header->numLineIndices && valid; ++j) {
+      valid = (mat.lines[j] < numvert);
+    }
+  }
+
+  if (valid) {
+    polygons = (const MeshCachePolygon *)take(sizeof(MeshCachePolygon) * header->numPolygons);
+    valid = (polygons != nullptr);
+  }
+
+  for (unsigned int i = 0; valid && i < header->numPolygons; ++i) {
+    const MeshCachePolygon &poly = polygons[i];
+    if (poly.material >= nummat || poly.numVertices < 3 || poly.numVertices > 4) {
+      valid = false;
+      break;
+    }
+    for (unsigned short j = 0; j < poly.numVertices; ++j) {
+      if (poly.offsets[j] >= materials[poly.material].header->numVertices) {
+        valid = false;
+        break;
+      }
+    }
+  }
+
+  if (!valid) {
+    CM_Warning("outdated or invalid mesh cache file \"" << path << "\" for mesh \""
+                                                        << meshobj->GetName() << "\"");
+    BLI_mmap_free(mmap);
+    ++m_misses;
+    return false;
+  }
+
+  MT_Vector2 uvs[RAS_Texture::MaxUnits];
+  unsigned int rgba[RAS_IVertex::MAX_UNIT];
+
+  for (unsigned int i = 0; i < nummat; ++i) {
+    const MaterialData &mat = materials[i];
+    RAS_IDisplayArray *array = meshobj->GetMeshMaterial(i)->GetDisplayArray();
+
+    for (unsigned int j = 0; j < mat.header->numVertices; ++j) {
+      const float *vert = &mat.vertices[j * vertexSize];
+      const float *uvdata = vert + 10;
+      const uint32_t *rgbadata = (const uint32_t *)(uvdata + format.uvSize * 2);
+      for (unsigned int k = 0; k < format.uvSize; ++k) {
+        uvs[k].setValue(&uvdata[k * 2]);
+      }
+      for (unsigned int k = 0; k < format.colorSize; ++k) {
+        rgba[k] = rgbadata[k];
+      }
+
+      RAS_IVertex *vertex = array->CreateVertex(
+          MT_Vector3(vert), uvs, MT_Vector4(vert + 6), rgba, MT_Vector3(vert + 3));
+      array->AddVertex(vertex);
+      delete vertex;
+
+      const MeshCacheVertexInfo &info = mat.infos[j];
+      RAS_VertexInfo vertexInfo(info.origIndex, false);
+      vertexInfo.SetFlag(info.flag);
+      array->AddVertexInfo(vertexInfo);
+
+      // The shared vertices are only used after the conversion, their order doesn't matter.
+      meshobj->m_sharedvertex_map[info.origIndex].push_back({array, int(j)});
+    }
+
+    for (unsigned int j = 0; j < mat.header->numLineIndices; ++j) {
+      array->AddIndex(mat.lines[j]);
+    }
+  }
+
+  // The polygons generate the triangle indices of the non-wire materials.
+  for (unsigned int i = 0; i < header->numPolygons; ++i) {
+    const MeshCachePolygon &poly = polygons[i];
+    unsigned int offsets[4];
+    for (unsigned short j = 0; j < poly.numVertices; ++j) {
+      offsets[j] = poly.offsets[j];
+    }
+    meshobj->AddPolygon(meshobj->GetMeshMaterial(poly.material),
+                        poly.numVertices,
+                        offsets,
+                        (poly.flags & RAS_Polygon::VISIBLE),
+                        (poly.flags & RAS_Polygon::COLLIDER),
+                        (poly.flags & RAS_Polygon::TWOSIDE));
+  }
+
+  BLI_mmap_free(mmap);
+
+  ++m_hits;
+  return true;
+}
+
+void BL_MeshCache::Store(Key key, RAS_MeshObject *meshobj)
+{
+  const std::string &directory = GetDirectory();
+  if (!BLI_exists(directory.c_str()) && !BLI_dir_create_recursive(directory.c_str())) {
+    CM_Error("can't create mesh cache directory \"" << directory << "\"");
+    return;
+  }
+
+  const unsigned int nummat = meshobj->NumMaterials();
+  if (nummat == 0) {
+    return;
+  }
+
+  const RAS_VertexFormat &format = meshobj->GetMeshMaterial(0)->GetDisplayArray()->GetFormat();
+  const unsigned int vertexSize = vertex_float_size(format);
+
+  const std::string path = GetFilePath(key);
+  // Write in a temporary file renamed at the end to never expose a partial file.
+  std::stringstream tmpPath;
+  tmpPath << path << "." << std::this_thread::get_id() << ".tmp";
+
+  std::ofstream file(tmpPath.str(), std::ios::binary | std::ios::trunc);
+  if (!file) {
+    CM_Error("can't write mesh cache file \"" << tmpPath.str() << "\"");
+    return;
+  }
+
+  MeshCacheHeader header;
+  memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+  header.key = key;
+  header.version = MESH_CACHE_VERSION;
+  header.uvSize = format.uvSize;
+  header.colorSize = format.colorSize;
+  header.numMaterials = nummat;
+  header.numPolygons = meshobj->NumPolygons();
+  header.numOrigVertices = meshobj->m_sharedvertex_map.size();
+  file.write((const char *)&header, sizeof(header));
+
+  std::map<RAS_IDisplayArray *, unsigned int> arrayMaterials;
+  std::vector<float> vertices;
+  std::vector<MeshCacheVertexInfo> infos;
+
+  for (unsigned int i = 0; i < nummat; ++i) {
+    RAS_MeshMaterial *meshmat = meshobj->GetMeshMaterial(i);
+    RAS_IDisplayArray *array = meshmat->GetDisplayArray();
+    arrayMaterials[array] = i;
+
+    const unsigned int numvert = array->GetVertexCount();
+    const bool wire = meshmat->GetBucket()->IsWire();
+
+    MeshCacheMaterial mat;
+    mat.numVertices = numvert;
+    mat.numLineIndices = wire ? array->GetIndexCount() : 0;
+    file.write((const char *)&mat, sizeof(mat));
+
+    vertices.resize(numvert * vertexSize);
+    infos.resize(numvert);
+    for (unsigned int j = 0; j < numvert; ++j) {
+      const RAS_IVertex *vertex = array->GetVertexNoCache(j);
+      float *vert = &vertices[j * vertexSize];
+      memcpy(vert, vertex->getXYZ(), sizeof(float[3]));
+      memcpy(vert + 3, vertex->getNormal(), sizeof(float[3]));
+      memcpy(vert + 6, vertex->getTangent(), sizeof(float[4]));
+      float *uvdata = vert + 10;
+      uint32_t *rgbadata = (uint32_t *)(uvdata + format.uvSize * 2);
+      for (unsigned int k = 0; k < format.uvSize; ++k) {
+        memcpy(&uvdata[k * 2], vertex->getUV(k), sizeof(float[2]));
+      }
+      for (unsigned int k = 0; k < format.colorSize; ++k) {
+        rgbadata[k] = vertex->getRawRGBA(k);
+      }
+
+      const RAS_VertexInfo &info = array->GetVertexInfo(j);
+      infos[j] = {info.getOrigIndex(), uint32_t(info.getFlag())};
+    }
+
+    file.write((const char *)vertices.data(), sizeof(float) * vertices.size());
+    file.write((const char *)infos.data(), sizeof(MeshCacheVertexInfo) * infos.size());
+    if (wire) {
+      file.write((const char *)array->GetIndexPointer(), sizeof(uint32_t) * array->GetIndexCount());
+    }
+  }
+
+  for (unsigned int i = 0, size = meshobj->NumPolygons(); i < size; ++i) {
+    const RAS_Polygon *poly = meshobj->GetPolygon(i);
+    MeshCachePolygon cachePoly = {};
+    cachePoly.material = arrayMaterials[poly->GetDisplayArray()];
+    cachePoly.numVertices = poly->VertexCount();
+    cachePoly.flags = (poly->IsVisible() ? RAS_Polygon::VISIBLE : 0) |
+                      (poly->IsCollider() ? RAS_Polygon::COLLIDER : 0) |
+                      (poly->IsTwoside() ? RAS_Polygon::TWOSIDE : 0);
+    for (unsigned short j = 0; j < cachePoly.numVertices; ++j) {
+      cachePoly.offsets[j] = poly->GetVertexOffset(j);
+    }
+    file.write((const char *)&cachePoly, sizeof(cachePoly));
+  }
+
+  file.close();
+  if (!file || BLI_rename_overwrite(tmpPath.str().c_str(), path.c_str()) != 0) {
+    CM_Error("can't write mesh cache file \"" << path << "\"");
+    BLI_delete(tmpPath.str().c_str(), false, false);
+    return;
+  }
+
+  ++m_stores;
+}
+
+void BL_MeshCache::PrintStats()
+{
+  CM_Message(std::endl << "Mesh cache:");
+  CM_Message("\t directory: " << GetDirectory());
+  CM_Message("\t hits: " << m_hits);
+  CM_Message("\t misses: " << m_misses);
+  CM_Message("\t stored: " << m_stores);
+}
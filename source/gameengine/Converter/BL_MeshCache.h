@@ -0,0 +1,95 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file BL_MeshCache.h
+ *  \ingroup bgeconv
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "RAS_IVertex.h"
+
+class RAS_MeshObject;
+struct Mesh;
+
+/** On-disk cache of the converted meshes.
+ *
+ * A converted mesh is stored under a hash of the evaluated mesh data used by the conversion
+ * and of the material settings changing the generated primitives. The cache file contains
+ * the display array vertices (tangents included), the wire indices and the polygon table,
+ * it is memory-mapped and replayed in the mesh object instead of tessellating the mesh,
+ * computing the tangents and searching the shared vertices.
+ */
+class BL_MeshCache {
+ public:
+  typedef uint64_t Key;
+
+  /// Material settings affecting the converted primitives, combined in the cache key.
+  enum MaterialFlag {
+    MATERIAL_VISIBLE = (1 << 0),
+    MATERIAL_TWOSIDE = (1 << 1),
+    MATERIAL_COLLIDER = (1 << 2),
+    MATERIAL_WIRE = (1 << 3)
+  };
+
+ private:
+  static bool m_enabled;
+  static std::string m_directory;
+
+  static std::atomic<unsigned int> m_hits;
+  static std::atomic<unsigned int> m_misses;
+  static std::atomic<unsigned int> m_stores;
+
+  static std::string GetFilePath(Key key);
+
+ public:
+  static bool IsEnabled();
+  static void SetEnabled(bool enabled);
+
+  /// Return the cache directory, by default in the user cache folder.
+  static const std::string &GetDirectory();
+  static void SetDirectory(const std::string &directory);
+
+  /** Compute the cache key of an evaluated mesh.
+   * \param mesh The evaluated mesh to convert.
+   * \param format The vertex format of the display arrays.
+   * \param materialFlags The MaterialFlag of each material slot.
+   */
+  static Key ComputeKey(const Mesh *mesh,
+                        const RAS_VertexFormat &format,
+                        const std::vector<unsigned short> &materialFlags);
+
+  /** Fill the display arrays, polygons and shared vertices of a mesh object from the cache.
+   * The materials of the mesh object must be already added in slot order.
+   * \return False if the cache doesn't contain a valid entry for this key.
+   */
+  static bool Load(Key key, RAS_MeshObject *meshobj);
+  /// Write the converted data of a mesh object to the cache.
+  static void Store(Key key, RAS_MeshObject *meshobj);
+
+  static void PrintStats();
+};
@@ -42,6 +42,7 @@ BL_SceneConverter::BL_SceneConverter()
   m_map_mesh_to_polyaterial = {};
   m_map_blender_to_gameactuator = {};
   m_map_blender_to_gamecontroller = {};
+  m_deferMeshes = false;
 }
 
 BL_SceneConverter::~BL_SceneConverter()
@@ -134,3 +135,35 @@ SCA_IController *BL_SceneConverter::FindGameController(bController *for_controll
 {
   return m_map_blender_to_gamecontroller[for_controller];
 }
+
+void BL_SceneConverter::SetDeferMeshes(bool defer)
+{
+  m_deferMeshes = defer;
+}
+
+bool BL_SceneConverter::GetDeferMeshes() const
+{
+  return m_deferMeshes;
+}
+
+void BL_SceneConverter::DeferMesh(const DeferredMesh &mesh)
+{
+  m_deferredMeshes.push_back(mesh);
+}
+
+std::vector<BL_SceneConverter::DeferredMesh> BL_SceneConverter::TakeDeferredMeshes()
+{
+  std::vector<DeferredMesh> meshes;
+  meshes.swap(m_deferredMeshes);
+  return meshes;
+}
+
+void BL_SceneConverter::AddStageTime(const std::string &name, double time)
+{
+  m_stageTimes.push_back({name, time});
+}
+
+const std::vector<BL_SceneConverter::StageTime> &BL_SceneConverter::GetStageTimes() const
+{
+  return m_stageTimes;
+}
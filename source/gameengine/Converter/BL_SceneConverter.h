@@ -31,7 +31,9 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
+#include <string>
 #include <vector>
 
 #include "CM_Message.h"
@@ -51,6 +53,22 @@ struct bController;
 class BL_SceneConverter {
   friend BL_Converter;
 
+ public:
+  /// Mesh geometry conversion delayed to the parallel stage of the scene conversion.
+  struct DeferredMesh {
+    RAS_MeshObject *m_meshobj;
+    /// The evaluated mesh modified by the conversion, tasks sharing a mesh are run serially.
+    Mesh *m_mesh;
+    std::function<void()> m_convert;
+    bool m_libloading;
+  };
+
+  /// Duration of a conversion stage in seconds.
+  struct StageTime {
+    std::string m_name;
+    double m_time;
+  };
+
  private:
   std::vector<KX_BlenderMaterial *> m_materials;
   std::vector<RAS_MeshObject *> m_meshobjects;
@@ -61,6 +79,10 @@ class BL_SceneConverter {
   std::map<bActuator *, SCA_IActuator *> m_map_blender_to_gameactuator;
   std::map<bController *, SCA_IController *> m_map_blender_to_gamecontroller;
 
+  bool m_deferMeshes;
+  std::vector<DeferredMesh> m_deferredMeshes;
+  std::vector<StageTime> m_stageTimes;
+
  public:
   BL_SceneConverter();
   ~BL_SceneConverter();
@@ -83,4 +105,14 @@ class BL_SceneConverter {
 
   void RegisterGameController(SCA_IController *cont, bController *for_controller);
   SCA_IController *FindGameController(bController *for_controller);
+
+  /// Enable the deferring of the mesh geometry conversions, only for full scene conversions.
+  void SetDeferMeshes(bool defer);
+  bool GetDeferMeshes() const;
+  void DeferMesh(const DeferredMesh &mesh);
+  /// Return and clear the deferred mesh conversions.
+  std::vector<DeferredMesh> TakeDeferredMeshes();
+
+  void AddStageTime(const std::string &name, double time);
+  const std::vector<StageTime> &GetStageTimes() const;
 };
@@ -0,0 +1,51 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file EXP_PropertySlot.h
+ *  \ingroup expressions
+ */
+
+#pragma once
+
+#include <string>
+
+class EXP_Value;
+
+/** Index of a property in the table of its owner.
+ *
+ * The slot is resolved by name at the first access and reused while the owner properties are
+ * unchanged, avoiding a name lookup each time a logic brick reads or writes its property.
+ */
+class EXP_PropertySlot {
+ private:
+  EXP_Value *m_owner;
+  std::string m_name;
+  /// Index of the property, -1 if the property doesn't exist.
+  int m_index;
+  unsigned int m_ownerRevision;
+
+ public:
+  EXP_PropertySlot();
+
+  /// Return the property name of owner, nullptr if it doesn't exist.
+  EXP_Value *Get(EXP_Value *owner, const std::string &name);
+};
@@ -0,0 +1,60 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file EXP_PropertyWatcher.h
+ *  \ingroup expressions
+ */
+
+#pragma once
+
+#include <string>
+
+class EXP_Value;
+
+/** Detect the changes of a property without looking it up.
+ *
+ * The watcher remembers the revision of the owner properties and of the property value,
+ * a property is changed when it is added, replaced or removed, or when its value is written.
+ * Only the integer, float, boolean and string values notify their writes, the other values
+ * and the identifiers with a sub context (a.b) are always reported as changed.
+ */
+class EXP_PropertyWatcher {
+ private:
+  EXP_Value *m_owner;
+  std::string m_name;
+  /// The property value, nullptr if the property doesn't exist.
+  EXP_Value *m_value;
+  unsigned int m_ownerRevision;
+  unsigned int m_valueRevision;
+  /// False if the changes of the property can't be detected.
+  bool m_valid;
+
+ public:
+  EXP_PropertyWatcher();
+
+  /// Forget the watched property, the next call to Changed() returns true.
+  void Reset();
+  /// Watch the current state of the property name of owner.
+  void Update(EXP_Value *owner, const std::string &name);
+  /// Return true if the property could have changed since the last Update().
+  bool Changed(EXP_Value *owner, const std::string &name) const;
+};
@@ -22,10 +22,12 @@
 #  pragma warning(disable : 4786)
 #endif
 
-#include <map>     // Array functionality for the property list.
+#include <map>
 #include <string>  // std::string class.
-#include <vector>
+#include <utility>
+#include <vector>  // Array functionality for the property list.
 
+#include "CM_PoolAllocator.h"
 #include "CM_RefCount.h"
 
 #ifndef GEN_NO_TRACE
@@ -96,6 +98,8 @@ class EXP_Value : public EXP_PyObjectPlus, public CM_RefCount<EXP_Value> {
   Py_Header public : EXP_Value();
   virtual ~EXP_Value();
 
+  CM_POOL_ALLOC_FUNCS
+
 #ifdef WITH_PYTHON
   virtual PyObject *py_repr(void)
   {
@@ -136,8 +140,10 @@ class EXP_Value : public EXP_PyObjectPlus, public CM_RefCount<EXP_Value> {
   /// Clear all properties.
   virtual void ClearProperties();
 
-  /// Get property number <inIndex>.
+  /// Get property number <inIndex>, the properties are sorted by name.
   virtual EXP_Value *GetProperty(int inIndex);
+  /// Get the index of the property named <inName>, -1 if there is no property named <inName>.
+  int GetPropertyIndex(const std::string &inName);
   /// Get the amount of properties assiocated with this value.
   virtual int GetPropertyCount();
 
@@ -163,12 +169,41 @@ class EXP_Value : public EXP_PyObjectPlus, public CM_RefCount<EXP_Value> {
 
   virtual bool IsError() const;
 
+  /// Revision of the properties, changed when a property is added, replaced or removed.
+  unsigned int GetPropertiesRevision() const
+  {
+    return m_propertiesRevision;
+  }
+  /// Revision of the value, changed each time the value is written.
+  unsigned int GetValueRevision() const
+  {
+    return m_valueRevision;
+  }
+
  protected:
   virtual void DestructFromPython();
 
+  /// Notify a write of the value, must be called by the setters of the derived classes.
+  void ValueChanged()
+  {
+    ++m_valueRevision;
+  }
+
  private:
-  /// Properties for user/game etc.
-  std::map<std::string, EXP_Value *> m_properties;
+  typedef std::pair<std::string, EXP_Value *> PropertyEntry;
+  typedef std::vector<PropertyEntry> PropertyTable;
+
+  /// Return the first property not sorted before <inName>.
+  PropertyTable::iterator LowerBoundProperty(const std::string &inName);
+
+  /** Properties for user/game etc.
+   * A flat table sorted by name, the lookups are binary searches in contiguous memory and the
+   * properties can be addressed by index.
+   */
+  PropertyTable m_properties;
+
+  unsigned int m_propertiesRevision;
+  unsigned int m_valueRevision;
 };
 
 /** EXP_PropValue is a EXP_Value derived class, that implements the identification (String name)
@@ -246,6 +246,7 @@ EXP_Value *EXP_FloatValue::CalcFinal(VALUE_DATA_TYPE dtype, VALUE_OPERATOR op, E
 void EXP_FloatValue::SetFloat(float fl)
 {
   m_float = fl;
+  ValueChanged();
 }
 
 float EXP_FloatValue::GetFloat()
@@ -266,6 +267,7 @@ int EXP_FloatValue::GetValueType()
 void EXP_FloatValue::SetValue(EXP_Value *newval)
 {
   m_float = (float)newval->GetNumber();
+  ValueChanged();
 }
 
 std::string EXP_FloatValue::GetText()
@@ -0,0 +1,46 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Expressions/PropertySlot.cpp
+ *  \ingroup expressions
+ */
+
+#include "EXP_PropertySlot.h"
+
+#include "EXP_Value.h"
+
+EXP_PropertySlot::EXP_PropertySlot() : m_owner(nullptr), m_index(-1), m_ownerRevision(0)
+{
+}
+
+EXP_Value *EXP_PropertySlot::Get(EXP_Value *owner, const std::string &name)
+{
+  // The index changes only when a property is added or removed.
+  if (owner != m_owner || owner->GetPropertiesRevision() != m_ownerRevision || name != m_name) {
+    m_owner = owner;
+    m_name = name;
+    m_index = owner->GetPropertyIndex(name);
+    m_ownerRevision = owner->GetPropertiesRevision();
+  }
+
+  return (m_index == -1) ? nullptr : owner->GetProperty(m_index);
+}
@@ -0,0 +1,88 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Expressions/PropertyWatcher.cpp
+ *  \ingroup expressions
+ */
+
+#include "EXP_PropertyWatcher.h"
+
+#include "EXP_Value.h"
+
+EXP_PropertyWatcher::EXP_PropertyWatcher()
+    : m_owner(nullptr), m_value(nullptr), m_ownerRevision(0), m_valueRevision(0), m_valid(false)
+{
+}
+
+void EXP_PropertyWatcher::Reset()
+{
+  m_owner = nullptr;
+  m_value = nullptr;
+  m_valid = false;
+}
+
+void EXP_PropertyWatcher::Update(EXP_Value *owner, const std::string &name)
+{
+  m_owner = owner;
+  m_name = name;
+  m_ownerRevision = owner->GetPropertiesRevision();
+  m_value = nullptr;
+
+  // The properties of a sub context are not watched.
+  if (name.find('.') != std::string::npos) {
+    m_valid = false;
+    return;
+  }
+
+  m_value = owner->GetProperty(name);
+  if (m_value) {
+    switch (m_value->GetValueType()) {
+      case VALUE_INT_TYPE:
+      case VALUE_FLOAT_TYPE:
+      case VALUE_BOOL_TYPE:
+      case VALUE_STRING_TYPE: {
+        m_valueRevision = m_value->GetValueRevision();
+        m_valid = true;
+        break;
+      }
+      default: {
+        m_valid = false;
+      }
+    }
+  }
+  else {
+    // A missing property is changed only when added.
+    m_valid = true;
+  }
+}
+
+bool EXP_PropertyWatcher::Changed(EXP_Value *owner, const std::string &name) const
+{
+  if (!m_valid || owner != m_owner || owner->GetPropertiesRevision() != m_ownerRevision ||
+      name != m_name)
+  {
+    return true;
+  }
+
+  // The value is still owned as the properties are unchanged.
+  return (m_value && m_value->GetValueRevision() != m_valueRevision);
+}
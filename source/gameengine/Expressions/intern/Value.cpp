@@ -20,6 +20,8 @@
 
 #include "EXP_Value.h"
 
+#include <algorithm>
+
 #include "EXP_BoolValue.h"
 #include "EXP_ErrorValue.h"
 #include "EXP_FloatValue.h"
@@ -71,7 +73,7 @@ PyMethodDef EXP_Value::Methods[] = {
 };
 #endif  // WITH_PYTHON
 
-EXP_Value::EXP_Value()
+EXP_Value::EXP_Value() : m_propertiesRevision(0), m_valueRevision(0)
 {
 }
 
@@ -144,6 +146,15 @@ std::string EXP_Value::op2str(VALUE_OPERATOR op)
 //	Property Management
 //---------------------------------------------------------------------------------------------------------------------
 
+EXP_Value::PropertyTable::iterator EXP_Value::LowerBoundProperty(const std::string &inName)
+{
+  return std::lower_bound(
+      m_properties.begin(),
+      m_properties.end(),
+      inName,
+      [](const PropertyEntry &entry, const std::string &name) { return entry.first < name; });
+}
+
 /// Set property <ioProperty>, overwrites and releases a previous property with the same name if
 /// needed.
 void EXP_Value::SetProperty(const std::string &name, EXP_Value *ioProperty)
@@ -154,27 +165,42 @@ void EXP_Value::SetProperty(const std::string &name, EXP_Value *ioProperty)
     return;
   }
 
+  ioProperty->AddRef();
+
   // Try to replace property (if so -> exit as soon as we replaced it).
-  EXP_Value *oldval = m_properties[name];
-  if (oldval) {
-    oldval->Release();
+  PropertyTable::iterator it = LowerBoundProperty(name);
+  if (it != m_properties.end() && it->first == name) {
+    it->second->Release();
+    it->second = ioProperty;
+  }
+  else {
+    // Insert the property at its sorted position.
+    m_properties.emplace(it, name, ioProperty);
   }
 
-  // Add property at end of array.
-  m_properties[name] = ioProperty->AddRef();
+  ++m_propertiesRevision;
 }
 
 /// Get pointer to a property with name <inName>, returns nullptr if there is no property named
 /// <inName>.
 EXP_Value *EXP_Value::GetProperty(const std::string &inName)
 {
-  std::map<std::string, EXP_Value *>::iterator it = m_properties.find(inName);
-  if (it != m_properties.end()) {
+  PropertyTable::iterator it = LowerBoundProperty(inName);
+  if (it != m_properties.end() && it->first == inName) {
     return it->second;
   }
   return nullptr;
 }
 
+int EXP_Value::GetPropertyIndex(const std::string &inName)
+{
+  PropertyTable::iterator it = LowerBoundProperty(inName);
+  if (it != m_properties.end() && it->first == inName) {
+    return it - m_properties.begin();
+  }
+  return -1;
+}
+
 /// Get text description of property with name <inName>, returns an empty string if there is no
 /// property named <inName>.
 const std::string EXP_Value::GetPropertyText(const std::string &inName)
@@ -203,10 +229,11 @@ float EXP_Value::GetPropertyNumber(const std::string &inName, float defnumber)
 /// if property was not found or could not be removed.
 bool EXP_Value::RemoveProperty(const std::string &inName)
 {
-  std::map<std::string, EXP_Value *>::iterator it = m_properties.find(inName);
-  if (it != m_properties.end()) {
+  PropertyTable::iterator it = LowerBoundProperty(inName);
+  if (it != m_properties.end() && it->first == inName) {
     (*it).second->Release();
     m_properties.erase(it);
+    ++m_propertiesRevision;
     return true;
   }
 
@@ -236,19 +263,16 @@ void EXP_Value::ClearProperties()
 
   // Delete property array.
   m_properties.clear();
+  ++m_propertiesRevision;
 }
 
 /// Get property number <inIndex>.
 EXP_Value *EXP_Value::GetProperty(int inIndex)
 {
-  int count = 0;
-
-  for (const auto &pair : m_properties) {
-    if (count++ == inIndex) {
-      return pair.second;
-    }
+  if (inIndex < 0 || size_t(inIndex) >= m_properties.size()) {
+    return nullptr;
   }
-  return nullptr;
+  return m_properties[inIndex].second;
 }
 
 /// Get the amount of properties assiocated with this value.
@@ -128,7 +128,7 @@ bool SCA_ActionActuator::Update(double curtime)
 
     // Handle a frame property if it's defined
     if (!m_framepropname.empty()) {
-      EXP_Value *oldprop = obj->GetProperty(m_framepropname);
+      EXP_Value *oldprop = m_framepropslot.Get(obj, m_framepropname);
       EXP_Value *newval = new EXP_FloatValue(obj->GetActionFrame(m_layer));
       if (oldprop) {
         oldprop->SetValue(newval);
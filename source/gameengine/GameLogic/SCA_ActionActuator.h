@@ -34,6 +34,7 @@
 #include "DNA_actuator_types.h"
 
 #include "BL_Action.h"  // For BL_Action::PlayMode.
+#include "EXP_PropertySlot.h"
 #include "MT_Vector3.h"
 #include "SCA_IActuator.h"
 
@@ -129,6 +130,8 @@ class SCA_ActionActuator : public SCA_IActuator {
   struct bAction *m_action;
   std::string m_propname;
   std::string m_framepropname;
+  /// Resolved property m_framepropname of the parent.
+  EXP_PropertySlot m_framepropslot;
 };
 
 enum {
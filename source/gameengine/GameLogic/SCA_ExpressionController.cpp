@@ -45,7 +45,12 @@
 
 SCA_ExpressionController::SCA_ExpressionController(SCA_IObject *gameobj,
                                                    const std::string &exprtext)
-    : SCA_IController(gameobj), m_exprText(exprtext), m_exprCache(nullptr)
+    : SCA_IController(gameobj),
+      m_exprText(exprtext),
+      m_exprCache(nullptr),
+      m_recordDependencies(false),
+      m_resultValid(false),
+      m_result(false)
 {
 }
 
@@ -60,6 +65,7 @@ EXP_Value *SCA_ExpressionController::GetReplica()
   SCA_ExpressionController *replica = new SCA_ExpressionController(*this);
   replica->m_exprText = m_exprText;
   replica->m_exprCache = nullptr;
+  replica->ClearDependencies();
   // this will copy properties and so on...
   replica->ProcessReplica();
 
@@ -74,30 +80,87 @@ void SCA_ExpressionController::Delete()
     m_exprCache->Release();
     m_exprCache = nullptr;
   }
+  ClearDependencies();
   Release();
 }
 
-void SCA_ExpressionController::Trigger(SCA_LogicManager *logicmgr)
+bool SCA_ExpressionController::FindSensorState(const std::string &name, bool &state) const
+{
+  for (SCA_ISensor *sensor : m_linkedsensors) {
+    if (sensor->GetName() == name) {
+      state = sensor->GetState();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool SCA_ExpressionController::DependenciesChanged()
+{
+  for (const SensorDependency &dep : m_sensorDependencies) {
+    bool state;
+    if (!FindSensorState(dep.m_name, state) || state != dep.m_state) {
+      return true;
+    }
+  }
+
+  SCA_IObject *parent = GetParent();
+  for (const PropertyDependency &dep : m_propertyDependencies) {
+    if (dep.m_watcher.Changed(parent, dep.m_name)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void SCA_ExpressionController::ClearDependencies()
 {
+  m_sensorDependencies.clear();
+  m_propertyDependencies.clear();
+  m_resultValid = false;
+}
 
+void SCA_ExpressionController::Trigger(SCA_LogicManager *logicmgr)
+{
   bool expressionresult = false;
-  if (!m_exprCache) {
-    EXP_Parser parser;
-    parser.SetContext(this->AddRef());
-    m_exprCache = parser.ProcessText(m_exprText);
+  // The expression is evaluated again only if one of the identifiers it read has changed.
+  if (m_resultValid && !DependenciesChanged()) {
+    expressionresult = m_result;
   }
-  if (m_exprCache) {
-    EXP_Value *value = m_exprCache->Calculate();
-    if (value) {
-      if (value->IsError()) {
-        CM_LogicBrickError(this, value->GetText());
+  else {
+    ClearDependencies();
+
+    if (!m_exprCache) {
+      EXP_Parser parser;
+      parser.SetContext(this->AddRef());
+      m_exprCache = parser.ProcessText(m_exprText);
+    }
+    if (m_exprCache) {
+      m_recordDependencies = true;
+      m_resultValid = true;
+      EXP_Value *value = m_exprCache->Calculate();
+      m_recordDependencies = false;
+
+      if (value) {
+        if (value->IsError()) {
+          CM_LogicBrickError(this, value->GetText());
+          // Report the error at each trigger.
+          m_resultValid = false;
+        }
+        else {
+          float num = (float)value->GetNumber();
+          expressionresult = !MT_fuzzyZero(num);
+        }
+        value->Release();
       }
       else {
-        float num = (float)value->GetNumber();
-        expressionresult = !MT_fuzzyZero(num);
+        m_resultValid = false;
       }
-      value->Release();
     }
+
+    m_result = expressionresult;
   }
 
   for (std::vector<SCA_IActuator *>::const_iterator i = m_linkedactuators.begin();
@@ -118,6 +181,9 @@ EXP_Value *SCA_ExpressionController::FindIdentifier(const std::string &identifie
        is++) {
     SCA_ISensor *sensor = *is;
     if (sensor->GetName() == identifiername) {
+      if (m_recordDependencies) {
+        m_sensorDependencies.push_back({identifiername, sensor->GetState()});
+      }
       identifierval = new EXP_BoolValue(sensor->GetState());
       // identifierval = sensor->AddRef();
       break;
@@ -133,5 +199,13 @@ EXP_Value *SCA_ExpressionController::FindIdentifier(const std::string &identifie
   if (identifierval)
     return identifierval;
 
-  return GetParent()->FindIdentifier(identifiername);
+  SCA_IObject *parent = GetParent();
+  if (m_recordDependencies) {
+    PropertyDependency dep;
+    dep.m_name = identifiername;
+    dep.m_watcher.Update(parent, identifiername);
+    m_propertyDependencies.push_back(dep);
+  }
+
+  return parent->FindIdentifier(identifiername);
 }
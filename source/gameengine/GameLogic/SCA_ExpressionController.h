@@ -34,6 +34,9 @@
 
 #pragma once
 
+#include <vector>
+
+#include "EXP_PropertyWatcher.h"
 #include "SCA_IController.h"
 
 class EXP_Expression;
@@ -43,6 +46,33 @@ class SCA_ExpressionController : public SCA_IController {
   std::string m_exprText;
   EXP_Expression *m_exprCache;
 
+  /// A sensor read by the expression and its state.
+  struct SensorDependency {
+    std::string m_name;
+    bool m_state;
+  };
+
+  /// A property read by the expression.
+  struct PropertyDependency {
+    std::string m_name;
+    EXP_PropertyWatcher m_watcher;
+  };
+
+  /** The identifiers read by the last evaluation, recorded by FindIdentifier().
+   * The result is reused as long as none of them changes.
+   */
+  std::vector<SensorDependency> m_sensorDependencies;
+  std::vector<PropertyDependency> m_propertyDependencies;
+  bool m_recordDependencies;
+  /// False if the last result can't be reused.
+  bool m_resultValid;
+  bool m_result;
+
+  /// Return the state of the linked sensor named name, false if not found.
+  bool FindSensorState(const std::string &name, bool &state) const;
+  bool DependenciesChanged();
+  void ClearDependencies();
+
  public:
   SCA_ExpressionController(SCA_IObject *gameobj, const std::string &exprtext);
 
@@ -252,6 +252,11 @@ void SCA_IObject::ResumeLogic(void)
   }
 }
 
+bool SCA_IObject::IsLogicSuspended() const
+{
+  return m_logicSuspended;
+}
+
 void SCA_IObject::SetInitState(unsigned int initState)
 {
   m_initState = initState;
@@ -139,6 +139,9 @@ class SCA_IObject : public KX_PythonProxy {
   /// Resume progress.
   void ResumeLogic(void);
 
+  /// Is the logic suspended?
+  bool IsLogicSuspended() const;
+
   /// Set init state.
   void SetInitState(unsigned int initState);
 
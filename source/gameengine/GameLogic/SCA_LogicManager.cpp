@@ -32,6 +32,7 @@
 
 #include "SCA_LogicManager.h"
 
+#include "CM_Profiler.h"
 #include "SCA_ISensor.h"
 #include "SCA_PythonController.h"
 
@@ -135,11 +136,15 @@ void SCA_LogicManager::RegisterToActuator(SCA_IController *controller, SCA_IActu
 
 void SCA_LogicManager::BeginFrame(double curtime, double fixedtime)
 {
-  for (std::vector<SCA_EventManager *>::const_iterator ie = m_eventmanagers.begin();
-       !(ie == m_eventmanagers.end());
-       ie++)
-    (*ie)->NextFrame(curtime, fixedtime);
+  {
+    CM_ProfileZone zone("Sensors");
+    for (std::vector<SCA_EventManager *>::const_iterator ie = m_eventmanagers.begin();
+         !(ie == m_eventmanagers.end());
+         ie++)
+      (*ie)->NextFrame(curtime, fixedtime);
+  }
 
+  CM_ProfileZone zone("Controllers");
   for (SG_QList *obj = (SG_QList *)m_triggeredControllerSet.Remove(); obj != nullptr;
        obj = (SG_QList *)m_triggeredControllerSet.Remove()) {
     for (SCA_IController *contr = (SCA_IController *)obj->QRemove(); contr != nullptr;
@@ -157,6 +162,7 @@ void SCA_LogicManager::UpdateFrame(double curtime)
        ie++)
     (*ie)->UpdateFrame();
 
+  CM_ProfileZone zone("Actuators");
   SG_DList::iterator<SG_QList> io(m_activeActuators);
   for (io.begin(); !io.end();) {
     SG_QList *ahead = *io;
@@ -42,10 +42,7 @@
 
 #include "CM_Message.h"
 #include "KX_Camera.h"
-#include "KX_ClientObjectInfo.h"
 #include "KX_PyMath.h"
-#include "KX_RayCast.h"
-#include "RAS_ICanvas.h"
 #include "RAS_MeshObject.h"
 
 /* ------------------------------------------------------------------------- */
@@ -160,11 +157,26 @@ bool SCA_MouseFocusSensor::Evaluate()
   return result;
 }
 
-bool SCA_MouseFocusSensor::RayHit(KX_ClientObjectInfo *client_info,
-                                  KX_RayCast *result,
-                                  void */*data*/)
+bool SCA_MouseFocusSensor::HasPropertyOrMaterial(KX_GameObject *gameobj) const
 {
-  KX_GameObject *hitKXObj = client_info->m_gameobject;
+  if (m_bFindMaterial) {
+    for (unsigned int i = 0; i < gameobj->GetMeshCount(); ++i) {
+      RAS_MeshObject *meshObj = gameobj->GetMesh(i);
+      for (unsigned int j = 0; j < meshObj->NumMaterials(); ++j) {
+        if (m_propertyname == std::string(meshObj->GetMaterialName(j), 2)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  return (gameobj->GetProperty(m_propertyname) != nullptr);
+}
+
+bool SCA_MouseFocusSensor::RayHit(const KX_MousePickCache::Hit &hit)
+{
+  KX_GameObject *hitKXObj = hit.m_object;
 
   /* Is this me? In the ray test, there are a lot of extra checks
    * for aliasing artifacts from self-hits. That doesn't happen
@@ -174,205 +186,57 @@ bool SCA_MouseFocusSensor::RayHit(KX_ClientObjectInfo *client_info,
    * Hitspots now become valid. */
   KX_GameObject *thisObj = (KX_GameObject *)GetParent();
 
-  bool bFound = false;
-
   if ((m_focusmode == 2) || hitKXObj == thisObj) {
-    if (m_propertyname.empty()) {
-      bFound = true;
-    }
-    else {
-      if (m_bFindMaterial) {
-        for (unsigned int i = 0; i < hitKXObj->GetMeshCount(); ++i) {
-          RAS_MeshObject *meshObj = hitKXObj->GetMesh(i);
-          for (unsigned int j = 0; j < meshObj->NumMaterials(); ++j) {
-            bFound = (m_propertyname == std::string(meshObj->GetMaterialName(j), 2));
-            if (bFound)
-              break;
-          }
-        }
-      }
-      else {
-        bFound = hitKXObj->GetProperty(m_propertyname) != nullptr;
-      }
-    }
-
-    if (bFound) {
+    if (m_propertyname.empty() || HasPropertyOrMaterial(hitKXObj)) {
       m_hitObject = hitKXObj;
-      m_hitPosition = result->m_hitPoint;
-      m_hitNormal = result->m_hitNormal;
-      m_hitUV = result->m_hitUV;
+      m_hitPosition = hit.m_point;
+      m_hitNormal = hit.m_normal;
+      m_hitUV = hit.m_uv;
       return true;
     }
   }
 
-  return true;  // object must be visible to trigger
-                // return false;  // occluded objects can trigger
+  return false;
 }
 
-/* this function is used to pre-filter the object before casting the ray on them.
+/* this function is used to pre-filter the object hit by the ray.
  * This is useful for "X-Ray" option when we want to see "through" unwanted object.
  */
-bool SCA_MouseFocusSensor::NeedRayCast(KX_ClientObjectInfo *client, void */*data*/)
+bool SCA_MouseFocusSensor::NeedRayCast(KX_GameObject *gameobj)
 {
-  KX_GameObject *hitKXObj = client->m_gameobject;
-
-  if (client->m_type > KX_ClientObjectInfo::ACTOR) {
-    // Unknown type of object, skip it.
-    // Should not occur as the sensor objects are filtered in RayTest()
-    CM_Error("invalid client type " << client->m_type << " found ray casting");
-    return false;
-  }
-
   // The current object is not in the proper layer.
-  if (!(hitKXObj->GetCollisionGroup() & m_mask)) {
+  if (!(gameobj->GetCollisionGroup() & m_mask)) {
     return false;
   }
 
   if (m_bXRay && m_propertyname.size() != 0) {
-    if (m_bFindMaterial) {
-      bool found = false;
-      for (unsigned int i = 0; i < hitKXObj->GetMeshCount(); ++i) {
-        RAS_MeshObject *meshObj = hitKXObj->GetMesh(i);
-        for (unsigned int j = 0; j < meshObj->NumMaterials(); ++j) {
-          found = (m_propertyname == std::string(meshObj->GetMaterialName(j), 2));
-          if (found)
-            break;
-        }
-      }
-      if (!found)
-        return false;
-    }
-    else {
-      if (hitKXObj->GetProperty(m_propertyname) == nullptr)
-        return false;
-    }
+    return HasPropertyOrMaterial(gameobj);
   }
   return true;
 }
 
 bool SCA_MouseFocusSensor::ParentObjectHasFocusCamera(KX_Camera *cam)
 {
-  /* All screen handling in the gameengine is done by GL,
-   * specifically the model/view and projection parts. The viewport
-   * part is in the creator.
-   *
-   * The theory is this:
-   * WCS - world coordinates
-   * -> wcs_camcs_trafo ->
-   * camCS - camera coordinates
-   * -> camcs_clip_trafo ->
-   * clipCS - normalized device coordinates?
-   * -> normview_win_trafo
-   * winCS - window coordinates
-   *
-   * The first two transforms are respectively the model/view and
-   * the projection matrix. These are passed to the rasterizer, and
-   * we store them in the camera for easy access.
-   *
-   * For normalized device coords (xn = x/w, yn = y/w/zw) the
-   * windows coords become (lb = left bottom)
-   *
-   * xwin = [(xn + 1.0) * width]/2 + x_lb
-   * ywin = [(yn + 1.0) * height]/2 + y_lb
-   *
-   * Inverting (blender y is flipped!):
-   *
-   * xn = 2(xwin - x_lb)/width - 1.0
-   * yn = 2(ywin - y_lb)/height - 1.0
-   *    = 2(height - y_blender - y_lb)/height - 1.0
-   *    = 1.0 - 2(y_blender - y_lb)/height
-   *
-   * */
-
-  /* Because we don't want to worry about resize events, camera
-   * changes and all that crap, we just determine this over and
-   * over. Stop whining. We have lots of other calculations to do
-   * here as well. These reads are not the main cost. If there is no
-   * canvas, the test is irrelevant. The 1.0 makes sure the
-   * calculations don't bomb. Maybe we should explicitly guard for
-   * division by 0.0...*/
-
-  RAS_Rect area, viewport;
-  RAS_ICanvas *canvas = m_kxengine->GetCanvas();
-  short m_y_inv = canvas->GetHeight() - m_y;
-
-  const RAS_Rect displayArea = m_kxengine->GetRasterizer()->GetRenderArea(
-      canvas, RAS_Rasterizer::RAS_STEREO_LEFTEYE);
-  m_kxengine->GetSceneViewport(m_kxscene, cam, displayArea, area, viewport);
+  /* The ray and the objects it hits are computed once per camera and frame for all the
+   * sensors of the scene, each sensor only applies its own filters to the hits. */
+  const KX_MousePickCache::Pick &pick = m_kxscene->GetMousePickCache()->GetPick(
+      cam, m_x, m_y, m_kxengine);
 
   /* Check if the mouse is in the viewport */
-  if ((m_x < viewport.GetRight() &&           // less than right
-       m_x > viewport.GetLeft() &&            // more than then left
-       m_y_inv < viewport.GetTop() &&         // below top
-       m_y_inv > viewport.GetBottom()) == 0)  // above bottom
-  {
+  if (!pick.m_inViewport) {
     return false;
   }
 
-  float height = float(viewport.GetTop() - viewport.GetBottom() + 1);
-  float width = float(viewport.GetRight() - viewport.GetLeft() + 1);
-
-  float x_lb = float(viewport.GetLeft());
-  float y_lb = float(viewport.GetBottom());
-
-  MT_Vector4 frompoint;
-  MT_Vector4 topoint;
-
-  /* m_y_inv - inverting for a bounds check is only part of it, now make relative to view bounds */
-  m_y_inv = (viewport.GetTop() - m_y_inv) + viewport.GetBottom();
-
-  /* There's some strangeness I don't fully get here... These values
-   * _should_ be wrong! - see from point Z values */
-
-  /*	build the from and to point in normalized device coordinates
-   *	Normalized device coordinates are [-1,1] in x, y, z
-   *
-   *	The actual z coordinates used don't have to be exact just infront and
-   *	behind of the near and far clip planes.
-   */
-  frompoint.setValue(
-      (2 * (m_x - x_lb) / width) - 1.0f, 1.0f - (2 * (m_y_inv - y_lb) / height), -1.0f, 1.0f);
-
-  topoint.setValue(
-      (2 * (m_x - x_lb) / width) - 1.0f, 1.0f - (2 * (m_y_inv - y_lb) / height), 1.0f, 1.0f);
+  m_prevSourcePoint = pick.m_source;
+  m_prevTargetPoint = pick.m_target;
 
-  /* camera to world  */
-  MT_Matrix4x4 camcs_wcs_matrix = MT_Matrix4x4(cam->GetCameraToWorld());
-
-  /* badly defined, the first time round.... I wonder why... I might
-   * want to guard against floating point errors here.*/
-  MT_Matrix4x4 clip_camcs_matrix = MT_Matrix4x4(cam->GetProjectionMatrix());
-  clip_camcs_matrix.invert();
-
-  /* shoot-points: clip to cam to wcs . win to clip was already done.*/
-  frompoint = clip_camcs_matrix * frompoint;
-  topoint = clip_camcs_matrix * topoint;
-  /* clipstart = - (frompoint[2] / frompoint[3])
-   * clipend = - (topoint[2] / topoint[3]) */
-  frompoint = camcs_wcs_matrix * frompoint;
-  topoint = camcs_wcs_matrix * topoint;
-
-  /* from hom wcs to 3d wcs: */
-  m_prevSourcePoint.setValue(
-      frompoint[0] / frompoint[3], frompoint[1] / frompoint[3], frompoint[2] / frompoint[3]);
-
-  m_prevTargetPoint.setValue(
-      topoint[0] / topoint[3], topoint[1] / topoint[3], topoint[2] / topoint[3]);
-
-  /* 2. Get the object from PhysicsEnvironment */
-  /* Shoot! Beware that the first argument here is an
-   * ignore-object. We don't ignore anything... */
-  PHY_IPhysicsController *physics_controller = cam->GetPhysicsController();
-  PHY_IPhysicsEnvironment *physics_environment = m_kxscene->GetPhysicsEnvironment();
-
-  // get UV mapping
-  KX_RayCast::Callback<SCA_MouseFocusSensor, void> callback(
-      this, physics_controller, nullptr, false, true);
-
-  KX_RayCast::RayTest(physics_environment, m_prevSourcePoint, m_prevTargetPoint, callback);
-
-  if (m_hitObject)
-    return true;
+  /* The hits are sorted by distance, the first object not filtered is visible and
+   * must be the focused one to trigger. */
+  for (const KX_MousePickCache::Hit &hit : pick.m_hits) {
+    if (NeedRayCast(hit.m_object)) {
+      return RayHit(hit);
+    }
+  }
 
   return false;
 }
@@ -34,14 +34,12 @@
 
 #include "BLI_utildefines.h"
 
+#include "KX_MousePickCache.h"
 #include "KX_Scene.h"
 #include "SCA_MouseSensor.h"
 
 class KX_Camera;
 class KX_KetsjiEngine;
-class KX_RayCast;
-
-struct KX_ClientObjectInfo;
 
 /**
  * The mouse focus sensor extends the basic SCA_MouseSensor. It has
@@ -100,10 +98,10 @@ class SCA_MouseFocusSensor : public SCA_MouseSensor {
     return result;
   };
 
-  /// \see KX_RayCast
-  bool RayHit(KX_ClientObjectInfo *client, KX_RayCast *result, void */*data*/);
-  /// \see KX_RayCast
-  bool NeedRayCast(KX_ClientObjectInfo *client, void */*data*/);
+  /// Resolve the first hit of the pick ray not filtered by NeedRayCast().
+  bool RayHit(const KX_MousePickCache::Hit &hit);
+  /// Return false if the ray goes through the object (collision mask and X-Ray).
+  bool NeedRayCast(KX_GameObject *gameobj);
 
   const MT_Vector3 &RaySource() const;
   const MT_Vector3 &RayTarget() const;
@@ -176,6 +174,11 @@ class SCA_MouseFocusSensor : public SCA_MouseSensor {
    */
   bool m_positive_event;
 
+  /**
+   * Tests whether the object has the property or material of the sensor.
+   */
+  bool HasPropertyOrMaterial(KX_GameObject *gameobj) const;
+
   /**
    * Tests whether the object is in mouse focus for this camera
    */
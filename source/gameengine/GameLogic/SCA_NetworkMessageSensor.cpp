@@ -96,11 +96,10 @@ bool SCA_NetworkMessageSensor::Evaluate()
     m_SubjectList = nullptr;
   }
 
-  std::string toname = GetParent()->GetName();
-  std::string &subject = this->m_subject;
+  const std::string toname = GetParent()->GetName();
 
-  const std::vector<KX_NetworkMessageManager::Message> messages = m_NetworkScene->FindMessages(
-      toname, subject);
+  const CM_FrameVector<const KX_NetworkMessageManager::Message *> messages =
+      m_NetworkScene->FindMessages(toname, m_subject);
 
   m_frame_message_count = messages.size();
 
@@ -113,12 +112,11 @@ bool SCA_NetworkMessageSensor::Evaluate()
     m_SubjectList = new EXP_ListValue<EXP_StringValue>();
   }
 
-  std::vector<KX_NetworkMessageManager::Message>::const_iterator mesit;
-  for (mesit = messages.begin(); mesit != messages.end(); mesit++) {
+  for (const KX_NetworkMessageManager::Message *message : messages) {
     // save the body
-    const std::string &body = (*mesit).body;
+    const std::string &body = message->body;
     // save the subject
-    const std::string &messub = (*mesit).subject;
+    const std::string &messub = message->subject;
 #ifdef NAN_NET_DEBUG
     if (body) {
       cout << "body [" << body << "]\n";
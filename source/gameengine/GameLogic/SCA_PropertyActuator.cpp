@@ -76,7 +76,7 @@ bool SCA_PropertyActuator::Update()
   if (bNegativeEvent) {
     if (m_type == KX_ACT_PROP_LEVEL) {
       EXP_Value *newval = new EXP_BoolValue(false);
-      EXP_Value *oldprop = propowner->GetProperty(m_propname);
+      EXP_Value *oldprop = m_propslot.Get(propowner, m_propname);
       if (oldprop) {
         oldprop->SetValue(newval);
       }
@@ -93,7 +93,7 @@ bool SCA_PropertyActuator::Update()
   if (m_type == KX_ACT_PROP_TOGGLE) {
     /* don't use */
     EXP_Value *newval;
-    EXP_Value *oldprop = propowner->GetProperty(m_propname);
+    EXP_Value *oldprop = m_propslot.Get(propowner, m_propname);
     if (oldprop) {
       newval = new EXP_BoolValue((oldprop->GetNumber() == 0.0) ? true : false);
       oldprop->SetValue(newval);
@@ -106,7 +106,7 @@ bool SCA_PropertyActuator::Update()
   }
   else if (m_type == KX_ACT_PROP_LEVEL) {
     EXP_Value *newval = new EXP_BoolValue(true);
-    EXP_Value *oldprop = propowner->GetProperty(m_propname);
+    EXP_Value *oldprop = m_propslot.Get(propowner, m_propname);
     if (oldprop) {
       oldprop->SetValue(newval);
     }
@@ -121,7 +121,7 @@ bool SCA_PropertyActuator::Update()
       case KX_ACT_PROP_ASSIGN: {
 
         EXP_Value *newval = userexpr->Calculate();
-        EXP_Value *oldprop = propowner->GetProperty(m_propname);
+        EXP_Value *oldprop = m_propslot.Get(propowner, m_propname);
         if (oldprop) {
           oldprop->SetValue(newval);
         }
@@ -132,7 +132,7 @@ bool SCA_PropertyActuator::Update()
         break;
       }
       case KX_ACT_PROP_ADD: {
-        EXP_Value *oldprop = propowner->GetProperty(m_propname);
+        EXP_Value *oldprop = m_propslot.Get(propowner, m_propname);
         if (oldprop) {
           // int waarde = (int)oldprop->GetNumber();  /*unused*/
           EXP_Expression *expr = new EXP_Operator2Expr(
@@ -31,6 +31,7 @@
 
 #pragma once
 
+#include "EXP_PropertySlot.h"
 #include "SCA_IActuator.h"
 
 class SCA_PropertyActuator : public SCA_IActuator {
@@ -48,6 +49,8 @@ class SCA_PropertyActuator : public SCA_IActuator {
 
   int m_type;
   std::string m_propname;
+  /// Resolved property m_propname of the parent.
+  EXP_PropertySlot m_propslot;
   std::string m_exprtxt;
   SCA_IObject *m_sourceObj;  // for copy property actuator
 
@@ -71,6 +71,7 @@ void SCA_PropertySensor::Init()
   m_recentresult = false;
   m_lastresult = m_invert ? true : false;
   m_reset = true;
+  m_watcher.Reset();
 }
 
 EXP_Value *SCA_PropertySensor::GetReplica()
@@ -111,6 +112,16 @@ bool SCA_PropertySensor::Evaluate()
 
 bool SCA_PropertySensor::CheckPropertyCondition()
 {
+  SCA_IObject *parent = GetParent();
+  // The last result still applies while the property is unchanged.
+  if (!m_watcher.Changed(parent, m_checkpropname)) {
+    if (m_checktype == KX_PROPSENSOR_CHANGED) {
+      m_recentresult = false;
+    }
+    return m_recentresult;
+  }
+  m_watcher.Update(parent, m_checkpropname);
+
   m_recentresult = false;
   bool result = false;
   bool reverse = false;
@@ -119,7 +130,7 @@ bool SCA_PropertySensor::CheckPropertyCondition()
       reverse = true;
       ATTR_FALLTHROUGH;
     case KX_PROPSENSOR_EQUAL: {
-      EXP_Value *orgprop = GetParent()->FindIdentifier(m_checkpropname);
+      EXP_Value *orgprop = parent->FindIdentifier(m_checkpropname);
       if (!orgprop->IsError()) {
         const std::string &testprop = orgprop->GetText();
         // Force strings to upper case, to avoid confusion in
@@ -154,7 +165,7 @@ bool SCA_PropertySensor::CheckPropertyCondition()
       break;
     }
     case KX_PROPSENSOR_INTERVAL: {
-      EXP_Value *orgprop = GetParent()->FindIdentifier(m_checkpropname);
+      EXP_Value *orgprop = parent->FindIdentifier(m_checkpropname);
       if (!orgprop->IsError()) {
         float min;
         float max;
@@ -176,7 +187,7 @@ bool SCA_PropertySensor::CheckPropertyCondition()
       break;
     }
     case KX_PROPSENSOR_CHANGED: {
-      EXP_Value *orgprop = GetParent()->FindIdentifier(m_checkpropname);
+      EXP_Value *orgprop = parent->FindIdentifier(m_checkpropname);
 
       if (!orgprop->IsError()) {
         if (m_previoustext != orgprop->GetText()) {
@@ -192,7 +203,7 @@ bool SCA_PropertySensor::CheckPropertyCondition()
       reverse = true;
       ATTR_FALLTHROUGH;
     case KX_PROPSENSOR_GREATERTHAN: {
-      EXP_Value *orgprop = GetParent()->FindIdentifier(m_checkpropname);
+      EXP_Value *orgprop = parent->FindIdentifier(m_checkpropname);
       if (!orgprop->IsError()) {
         float ref;
         CM_StringTo(m_checkpropval, ref);
@@ -244,6 +255,9 @@ int SCA_PropertySensor::validValueForProperty(EXP_PyObjectPlus *self, const PyAt
    * function directly */
 
   /*  There is no type checking at this moment, unfortunately...           */
+
+  // The condition changes with the value.
+  static_cast<SCA_PropertySensor *>(self)->m_watcher.Reset();
   return 0;
 }
 
@@ -291,12 +305,13 @@ PyMethodDef SCA_PropertySensor::Methods[] = {
 };
 
 PyAttributeDef SCA_PropertySensor::Attributes[] = {
-    EXP_PYATTRIBUTE_INT_RW("mode",
-                           KX_PROPSENSOR_NODEF,
-                           KX_PROPSENSOR_MAX - 1,
-                           false,
-                           SCA_PropertySensor,
-                           m_checktype),
+    EXP_PYATTRIBUTE_INT_RW_CHECK("mode",
+                                 KX_PROPSENSOR_NODEF,
+                                 KX_PROPSENSOR_MAX - 1,
+                                 false,
+                                 SCA_PropertySensor,
+                                 m_checktype,
+                                 validValueForProperty),
     EXP_PYATTRIBUTE_STRING_RW_CHECK(
         "propName", 0, MAX_PROP_NAME, false, SCA_PropertySensor, m_checkpropname, CheckProperty),
     EXP_PYATTRIBUTE_STRING_RW_CHECK(
@@ -32,6 +32,7 @@
 
 #pragma once
 
+#include "EXP_PropertyWatcher.h"
 #include "SCA_ISensor.h"
 
 class SCA_PropertySensor : public SCA_ISensor {
@@ -44,6 +45,8 @@ class SCA_PropertySensor : public SCA_ISensor {
   std::string m_previoustext;
   bool m_lastresult;
   bool m_recentresult;
+  /// The condition is checked again only when the property changes.
+  EXP_PropertyWatcher m_watcher;
 
  protected:
  public:
@@ -84,7 +87,7 @@ class SCA_PropertySensor : public SCA_ISensor {
   /* --------------------------------------------------------------------- */
 
   /**
-   * Test whether this is a sensible value (type check)
+   * Test whether this is a sensible value (type check), the condition is checked again
    */
   static int validValueForProperty(EXP_PyObjectPlus *self, const PyAttributeDef *);
 
@@ -40,6 +40,7 @@
 #endif  // WITH_PYTHON
 
 #include "CM_Message.h"
+#include "CM_Trace.h"
 
 // initialize static member variables
 SCA_PythonController *SCA_PythonController::m_sCurrentController = nullptr;
@@ -346,6 +347,7 @@ bool SCA_PythonController::Import()
 
 void SCA_PythonController::Trigger(SCA_LogicManager *logicmgr)
 {
+  CM_TraceZone traceZone(m_scriptName.c_str());
   m_sCurrentController = this;
 
   PyObject *excdict = nullptr;
@@ -222,7 +222,7 @@ bool SCA_RandomActuator::Update()
   }
 
   /* Round up: assign it */
-  EXP_Value *prop = GetParent()->GetProperty(m_propname);
+  EXP_Value *prop = m_propslot.Get(GetParent(), m_propname);
   if (prop) {
     prop->SetValue(tmpval);
   }
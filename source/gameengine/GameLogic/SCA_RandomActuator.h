@@ -32,6 +32,7 @@
 
 #pragma once
 
+#include "EXP_PropertySlot.h"
 #include "SCA_IActuator.h"
 #include "SCA_RandomNumberGenerator.h"
 
@@ -39,6 +40,7 @@ class SCA_RandomActuator : public SCA_IActuator {
   Py_Header
       /** Property to assign to */
       std::string m_propname;
+  EXP_PropertySlot m_propslot;
 
   /** First parameter. The meaning of the parameters depends on the
    *  distribution */
@@ -67,6 +67,7 @@ SCA_SoundActuator::SCA_SoundActuator(SCA_IObject *gameobj,
 #endif  // WITH_AUDASPACE
   m_volume = volume;
   m_pitch = pitch;
+  m_priority = 0;
   m_is3d = is3d;
   m_3d = settings;
   m_type = type;
@@ -142,6 +143,7 @@ void SCA_SoundActuator::play()
       AUD_Handle_setLoopCount(m_handle, -1);
     AUD_Handle_setPitch(m_handle, m_pitch);
     AUD_Handle_setVolume(m_handle, m_volume);
+    AUD_Handle_setPriority(m_handle, m_priority);
   }
 
   m_isplaying = true;
@@ -343,6 +345,8 @@ PyAttributeDef SCA_SoundActuator::Attributes[] = {
         "time", SCA_SoundActuator, pyattr_get_audposition, pyattr_set_audposition),
     EXP_PYATTRIBUTE_RW_FUNCTION("volume", SCA_SoundActuator, pyattr_get_gain, pyattr_set_gain),
     EXP_PYATTRIBUTE_RW_FUNCTION("pitch", SCA_SoundActuator, pyattr_get_pitch, pyattr_set_pitch),
+    EXP_PYATTRIBUTE_RW_FUNCTION(
+        "priority", SCA_SoundActuator, pyattr_get_priority, pyattr_set_priority),
     EXP_PYATTRIBUTE_ENUM_RW("mode",
                             SCA_SoundActuator::KX_SOUNDACT_NODEF + 1,
                             SCA_SoundActuator::KX_SOUNDACT_MAX - 1,
@@ -480,6 +484,14 @@ PyObject *SCA_SoundActuator::pyattr_get_pitch(EXP_PyObjectPlus *self,
   return result;
 }
 
+PyObject *SCA_SoundActuator::pyattr_get_priority(EXP_PyObjectPlus *self,
+                                                 const struct EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  SCA_SoundActuator *actuator = static_cast<SCA_SoundActuator *>(self);
+
+  return PyLong_FromLong(actuator->m_priority);
+}
+
 PyObject *SCA_SoundActuator::pyattr_get_sound(EXP_PyObjectPlus *self,
                                               const struct EXP_PYATTRIBUTE_DEF *attrdef)
 {
@@ -627,6 +639,25 @@ int SCA_SoundActuator::pyattr_set_pitch(EXP_PyObjectPlus *self,
   return PY_SET_ATTR_SUCCESS;
 }
 
+int SCA_SoundActuator::pyattr_set_priority(EXP_PyObjectPlus *self,
+                                           const struct EXP_PYATTRIBUTE_DEF *attrdef,
+                                           PyObject *value)
+{
+  int priority = 0;
+  SCA_SoundActuator *actuator = static_cast<SCA_SoundActuator *>(self);
+  if (!PyArg_Parse(value, "i", &priority))
+    return PY_SET_ATTR_FAIL;
+
+  actuator->m_priority = priority;
+
+#  ifdef WITH_AUDASPACE
+  if (actuator->m_handle)
+    AUD_Handle_setPriority(actuator->m_handle, priority);
+#  endif  // WITH_AUDASPACE
+
+  return PY_SET_ATTR_SUCCESS;
+}
+
 int SCA_SoundActuator::pyattr_set_sound(EXP_PyObjectPlus *self,
                                         const struct EXP_PYATTRIBUTE_DEF *attrdef,
                                         PyObject *value)
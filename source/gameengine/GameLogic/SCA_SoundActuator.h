@@ -59,6 +59,8 @@ class SCA_SoundActuator : public SCA_IActuator {
 #endif  // WITH_AUDASPACE
   float m_volume;
   float m_pitch;
+  /// Priority of the sound when the mixer has more sounds than its voice budget.
+  int m_priority;
   bool m_is3d;
   KX_3DSoundSettings m_3d;
 
@@ -117,6 +119,9 @@ class SCA_SoundActuator : public SCA_IActuator {
   static int pyattr_set_pitch(EXP_PyObjectPlus *self,
                               const struct EXP_PYATTRIBUTE_DEF *attrdef,
                               PyObject *value);
+  static int pyattr_set_priority(EXP_PyObjectPlus *self,
+                                 const struct EXP_PYATTRIBUTE_DEF *attrdef,
+                                 PyObject *value);
   static int pyattr_set_type(EXP_PyObjectPlus *self,
                              const struct EXP_PYATTRIBUTE_DEF *attrdef,
                              PyObject *value);
@@ -132,6 +137,8 @@ class SCA_SoundActuator : public SCA_IActuator {
                                    const struct EXP_PYATTRIBUTE_DEF *attrdef);
   static PyObject *pyattr_get_pitch(EXP_PyObjectPlus *self,
                                     const struct EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_priority(EXP_PyObjectPlus *self,
+                                       const struct EXP_PYATTRIBUTE_DEF *attrdef);
   static PyObject *pyattr_get_type(EXP_PyObjectPlus *self,
                                    const struct EXP_PYATTRIBUTE_DEF *attrdef);
   static PyObject *pyattr_get_sound(EXP_PyObjectPlus *self,
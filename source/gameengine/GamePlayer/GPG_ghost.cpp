@@ -119,6 +119,7 @@
 #include "windowmanager/intern/wm_window_private.hh"
 
 #include "CM_Message.h"
+#include "CM_PoolAllocator.h"
 #include "KX_Globals.h"
 #include "KX_PythonInit.h"
 #include "LA_PlayerLauncher.h"
@@ -546,7 +547,31 @@ static void usage(const std::string &program, bool isBlenderPlayer)
   CM_Message("       show_camera_frustum            0         Show debug camera frustum volume");
   CM_Message(
       "       show_shadow_frustum            0         Show debug light shadow frustum volume");
-  CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings"
+  CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings");
+  CM_Message("       mesh_cache                     0         Use the converted mesh cache");
+  CM_Message("       bvh_cache                      0         Use the collision BVH cache");
+  CM_Message("       hull_max_vertices              0         Reduce the convex hull collision "
+             "shapes to their outer vertices, at most this number (0 disables)");
+  CM_Message("       warm_mesh_cache                0         Fill the converted mesh and "
+             "collision BVH caches for all the scenes and quit");
+  CM_Message("       trace_file                               Capture the frames timeline and "
+             "write it to this Chrome trace JSON file at the game end");
+  CM_Message("       benchmark_frames               0         Run this number of frames without "
+             "render, one logic step each, write the statistics and quit (0 disables)");
+  CM_Message("       benchmark_file                           File of the benchmark "
+             "statistics (default: benchmark.json)");
+  CM_Message("       benchmark_seed                 1         Seed of the random actuators "
+             "without seed and of the python random module in benchmark mode");
+  CM_Message("       audio_max_voices               0         Maximum number of sounds mixed, "
+             "the others are virtual (0 disables)");
+  CM_Message("       audio_virtual_volume           0.001     Volume under which the sounds are "
+             "virtual, they advance without being mixed (negative disables)");
+  CM_Message("       audio_render_threads           1         Number of threads reading the "
+             "sounds in parallel, decoding and effects included");
+  CM_Message("       frame_arena_stats              0         Report the allocations of the "
+             "frame arena in bge.logic.getProfileInfo()");
+  CM_Message("       pool_allocator                 0         Allocate the engine objects in "
+             "pools with per thread caches"
              << std::endl);
   CM_Message("  -p: override python main loop script");
   CM_Message(std::endl);
@@ -559,6 +584,12 @@ static void usage(const std::string &program, bool isBlenderPlayer)
                          << example_filename);
   CM_Message("example: " << program << " -i 232421 -m 16 " << example_pathname
                          << example_filename);
+  CM_Message("example: " << program << " -g warm_mesh_cache = 1 " << example_pathname
+                         << example_filename);
+  CM_Message("example: " << program << " -g trace_file = /tmp/trace.json " << example_pathname
+                         << example_filename);
+  CM_Message("example: " << program << " -w 100 100 -g benchmark_frames = 1000 -g benchmark_file = "
+                         << "result.json " << example_pathname << example_filename);
 }
 
 static void get_filename(int argc, char **argv, char *filename)
@@ -1363,6 +1394,9 @@ int main(int argc,
     usage(argv[0], isBlenderPlayer);
     return 0;
   }
+
+  // Set before the creation of any engine object, they are freed by the allocator of their mode.
+  CM_PoolAllocator::SetEnabled(SYS_GetCommandLineInt(syshandle, "pool_allocator", 0) != 0);
   GHOST_ISystem *system = nullptr;
 #ifdef WIN32
   if (scr_saver_mode != SCREEN_SAVER_MODE_CONFIGURATION)
@@ -47,36 +47,42 @@ void KX_NetworkMessageManager::AddMessage(KX_NetworkMessageManager::Message mess
   m_messages[m_currentList][message.to][message.subject].push_back(message);
 }
 
-const std::vector<KX_NetworkMessageManager::Message> KX_NetworkMessageManager::GetMessages(
-    std::string to, std::string subject)
+static void add_messages(const std::vector<KX_NetworkMessageManager::Message> &list,
+                         CM_FrameVector<const KX_NetworkMessageManager::Message *> &messages)
 {
-  std::vector<KX_NetworkMessageManager::Message> messages;
+  for (const KX_NetworkMessageManager::Message &message : list) {
+    messages.push_back(&message);
+  }
+}
+
+CM_FrameVector<const KX_NetworkMessageManager::Message *> KX_NetworkMessageManager::GetMessages(
+    const std::string &to, const std::string &subject)
+{
+  CM_FrameVector<const Message *> messages;
 
-  // look at messages without receiver.
-  std::map<std::string, std::vector<Message>> &messagesNoReceiver =
-      m_messages[1 - m_currentList][""];
-  std::map<std::string, std::vector<Message>> &messagesReceiver =
-      m_messages[1 - m_currentList][to];
-  if (subject.empty()) {
-    // Add all message without receiver and subject.
-    for (const auto &pair : messagesNoReceiver) {
-      messages.insert(messages.end(), pair.second.begin(), pair.second.end());
+  const std::map<std::string, std::map<std::string, std::vector<Message>>> &lastMessages =
+      m_messages[1 - m_currentList];
+
+  // look at messages without receiver and with the given receiver.
+  for (const std::string &receiver : {std::string(), to}) {
+    const auto it = lastMessages.find(receiver);
+    if (it == lastMessages.end()) {
+      continue;
+    }
+
+    if (subject.empty()) {
+      // Add all message of the receiver.
+      for (const auto &pair : it->second) {
+        add_messages(pair.second, messages);
+      }
     }
-    // Add all message with the given receiver and no subject.
-    for (const auto &pair : messagesReceiver) {
-      messages.insert(messages.end(), pair.second.begin(), pair.second.end());
+    else {
+      const auto subit = it->second.find(subject);
+      if (subit != it->second.end()) {
+        add_messages(subit->second, messages);
+      }
     }
   }
-  else {
-    std::vector<KX_NetworkMessageManager::Message> &messagesNoReceiverSubject =
-        messagesNoReceiver[subject];
-    messages.insert(
-        messages.end(), messagesNoReceiverSubject.begin(), messagesNoReceiverSubject.end());
-    std::vector<KX_NetworkMessageManager::Message> &messagesReceiverSubject =
-        messagesReceiver[subject];
-    messages.insert(
-        messages.end(), messagesReceiverSubject.begin(), messagesReceiverSubject.end());
-  }
 
   return messages;
 }
@@ -38,6 +38,8 @@ conflicts with KX_NetworkMessageManager::SendMessage */
 #include <string>
 #include <vector>
 
+#include "CM_FrameArena.h"
+
 class SCA_IObject;
 
 class KX_NetworkMessageManager {
@@ -74,10 +76,11 @@ class KX_NetworkMessageManager {
    */
   void AddMessage(Message message);
   /** Get all messages for a given receiver object name and message subject.
+   * The messages are valid until the next call to ClearMessages.
    * \param to The object(s) name.
    * \param subject The message subject/filter.
    */
-  const std::vector<Message> GetMessages(std::string to, std::string subject);
+  CM_FrameVector<const Message *> GetMessages(const std::string &to, const std::string &subject);
 
   /// Clear all messages
   void ClearMessages();
@@ -56,8 +56,8 @@ void KX_NetworkMessageScene::SendMessage(std::string to,
   m_messageManager->AddMessage(message);
 }
 
-const std::vector<KX_NetworkMessageManager::Message> KX_NetworkMessageScene::FindMessages(
-    std::string to, std::string subject)
+CM_FrameVector<const KX_NetworkMessageManager::Message *> KX_NetworkMessageScene::FindMessages(
+    const std::string &to, const std::string &subject)
 {
   return m_messageManager->GetMessages(to, subject);
 }
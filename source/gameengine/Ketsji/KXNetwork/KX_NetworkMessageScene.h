@@ -66,6 +66,6 @@ class KX_NetworkMessageScene {
    * \param to The object(s) name.
    * \param subject The message subject/filter.
    */
-  const std::vector<KX_NetworkMessageManager::Message> FindMessages(std::string to,
-                                                                    std::string subject);
+  CM_FrameVector<const KX_NetworkMessageManager::Message *> FindMessages(
+      const std::string &to, const std::string &subject);
 };
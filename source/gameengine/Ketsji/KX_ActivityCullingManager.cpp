@@ -0,0 +1,278 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_ActivityCullingManager.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_ActivityCullingManager.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "KX_GameObject.h"
+
+bool KX_ActivityCullingManager::CellKey::operator==(const CellKey &other) const
+{
+  return (m_x == other.m_x && m_y == other.m_y && m_z == other.m_z);
+}
+
+size_t KX_ActivityCullingManager::CellKeyHash::operator()(const CellKey &key) const
+{
+  // Large primes spatial hash.
+  return (size_t(key.m_x) * 73856093) ^ (size_t(key.m_y) * 19349663) ^
+         (size_t(key.m_z) * 83492791);
+}
+
+KX_ActivityCullingManager::KX_ActivityCullingManager()
+    : m_cellSize(0.0f), m_slices(1), m_frame(0), m_nextSlice(0)
+{
+}
+
+KX_ActivityCullingManager::~KX_ActivityCullingManager()
+{
+}
+
+KX_ActivityCullingManager::CellKey KX_ActivityCullingManager::GetCellKey(
+    const MT_Vector3 &pos) const
+{
+  return {int(std::floor(pos.x() / m_cellSize)),
+          int(std::floor(pos.y() / m_cellSize)),
+          int(std::floor(pos.z() / m_cellSize))};
+}
+
+void KX_ActivityCullingManager::AddToCell(KX_GameObject *gameobj,
+                                          Entry &entry,
+                                          const CellKey &key)
+{
+  const auto it = m_cells.find(key);
+  Cell *cell;
+  if (it == m_cells.end()) {
+    cell = &m_cells[key];
+    cell->m_key = key;
+    cell->m_minRadius = FLT_MAX;
+    cell->m_maxRadius = 0.0f;
+    cell->m_state = CELL_INVALID;
+    cell->m_slice = m_nextSlice++;
+  }
+  else {
+    cell = &it->second;
+  }
+
+  entry.m_cell = cell;
+  entry.m_cellIndex = cell->m_objects.size();
+  cell->m_objects.push_back(gameobj);
+}
+
+void KX_ActivityCullingManager::RemoveFromCell(Entry &entry)
+{
+  Cell *cell = entry.m_cell;
+  if (!cell) {
+    return;
+  }
+
+  // Swap with the last object of the cell.
+  KX_GameObject *last = cell->m_objects.back();
+  cell->m_objects[entry.m_cellIndex] = last;
+  m_entries[last].m_cellIndex = entry.m_cellIndex;
+  cell->m_objects.pop_back();
+
+  entry.m_cell = nullptr;
+
+  if (cell->m_objects.empty()) {
+    m_cells.erase(cell->m_key);
+  }
+}
+
+void KX_ActivityCullingManager::Relocate(KX_GameObject *gameobj, Entry &entry)
+{
+  const KX_GameObject::ActivityCullingInfo &info = gameobj->GetActivityCullingInfo();
+
+  float minRadius = FLT_MAX;
+  float maxRadius = 0.0f;
+  if (info.m_flags & KX_GameObject::ActivityCullingInfo::ACTIVITY_PHYSICS) {
+    minRadius = std::min(minRadius, info.m_physicsRadius);
+    maxRadius = std::max(maxRadius, info.m_physicsRadius);
+  }
+  if (info.m_flags & KX_GameObject::ActivityCullingInfo::ACTIVITY_LOGIC) {
+    minRadius = std::min(minRadius, info.m_logicRadius);
+    maxRadius = std::max(maxRadius, info.m_logicRadius);
+  }
+
+  // The object doesn't use activity culling anymore.
+  if (info.m_flags == KX_GameObject::ActivityCullingInfo::ACTIVITY_NONE) {
+    RemoveFromCell(entry);
+    return;
+  }
+
+  if (m_cellSize == 0.0f) {
+    m_cellSize = std::max(std::sqrt(maxRadius), 1.0f);
+  }
+
+  const CellKey key = GetCellKey(gameobj->NodeGetWorldPosition());
+  if (!entry.m_cell || !(entry.m_cell->m_key == key)) {
+    RemoveFromCell(entry);
+    AddToCell(gameobj, entry, key);
+  }
+
+  Cell &cell = *entry.m_cell;
+  // The radii range is only extended, it stays conservative when objects leave the cell.
+  if (minRadius < cell.m_minRadius || maxRadius > cell.m_maxRadius) {
+    cell.m_minRadius = std::min(cell.m_minRadius, minRadius);
+    cell.m_maxRadius = std::max(cell.m_maxRadius, maxRadius);
+    cell.m_state = CELL_INVALID;
+  }
+  else if (cell.m_state == CELL_ACTIVE) {
+    gameobj->UpdateActivity(0.0f);
+  }
+  else if (cell.m_state == CELL_INACTIVE) {
+    gameobj->UpdateActivity(FLT_MAX);
+  }
+}
+
+void KX_ActivityCullingManager::UpdateCell(Cell &cell, const std::vector<MT_Vector3> &camPositions)
+{
+  const MT_Vector3 low(cell.m_key.m_x * m_cellSize,
+                       cell.m_key.m_y * m_cellSize,
+                       cell.m_key.m_z * m_cellSize);
+  const MT_Vector3 high = low + MT_Vector3(m_cellSize, m_cellSize, m_cellSize);
+
+  /* The squared distance of any object of the cell to the nearest camera
+   * is in the range [nearest, farthest]. */
+  float nearest = FLT_MAX;
+  float farthest = FLT_MAX;
+  for (const MT_Vector3 &campos : camPositions) {
+    float mindist = 0.0f;
+    float maxdist = 0.0f;
+    for (unsigned short i = 0; i < 3; ++i) {
+      const float dlow = low[i] - campos[i];
+      const float dhigh = campos[i] - high[i];
+      const float d = std::max(std::max(dlow, dhigh), 0.0f);
+      mindist += d * d;
+      const float dfar = std::max(std::fabs(dlow), std::fabs(dhigh));
+      maxdist += dfar * dfar;
+    }
+    nearest = std::min(nearest, mindist);
+    farthest = std::min(farthest, maxdist);
+  }
+
+  CellState state;
+  if (farthest <= cell.m_minRadius) {
+    state = CELL_ACTIVE;
+  }
+  else if (nearest > cell.m_maxRadius) {
+    state = CELL_INACTIVE;
+  }
+  else {
+    state = CELL_MIXED;
+  }
+
+  if (state != CELL_MIXED) {
+    if (state != cell.m_state) {
+      const float distance = (state == CELL_ACTIVE) ? 0.0f : FLT_MAX;
+      for (KX_GameObject *gameobj : cell.m_objects) {
+        gameobj->UpdateActivity(distance);
+      }
+      cell.m_state = state;
+    }
+    return;
+  }
+
+  // In time sliced mode cells already crossing a radius are evaluated once every m_slices frames.
+  if (cell.m_state == CELL_MIXED && m_slices > 1 &&
+      (cell.m_slice % m_slices) != (m_frame % m_slices)) {
+    return;
+  }
+
+  for (KX_GameObject *gameobj : cell.m_objects) {
+    const MT_Vector3 &obpos = gameobj->NodeGetWorldPosition();
+    float dist = FLT_MAX;
+    for (const MT_Vector3 &campos : camPositions) {
+      dist = std::min(float((obpos - campos).length2()), dist);
+    }
+    gameobj->UpdateActivity(dist);
+  }
+  cell.m_state = CELL_MIXED;
+}
+
+void KX_ActivityCullingManager::Register(KX_GameObject *gameobj)
+{
+  if (m_entries.find(gameobj) != m_entries.end()) {
+    return;
+  }
+
+  Entry &entry = m_entries[gameobj];
+  entry.m_index = m_objects.size();
+  entry.m_cell = nullptr;
+  entry.m_cellIndex = 0;
+  m_objects.push_back(gameobj);
+
+  // Insert the object in the grid at the next update.
+  gameobj->GetSGNode()->SetDirty(SG_Node::DIRTY_ACTIVITY);
+}
+
+void KX_ActivityCullingManager::Unregister(KX_GameObject *gameobj)
+{
+  const auto it = m_entries.find(gameobj);
+  if (it == m_entries.end()) {
+    return;
+  }
+
+  Entry &entry = it->second;
+  RemoveFromCell(entry);
+
+  KX_GameObject *last = m_objects.back();
+  m_objects[entry.m_index] = last;
+  m_entries[last].m_index = entry.m_index;
+  m_objects.pop_back();
+
+  m_entries.erase(gameobj);
+}
+
+unsigned int KX_ActivityCullingManager::GetSlices() const
+{
+  return m_slices;
+}
+
+void KX_ActivityCullingManager::SetSlices(unsigned int slices)
+{
+  m_slices = std::max(slices, 1u);
+}
+
+void KX_ActivityCullingManager::Update(const std::vector<MT_Vector3> &camPositions)
+{
+  // Move the objects changing of position or culling settings in their new cell.
+  for (KX_GameObject *gameobj : m_objects) {
+    SG_Node *node = gameobj->GetSGNode();
+    if (node->IsDirty(SG_Node::DIRTY_ACTIVITY)) {
+      Relocate(gameobj, m_entries[gameobj]);
+      node->ClearDirty(SG_Node::DIRTY_ACTIVITY);
+    }
+  }
+
+  for (auto &pair : m_cells) {
+    UpdateCell(pair.second, camPositions);
+  }
+
+  ++m_frame;
+}
@@ -0,0 +1,110 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_ActivityCullingManager.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "MT_Vector3.h"
+
+class KX_GameObject;
+
+/** Spatial grid of the objects using activity culling.
+ *
+ * Objects are binned in cells, each cell stores the range of the culling radii of its objects.
+ * A cell entirely inside or outside of the radii of all its objects for the activity culling
+ * cameras is updated as a whole and only when its state changes, the objects of the cells
+ * crossing a radius boundary are evaluated individually.
+ */
+class KX_ActivityCullingManager {
+ private:
+  enum CellState { CELL_INVALID = 0, CELL_ACTIVE, CELL_INACTIVE, CELL_MIXED };
+
+  struct CellKey {
+    int m_x;
+    int m_y;
+    int m_z;
+
+    bool operator==(const CellKey &other) const;
+  };
+
+  struct CellKeyHash {
+    size_t operator()(const CellKey &key) const;
+  };
+
+  struct Cell {
+    CellKey m_key;
+    std::vector<KX_GameObject *> m_objects;
+    /// Squared minimum and maximum culling radius of the objects in the cell.
+    float m_minRadius;
+    float m_maxRadius;
+    CellState m_state;
+    /// Time slice of the cell.
+    unsigned int m_slice;
+  };
+
+  struct Entry {
+    /// Index of the object in m_objects.
+    unsigned int m_index;
+    /// Cell containing the object, nullptr when the object doesn't use activity culling.
+    Cell *m_cell;
+    /// Index of the object in the cell.
+    unsigned int m_cellIndex;
+  };
+
+  std::unordered_map<CellKey, Cell, CellKeyHash> m_cells;
+  std::unordered_map<KX_GameObject *, Entry> m_entries;
+  /// All registered objects, iterated to find moved objects.
+  std::vector<KX_GameObject *> m_objects;
+
+  /// Size of a cell, computed from the first culled object.
+  float m_cellSize;
+  /// Number of frames to evaluate all the cells crossing a radius boundary.
+  unsigned int m_slices;
+  unsigned int m_frame;
+  unsigned int m_nextSlice;
+
+  CellKey GetCellKey(const MT_Vector3 &pos) const;
+  void AddToCell(KX_GameObject *gameobj, Entry &entry, const CellKey &key);
+  void RemoveFromCell(Entry &entry);
+  /// Update the cell of an object after a move or a change of its culling settings.
+  void Relocate(KX_GameObject *gameobj, Entry &entry);
+  void UpdateCell(Cell &cell, const std::vector<MT_Vector3> &camPositions);
+
+ public:
+  KX_ActivityCullingManager();
+  ~KX_ActivityCullingManager();
+
+  void Register(KX_GameObject *gameobj);
+  void Unregister(KX_GameObject *gameobj);
+
+  unsigned int GetSlices() const;
+  void SetSlices(unsigned int slices);
+
+  /// Suspend or restore the objects depending on their distance to the cameras.
+  void Update(const std::vector<MT_Vector3> &camPositions);
+};
@@ -350,6 +350,9 @@ PyMethodDef KX_Camera::Methods[] = {
     EXP_PYMETHODTABLE(KX_Camera, sphereInsideFrustum),
     EXP_PYMETHODTABLE_O(KX_Camera, boxInsideFrustum),
     EXP_PYMETHODTABLE_O(KX_Camera, pointInsideFrustum),
+    EXP_PYMETHODTABLE_O(KX_Camera, cullObjects),
+    EXP_PYMETHODTABLE_O(KX_Camera, cullSpheres),
+    EXP_PYMETHODTABLE_O(KX_Camera, cullBoxes),
     EXP_PYMETHODTABLE_NOARGS(KX_Camera, getCameraToWorld),
     EXP_PYMETHODTABLE_NOARGS(KX_Camera, getWorldToCamera),
     EXP_PYMETHODTABLE(KX_Camera, setViewport),
@@ -553,6 +556,169 @@ EXP_PYMETHODDEF_DOC_O(KX_Camera,
   return nullptr;
 }
 
+/// Convert the visibility bits of the bulk frustum tests to a list of booleans.
+static PyObject *visibility_mask_to_list(const std::vector<uint32_t> &mask, unsigned int count)
+{
+  PyObject *list = PyList_New(count);
+  for (unsigned int i = 0; i < count; ++i) {
+    PyList_SET_ITEM(list, i, PyBool_FromLong((mask[i / 32] >> (i % 32)) & 1));
+  }
+
+  return list;
+}
+
+/** Read a float buffer of items made of stride values to one array per item value.
+ * \return The number of items or -1 on error.
+ */
+static int float_buffer_to_arrays(PyObject *value,
+                                  unsigned int stride,
+                                  std::vector<std::vector<float>> &arrays,
+                                  const char *error_prefix)
+{
+  Py_buffer view;
+  if (PyObject_GetBuffer(value, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) {
+    return -1;
+  }
+
+  if (view.itemsize != sizeof(float) || !view.format || strcmp(view.format, "f") != 0 ||
+      (view.len / sizeof(float)) % stride != 0)
+  {
+    PyErr_Format(PyExc_ValueError,
+                 "%s expected a buffer of 32 bits floats of size multiple of %u",
+                 error_prefix,
+                 stride);
+    PyBuffer_Release(&view);
+    return -1;
+  }
+
+  const unsigned int count = view.len / sizeof(float) / stride;
+  const float *data = (const float *)view.buf;
+
+  arrays.resize(stride);
+  for (std::vector<float> &array : arrays) {
+    array.resize(count);
+  }
+  for (unsigned int i = 0; i < count; ++i) {
+    for (unsigned int j = 0; j < stride; ++j) {
+      arrays[j][i] = data[i * stride + j];
+    }
+  }
+
+  PyBuffer_Release(&view);
+
+  return count;
+}
+
+EXP_PYMETHODDEF_DOC_O(KX_Camera,
+                      cullObjects,
+                      "cullObjects(objects) -> list\n"
+                      "\treturns for each object True if its bounding box is not outside\n"
+                      "\tthis camera's viewing frustum.\n\n"
+                      "\tobjects = a list of KX_GameObject or object names\n")
+{
+  if (!PySequence_Check(value)) {
+    PyErr_SetString(PyExc_TypeError,
+                    "camera.cullObjects(objects): KX_Camera, expected a list of objects");
+    return nullptr;
+  }
+
+  const Py_ssize_t size = PySequence_Size(value);
+  if (size == -1) {
+    return nullptr;
+  }
+
+  const unsigned int count = size;
+  std::array<std::vector<float>, 6> bounds;
+  for (std::vector<float> &array : bounds) {
+    array.resize(count);
+  }
+
+  SCA_LogicManager *logicmgr = GetScene()->GetLogicManager();
+  for (unsigned int i = 0; i < count; ++i) {
+    PyObject *item = PySequence_GetItem(value, i); /* new ref */
+    if (!item) {
+      return nullptr;
+    }
+
+    KX_GameObject *gameobj;
+    const bool error = !ConvertPythonToGameObject(
+        logicmgr, item, &gameobj, false, "camera.cullObjects(objects): KX_Camera");
+    Py_DECREF(item);
+    if (error) {
+      return nullptr;
+    }
+
+    MT_Vector3 min;
+    MT_Vector3 max;
+    gameobj->GetWorldAabb(min, max);
+    for (unsigned short axis = 0; axis < 3; ++axis) {
+      bounds[axis][i] = min[axis];
+      bounds[axis + 3][i] = max[axis];
+    }
+  }
+
+  std::vector<uint32_t> mask((count + 31) / 32);
+  GetFrustum().AabbsInsideFrustum(bounds[0].data(),
+                                  bounds[1].data(),
+                                  bounds[2].data(),
+                                  bounds[3].data(),
+                                  bounds[4].data(),
+                                  bounds[5].data(),
+                                  count,
+                                  mask.data());
+
+  return visibility_mask_to_list(mask, count);
+}
+
+EXP_PYMETHODDEF_DOC_O(KX_Camera,
+                      cullSpheres,
+                      "cullSpheres(spheres) -> list\n"
+                      "\treturns for each sphere True if it is not outside this camera's\n"
+                      "\tviewing frustum.\n\n"
+                      "\tspheres = a buffer of floats, 4 per sphere: center x, y, z and radius\n"
+                      "\t(in world coordinates.)\n")
+{
+  std::vector<std::vector<float>> arrays;
+  const int count = float_buffer_to_arrays(
+      value, 4, arrays, "camera.cullSpheres(spheres): KX_Camera,");
+  if (count == -1) {
+    return nullptr;
+  }
+
+  std::vector<uint32_t> mask((count + 31) / 32);
+  GetFrustum().SpheresInsideFrustum(
+      arrays[0].data(), arrays[1].data(), arrays[2].data(), arrays[3].data(), count, mask.data());
+
+  return visibility_mask_to_list(mask, count);
+}
+
+EXP_PYMETHODDEF_DOC_O(KX_Camera,
+                      cullBoxes,
+                      "cullBoxes(boxes) -> list\n"
+                      "\treturns for each axis aligned box True if it is not outside this\n"
+                      "\tcamera's viewing frustum.\n\n"
+                      "\tboxes = a buffer of floats, 6 per box: minimum x, y, z and maximum\n"
+                      "\tx, y, z (in world coordinates.)\n")
+{
+  std::vector<std::vector<float>> arrays;
+  const int count = float_buffer_to_arrays(value, 6, arrays, "camera.cullBoxes(boxes): KX_Camera,");
+  if (count == -1) {
+    return nullptr;
+  }
+
+  std::vector<uint32_t> mask((count + 31) / 32);
+  GetFrustum().AabbsInsideFrustum(arrays[0].data(),
+                                  arrays[1].data(),
+                                  arrays[2].data(),
+                                  arrays[3].data(),
+                                  arrays[4].data(),
+                                  arrays[5].data(),
+                                  count,
+                                  mask.data());
+
+  return visibility_mask_to_list(mask, count);
+}
+
 EXP_PYMETHODDEF_DOC_NOARGS(
     KX_Camera,
     getCameraToWorld,
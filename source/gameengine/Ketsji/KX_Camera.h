@@ -250,6 +250,9 @@ class KX_Camera : public KX_GameObject {
   EXP_PYMETHOD_DOC_VARARGS(KX_Camera, sphereInsideFrustum);
   EXP_PYMETHOD_DOC_O(KX_Camera, boxInsideFrustum);
   EXP_PYMETHOD_DOC_O(KX_Camera, pointInsideFrustum);
+  EXP_PYMETHOD_DOC_O(KX_Camera, cullObjects);
+  EXP_PYMETHOD_DOC_O(KX_Camera, cullSpheres);
+  EXP_PYMETHOD_DOC_O(KX_Camera, cullBoxes);
 
   EXP_PYMETHOD_DOC_NOARGS(KX_Camera, getCameraToWorld);
   EXP_PYMETHOD_DOC_NOARGS(KX_Camera, getWorldToCamera);
@@ -294,7 +294,7 @@ void KX_GameObject::TagForTransformUpdate(bool is_overlay_pass, bool is_last_ren
     }
 
     if (!staticObject || m_forceIgnoreParentTx) {
-      std::vector<KX_GameObject *> children = GetChildren();
+      const CM_FrameVector<KX_GameObject *> children = GetFrameChildren();
       if (children.size() > 0) {
         std::vector<Object *> childrenObjects;
         for (KX_GameObject *go : children) {
@@ -570,6 +570,15 @@ KX_GameObject::ActivityCullingInfo &KX_GameObject::GetActivityCullingInfo()
 void KX_GameObject::SetActivityCullingInfo(const ActivityCullingInfo &cullingInfo)
 {
   m_activityCullingInfo = cullingInfo;
+  InvalidateActivityCulling();
+}
+
+void KX_GameObject::InvalidateActivityCulling()
+{
+  // Request the activity culling manager to update the object cell.
+  if (m_pSGNode) {
+    m_pSGNode->SetDirty(SG_Node::DIRTY_ACTIVITY);
+  }
 }
 
 void KX_GameObject::SetActivityCulling(ActivityCullingInfo::Flag flag, bool enable)
@@ -590,6 +599,8 @@ void KX_GameObject::SetActivityCulling(ActivityCullingInfo::Flag flag, bool enab
       RestoreLogicAndActions(false);
     }
   }
+
+  InvalidateActivityCulling();
 }
 
 void KX_GameObject::AddDummyLodManager(RAS_MeshObject *meshObj, Object *ob)
@@ -1722,6 +1733,40 @@ MT_Transform KX_GameObject::NodeGetLocalTransform() const
   return m_pSGNode->GetLocalTransform();
 }
 
+void KX_GameObject::GetWorldAabb(MT_Vector3 &min, MT_Vector3 &max)
+{
+  MT_Vector3 center(0.0f, 0.0f, 0.0f);
+  MT_Vector3 extent(0.0f, 0.0f, 0.0f);
+
+  Object *ob = GetBlenderObject();
+  if (ob) {
+    bContext *C = KX_GetActiveEngine()->GetContext();
+    Depsgraph *depsgraph = CTX_data_expect_evaluated_depsgraph(C);
+    Object *ob_eval = DEG_get_evaluated_object(depsgraph, ob);
+    if (const std::optional<blender::Bounds<blender::float3>> bounds = BKE_object_boundbox_get(
+            ob_eval))
+    {
+      const blender::float3 bcenter = (bounds->min + bounds->max) * 0.5f;
+      const blender::float3 bextent = (bounds->max - bounds->min) * 0.5f;
+      center.setValue(bcenter.x, bcenter.y, bcenter.z);
+      extent.setValue(bextent.x, bextent.y, bextent.z);
+    }
+  }
+
+  // Transform the center and the extent projected on each world axis.
+  const MT_Transform trans = NodeGetWorldTransform();
+  const MT_Matrix3x3 &basis = trans.getBasis();
+  const MT_Vector3 wcenter = trans(center);
+  MT_Vector3 wextent;
+  for (unsigned short i = 0; i < 3; ++i) {
+    wextent[i] = fabs(basis[i][0]) * extent[0] + fabs(basis[i][1]) * extent[1] +
+                 fabs(basis[i][2]) * extent[2];
+  }
+
+  min = wcenter - wextent;
+  max = wcenter + wextent;
+}
+
 void KX_GameObject::UnregisterCollisionCallbacks()
 {
   if (!GetPhysicsController()) {
@@ -1831,8 +1876,7 @@ void KX_GameObject::RunOnRemoveCallbacks()
 //  }
 //}
 
-template<bool recursive>
-static void walk_children(const SG_Node *node, std::vector<KX_GameObject *> &list)
+template<bool recursive, class List> static void walk_children(const SG_Node *node, List &list)
 {
   if (!node) {
     return;
@@ -1861,6 +1905,13 @@ std::vector<KX_GameObject *> KX_GameObject::GetChildren() const
   return list;
 }
 
+CM_FrameVector<KX_GameObject *> KX_GameObject::GetFrameChildren() const
+{
+  CM_FrameVector<KX_GameObject *> list;
+  walk_children<false>(GetSGNode(), list);
+  return list;
+}
+
 std::vector<KX_GameObject *> KX_GameObject::GetChildrenRecursive() const
 {
   std::vector<KX_GameObject *> list;
@@ -1884,21 +1935,6 @@ void KX_GameObject::SetComponents(EXP_ListValue<KX_PythonComponent> *components)
 #endif
 }
 
-void KX_GameObject::Update()
-{
-#ifdef WITH_PYTHON
-  if (!m_logicSuspended) {
-    if (m_components) {
-      for (KX_PythonComponent *comp : m_components) {
-        comp->Update();
-      }
-    }
-
-    KX_PythonProxy::Update();
-  }
-#endif  // WITH_PYTHON
-}
-
 KX_Scene *KX_GameObject::GetScene()
 {
   BLI_assert(m_pSGNode);
@@ -3238,6 +3274,7 @@ int KX_GameObject::pyattr_set_physicsCullingRadius(EXP_PyObjectPlus *self_v,
   }
 
   self->GetActivityCullingInfo().m_physicsRadius = val * val;
+  self->InvalidateActivityCulling();
 
   return PY_SET_ATTR_SUCCESS;
 }
@@ -3263,6 +3300,7 @@ int KX_GameObject::pyattr_set_logicCullingRadius(EXP_PyObjectPlus *self_v,
   }
 
   self->GetActivityCullingInfo().m_logicRadius = val * val;
+  self->InvalidateActivityCulling();
 
   return PY_SET_ATTR_SUCCESS;
 }
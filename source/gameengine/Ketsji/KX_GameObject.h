@@ -43,6 +43,7 @@
 #include "DNA_constraint_types.h" /* for constraint replication */
 #include "DNA_object_types.h"
 
+#include "CM_FrameArena.h"
 #include "EXP_ListValue.h"
 #include "KX_KetsjiEngine.h" /* for m_anim_framerate */
 #include "KX_Scene.h"
@@ -484,6 +485,11 @@ class KX_GameObject : public SCA_IObject {
   const MT_Vector3 &NodeGetLocalPosition() const;
   MT_Transform NodeGetLocalTransform() const;
 
+  /** Compute the world space AABB of the evaluated object bounds, an object without bounds
+   * is reduced to its world position.
+   */
+  void GetWorldAabb(MT_Vector3 &min, MT_Vector3 &max);
+
   /**
    * \section scene graph node accessor functions.
    */
@@ -729,6 +735,8 @@ class KX_GameObject : public SCA_IObject {
   void SetActivityCullingInfo(const ActivityCullingInfo &cullingInfo);
   /// Enable or disable a category of object activity culling.
   void SetActivityCulling(ActivityCullingInfo::Flag flag, bool enable);
+  /// Notify a change of the activity culling settings.
+  void InvalidateActivityCulling();
 
   /**
    * \section Logic bubbling methods.
@@ -763,6 +771,8 @@ class KX_GameObject : public SCA_IObject {
   }
 
   std::vector<KX_GameObject *> GetChildren() const;
+  /// Return the children in the frame arena, valid until the end of the next logic frame.
+  CM_FrameVector<KX_GameObject *> GetFrameChildren() const;
   std::vector<KX_GameObject *> GetChildrenRecursive() const;
 
   /// Returns the component list.
@@ -774,8 +784,6 @@ class KX_GameObject : public SCA_IObject {
 
   virtual void SetScene(KX_Scene *scene);
 
-  virtual void Update();
-
 #ifdef WITH_PYTHON
   /**
    * \section Python interface functions.
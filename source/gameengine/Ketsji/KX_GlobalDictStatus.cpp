@@ -0,0 +1,247 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_GlobalDictStatus.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_GlobalDictStatus.h"
+
+#include "BLI_time.h"
+
+#include "CM_Message.h"
+
+#ifdef WITH_PYTHON
+#  include "KX_PythonInit.h"
+#endif
+
+KX_GlobalDictStatus::KX_GlobalDictStatus(Mode mode,
+                                         const std::string &path,
+                                         unsigned int sequence)
+    : m_mode(mode),
+      m_path(path),
+      m_sequence(sequence),
+      m_done(false),
+      m_finished(false),
+      m_success(false)
+#ifdef WITH_PYTHON
+      ,
+      m_finish_cb(nullptr)
+#endif
+{
+  m_endtime = m_starttime = BLI_time_now_seconds();
+}
+
+KX_GlobalDictStatus::~KX_GlobalDictStatus()
+{
+#ifdef WITH_PYTHON
+  Py_XDECREF(m_finish_cb);
+#endif
+}
+
+std::string KX_GlobalDictStatus::GetName()
+{
+  return "KX_GlobalDictStatus";
+}
+
+KX_GlobalDictStatus::Mode KX_GlobalDictStatus::GetMode() const
+{
+  return m_mode;
+}
+
+const std::string &KX_GlobalDictStatus::GetPath() const
+{
+  return m_path;
+}
+
+std::vector<char> &KX_GlobalDictStatus::GetData()
+{
+  return m_data;
+}
+
+unsigned int KX_GlobalDictStatus::GetSequence() const
+{
+  return m_sequence;
+}
+
+void KX_GlobalDictStatus::SetDone(bool success, const std::string &error)
+{
+  m_success = success;
+  m_error = error;
+  m_done.store(true, std::memory_order_release);
+}
+
+bool KX_GlobalDictStatus::IsDone() const
+{
+  return m_done.load(std::memory_order_acquire);
+}
+
+void KX_GlobalDictStatus::Finish()
+{
+#ifdef WITH_PYTHON
+  if (m_success && m_mode == MODE_LOAD && !restoreGamePythonConfig(m_data)) {
+    m_success = false;
+    m_error = "could not unmarshal '" + m_path + "'";
+  }
+#endif
+
+  if (!m_success) {
+    CM_Error(m_error);
+  }
+
+  // The marshaled data is not needed anymore.
+  std::vector<char>().swap(m_data);
+
+  m_finished = true;
+  m_endtime = BLI_time_now_seconds();
+
+#ifdef WITH_PYTHON
+  if (m_finish_cb) {
+    PyObject *args = Py_BuildValue("(O)", GetProxy());
+
+    if (!PyObject_Call(m_finish_cb, args, nullptr)) {
+      PyErr_Print();
+      PyErr_Clear();
+    }
+
+    Py_DECREF(args);
+  }
+#endif
+}
+
+bool KX_GlobalDictStatus::IsFinished() const
+{
+  return m_finished;
+}
+
+#ifdef WITH_PYTHON
+
+PyMethodDef KX_GlobalDictStatus::Methods[] = {
+    {nullptr, nullptr}  // Sentinel
+};
+
+PyAttributeDef KX_GlobalDictStatus::Attributes[] = {
+    EXP_PYATTRIBUTE_RW_FUNCTION(
+        "onFinish", KX_GlobalDictStatus, pyattr_get_onfinish, pyattr_set_onfinish),
+    EXP_PYATTRIBUTE_BOOL_RO("finished", KX_GlobalDictStatus, m_finished),
+    EXP_PYATTRIBUTE_RO_FUNCTION("success", KX_GlobalDictStatus, pyattr_get_success),
+    EXP_PYATTRIBUTE_RO_FUNCTION("error", KX_GlobalDictStatus, pyattr_get_error),
+    EXP_PYATTRIBUTE_STRING_RO("fileName", KX_GlobalDictStatus, m_path),
+    EXP_PYATTRIBUTE_RO_FUNCTION("timeTaken", KX_GlobalDictStatus, pyattr_get_timetaken),
+    EXP_PYATTRIBUTE_NULL  // Sentinel
+};
+
+PyTypeObject KX_GlobalDictStatus::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "KX_GlobalDictStatus",
+                                          sizeof(EXP_PyObjectPlus_Proxy),
+                                          0,
+                                          py_base_dealloc,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          py_base_repr,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          Methods,
+                                          0,
+                                          0,
+                                          &EXP_Value::Type,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          py_base_new};
+
+PyObject *KX_GlobalDictStatus::pyattr_get_onfinish(EXP_PyObjectPlus *self_v,
+                                                   const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_GlobalDictStatus *self = static_cast<KX_GlobalDictStatus *>(self_v);
+
+  if (self->m_finish_cb) {
+    Py_INCREF(self->m_finish_cb);
+    return self->m_finish_cb;
+  }
+
+  Py_RETURN_NONE;
+}
+
+int KX_GlobalDictStatus::pyattr_set_onfinish(EXP_PyObjectPlus *self_v,
+                                             const EXP_PYATTRIBUTE_DEF *attrdef,
+                                             PyObject *value)
+{
+  KX_GlobalDictStatus *self = static_cast<KX_GlobalDictStatus *>(self_v);
+
+  if (!PyCallable_Check(value)) {
+    PyErr_SetString(PyExc_TypeError, "KX_GlobalDictStatus.onFinish requires a callable object");
+    return PY_SET_ATTR_FAIL;
+  }
+
+  Py_XDECREF(self->m_finish_cb);
+
+  Py_INCREF(value);
+  self->m_finish_cb = value;
+
+  return PY_SET_ATTR_SUCCESS;
+}
+
+PyObject *KX_GlobalDictStatus::pyattr_get_timetaken(EXP_PyObjectPlus *self_v,
+                                                    const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_GlobalDictStatus *self = static_cast<KX_GlobalDictStatus *>(self_v);
+
+  return PyFloat_FromDouble(self->m_endtime - self->m_starttime);
+}
+
+PyObject *KX_GlobalDictStatus::pyattr_get_success(EXP_PyObjectPlus *self_v,
+                                                  const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_GlobalDictStatus *self = static_cast<KX_GlobalDictStatus *>(self_v);
+
+  // The result written by the worker is only read once finished.
+  return PyBool_FromLong(self->m_finished && self->m_success);
+}
+
+PyObject *KX_GlobalDictStatus::pyattr_get_error(EXP_PyObjectPlus *self_v,
+                                                const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_GlobalDictStatus *self = static_cast<KX_GlobalDictStatus *>(self_v);
+
+  return PyUnicode_FromStdString(self->m_finished ? self->m_error : "");
+}
+#endif  // WITH_PYTHON
@@ -0,0 +1,96 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_GlobalDictStatus.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "EXP_Value.h"
+
+/// Status of a background save or load of bge.logic.globalDict.
+class KX_GlobalDictStatus : public EXP_Value {
+  Py_Header
+
+ public:
+  enum Mode { MODE_SAVE = 0, MODE_LOAD };
+
+ private:
+  Mode m_mode;
+  std::string m_path;
+  /// Marshaled dictionary, written by a save or read by a load.
+  std::vector<char> m_data;
+  /// Order of the save, used to never replace a file by an older save.
+  unsigned int m_sequence;
+
+  /// Set by the worker once the file operation is done.
+  std::atomic<bool> m_done;
+  /// Set on the main thread once the result is applied and the callback called.
+  bool m_finished;
+  /// Result of the operation, written by the worker before m_done.
+  bool m_success;
+  std::string m_error;
+
+  double m_starttime;
+  double m_endtime;
+
+#ifdef WITH_PYTHON
+  PyObject *m_finish_cb;
+#endif
+
+ public:
+  KX_GlobalDictStatus(Mode mode, const std::string &path, unsigned int sequence);
+  virtual ~KX_GlobalDictStatus();
+
+  virtual std::string GetName();
+
+  Mode GetMode() const;
+  const std::string &GetPath() const;
+  std::vector<char> &GetData();
+  unsigned int GetSequence() const;
+
+  /// Called by the worker thread at the end of the file operation.
+  void SetDone(bool success, const std::string &error);
+  bool IsDone() const;
+
+  /// Restore the loaded dictionary and run the finish callback, called on the main thread.
+  void Finish();
+  bool IsFinished() const;
+
+#ifdef WITH_PYTHON
+  static PyObject *pyattr_get_onfinish(EXP_PyObjectPlus *self_v,
+                                       const EXP_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_set_onfinish(EXP_PyObjectPlus *self_v,
+                                 const EXP_PYATTRIBUTE_DEF *attrdef,
+                                 PyObject *value);
+  static PyObject *pyattr_get_timetaken(EXP_PyObjectPlus *self_v,
+                                        const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_success(EXP_PyObjectPlus *self_v,
+                                      const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_error(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
+#endif
+};
@@ -0,0 +1,259 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_GlobalDictStorage.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_GlobalDictStorage.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "BLI_fileops.h"
+#include "BLI_task.h"
+
+#include "KX_GlobalDictStatus.h"
+
+/// Header of the compressed files, followed by a zstd stream of the marshaled dictionary.
+struct GlobalDictHeader {
+  char m_magic[4];
+  uint32_t m_version;
+  uint64_t m_size;
+};
+
+static const char globalDictMagic[4] = {'B', 'G', 'E', 'Z'};
+static const uint32_t globalDictVersion = 1;
+/// Fast compression level, the saves are expected to be frequent.
+static const int globalDictCompressionLevel = 3;
+/** Maximum size ratio of the data to its zstd stream, reached by a 128KB block of a repeated
+ * byte stored in 4 bytes, a larger size in the header means a corrupted file. */
+static const uint64_t globalDictMaxRatio = 32768;
+
+KX_GlobalDictStorage::KX_GlobalDictStorage() : m_nextSequence(1)
+{
+  m_pool = BLI_task_pool_create(this, TASK_PRIORITY_LOW);
+}
+
+KX_GlobalDictStorage::~KX_GlobalDictStorage()
+{
+  // The operations are normally finished by Finalize(), while the interpreter is still alive.
+  Wait();
+  for (KX_GlobalDictStatus *status : m_pending) {
+    status->Release();
+  }
+
+  BLI_task_pool_free(m_pool);
+}
+
+bool KX_GlobalDictStorage::WriteFile(const std::string &path,
+                                     const std::vector<char> &data,
+                                     bool compress,
+                                     std::string &error)
+{
+  const std::string tmppath = path + ".tmp";
+
+  FILE *fp = BLI_fopen(tmppath.c_str(), "wb");
+  if (!fp) {
+    error = "could not open marshal file '" + tmppath + "'";
+    return false;
+  }
+
+  bool written;
+  if (compress) {
+    GlobalDictHeader header;
+    memcpy(header.m_magic, globalDictMagic, sizeof(header.m_magic));
+    header.m_version = globalDictVersion;
+    header.m_size = data.size();
+
+    written = (fwrite(&header, sizeof(header), 1, fp) == 1) &&
+              (BLI_file_zstd_from_mem_at_pos(const_cast<char *>(data.data()),
+                                             data.size(),
+                                             fp,
+                                             sizeof(header),
+                                             globalDictCompressionLevel) != 0);
+  }
+  else {
+    written = (fwrite(data.data(), 1, data.size(), fp) == data.size());
+  }
+
+  if (fclose(fp) != 0) {
+    written = false;
+  }
+
+  if (!written) {
+    BLI_delete(tmppath.c_str(), false, false);
+    error = "could not write marshal data to '" + tmppath + "'";
+    return false;
+  }
+
+  // Replace the previous file only once the new one is complete.
+  if (BLI_rename_overwrite(tmppath.c_str(), path.c_str()) != 0) {
+    BLI_delete(tmppath.c_str(), false, false);
+    error = "could not rename '" + tmppath + "' to '" + path + "'";
+    return false;
+  }
+
+  return true;
+}
+
+bool KX_GlobalDictStorage::ReadFile(const std::string &path,
+                                    std::vector<char> &data,
+                                    std::string &error)
+{
+  FILE *fp = BLI_fopen(path.c_str(), "rb");
+  if (!fp) {
+    error = "could not open '" + path + "'";
+    return false;
+  }
+
+  fseek(fp, 0, SEEK_END);
+  const long length = ftell(fp);
+  if (length == -1) {
+    error = "could not read position of '" + path + "'";
+    fclose(fp);
+    return false;
+  }
+  rewind(fp);
+
+  GlobalDictHeader header;
+  const bool compressed = (size_t(length) >= sizeof(header)) &&
+                          (fread(&header, sizeof(header), 1, fp) == 1) &&
+                          (memcmp(header.m_magic, globalDictMagic, sizeof(header.m_magic)) == 0);
+
+  bool success;
+  if (compressed) {
+    if (header.m_version != globalDictVersion) {
+      error = "unsupported version of '" + path + "'";
+      fclose(fp);
+      return false;
+    }
+    if (header.m_size > (uint64_t(length) - sizeof(header)) * globalDictMaxRatio) {
+      error = "corrupted size in '" + path + "'";
+      fclose(fp);
+      return false;
+    }
+    data.resize(header.m_size);
+    success = (BLI_file_unzstd_to_mem_at_pos(data.data(), data.size(), fp, sizeof(header)) ==
+               data.size());
+  }
+  else {
+    // Raw marshal data written by the synchronous saves.
+    rewind(fp);
+    data.resize(length);
+    success = (fread(data.data(), 1, length, fp) == size_t(length));
+  }
+
+  fclose(fp);
+
+  if (!success) {
+    error = "could not read all of '" + path + "'";
+    data.clear();
+  }
+
+  return success;
+}
+
+void KX_GlobalDictStorage::SaveTask(TaskPool *__restrict pool, void *taskdata)
+{
+  KX_GlobalDictStorage *storage = (KX_GlobalDictStorage *)BLI_task_pool_user_data(pool);
+  KX_GlobalDictStatus *status = (KX_GlobalDictStatus *)taskdata;
+
+  bool success = true;
+  std::string error;
+
+  storage->m_writeMutex.Lock();
+  // A more recent save of the same file is already written.
+  unsigned int &lastWritten = storage->m_lastWritten[status->GetPath()];
+  if (status->GetSequence() > lastWritten) {
+    success = WriteFile(status->GetPath(), status->GetData(), true, error);
+    if (success) {
+      lastWritten = status->GetSequence();
+    }
+  }
+  storage->m_writeMutex.Unlock();
+
+  status->SetDone(success, error);
+}
+
+void KX_GlobalDictStorage::LoadTask(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  KX_GlobalDictStatus *status = (KX_GlobalDictStatus *)taskdata;
+
+  std::string error;
+  const bool success = ReadFile(status->GetPath(), status->GetData(), error);
+
+  status->SetDone(success, error);
+}
+
+KX_GlobalDictStatus *KX_GlobalDictStorage::SaveAsync(const std::string &path,
+                                                     std::vector<char> &&data)
+{
+  KX_GlobalDictStatus *status = new KX_GlobalDictStatus(
+      KX_GlobalDictStatus::MODE_SAVE, path, m_nextSequence++);
+  status->GetData() = std::move(data);
+
+  // The storage keeps a reference until the status is finished.
+  m_pending.push_back(CM_AddRef(status));
+  BLI_task_pool_push(m_pool, SaveTask, status, false, nullptr);
+
+  return status;
+}
+
+KX_GlobalDictStatus *KX_GlobalDictStorage::LoadAsync(const std::string &path)
+{
+  KX_GlobalDictStatus *status = new KX_GlobalDictStatus(KX_GlobalDictStatus::MODE_LOAD, path, 0);
+
+  m_pending.push_back(CM_AddRef(status));
+  BLI_task_pool_push(m_pool, LoadTask, status, false, nullptr);
+
+  return status;
+}
+
+void KX_GlobalDictStorage::Wait()
+{
+  if (!m_pending.empty()) {
+    BLI_task_pool_work_and_wait(m_pool);
+  }
+}
+
+void KX_GlobalDictStorage::Update()
+{
+  // Finish the operations in start order, loads are applied in the order they were requested.
+  unsigned int i = 0;
+  for (; i < m_pending.size(); ++i) {
+    KX_GlobalDictStatus *status = m_pending[i];
+    if (!status->IsDone()) {
+      break;
+    }
+    status->Finish();
+    status->Release();
+  }
+
+  m_pending.erase(m_pending.begin(), m_pending.begin() + i);
+}
+
+void KX_GlobalDictStorage::Finalize()
+{
+  Wait();
+  Update();
+}
@@ -0,0 +1,82 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_GlobalDictStorage.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "CM_Thread.h"
+
+class KX_GlobalDictStatus;
+struct TaskPool;
+
+/** Reading and writing of the globalDict file, optionally on a worker thread.
+ *
+ * Files are written to a temporary file renamed over the destination once complete, an
+ * interrupted save never leaves a truncated file. Background saves are compressed, both
+ * compressed and raw marshal files are accepted by the loads.
+ */
+class KX_GlobalDictStorage {
+ private:
+  TaskPool *m_pool;
+  /// Background operations not yet finished, in start order.
+  std::vector<KX_GlobalDictStatus *> m_pending;
+
+  /// Serialize the background writes, an older save never replaces a newer one of the same file.
+  CM_ThreadMutex m_writeMutex;
+  unsigned int m_nextSequence;
+  /// Sequence of the last save written per file path.
+  std::map<std::string, unsigned int> m_lastWritten;
+
+  static void SaveTask(struct TaskPool *__restrict pool, void *taskdata);
+  static void LoadTask(struct TaskPool *__restrict pool, void *taskdata);
+
+ public:
+  KX_GlobalDictStorage();
+  ~KX_GlobalDictStorage();
+
+  /// Write a marshaled dictionary, return false and set error on failure.
+  static bool WriteFile(const std::string &path,
+                        const std::vector<char> &data,
+                        bool compress,
+                        std::string &error);
+  /// Read a marshaled dictionary, compressed or not.
+  static bool ReadFile(const std::string &path, std::vector<char> &data, std::string &error);
+
+  /// Compress and write a marshaled dictionary in background.
+  KX_GlobalDictStatus *SaveAsync(const std::string &path, std::vector<char> &&data);
+  /// Read and decompress a dictionary in background, it is restored by Update().
+  KX_GlobalDictStatus *LoadAsync(const std::string &path);
+
+  /// Wait for the background file operations, before a synchronous save or load.
+  void Wait();
+  /// Finish the completed operations: restore the loaded dictionaries and run the callbacks.
+  void Update();
+  /// Wait and finish all the operations.
+  void Finalize();
+};
@@ -38,6 +38,7 @@
 
 #include <boost/format.hpp>
 
+#include "BKE_sound.h"
 #include "BLI_rect.h"
 #include "DRW_render.hh"
 #include "GPU_context.hh"
@@ -47,12 +48,16 @@
 
 #include "BL_Converter.h"
 #include "BL_SceneConverter.h"
+#include "CM_Profiler.h"
+#include "CM_Trace.h"
 #include "DEV_Joystick.h"  // for DEV_Joystick::HandleEvents
 #include "KX_Camera.h"
+#include "KX_GlobalDictStorage.h"
 #include "KX_Globals.h"
 #include "KX_NetworkMessageScene.h"
 #include "KX_PyConstraintBinding.h"
 #include "KX_PythonInit.h"  // for updatePythonJoysticks
+#include "KX_StreamingManager.h"
 #include "PHY_IPhysicsEnvironment.h"
 #include "RAS_FrameBuffer.h"
 #include "RAS_ICanvas.h"
@@ -60,6 +65,10 @@
 
 #define DEFAULT_LOGIC_TIC_RATE 60.0
 
+#ifdef WITH_AUDASPACE
+#  include <AUD_Device.h>
+#endif
+
 #ifdef FREE_WINDOWS /* XXX mingw64 (gcc 4.7.0) defines a macro for DrawText that translates to \
                        DrawTextA. Not good */
 #  ifdef DrawText
@@ -131,6 +140,8 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
       m_rasterizer(nullptr),
       m_kxsystem(system),
       m_converter(nullptr),
+      m_globalDictStorage(nullptr),
+      m_streamingManager(nullptr),
       m_inputDevice(nullptr),
       m_bInitialized(false),
       m_flags(AUTO_ADD_DEBUG_PROPERTIES),
@@ -146,20 +157,23 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
       m_ticrate(DEFAULT_LOGIC_TIC_RATE),
       m_anim_framerate(25.0),
       m_doRender(true),
+      m_randomSeed(0),
       m_exitkey(130),
       m_exitcode(KX_ExitRequest::NO_REQUEST),
       m_exitstring(""),
       m_cameraZoom(1.0f),
       m_overrideCamZoom(1.0f),
-      m_logger(KX_TimeCategoryLogger(m_clock, 25)),
       m_average_framerate(0.0),
       m_showBoundingBox(KX_DebugOption::DISABLE),
       m_showArmature(KX_DebugOption::DISABLE),
       m_showCameraFrustum(KX_DebugOption::DISABLE),
       m_showShadowFrustum(KX_DebugOption::DISABLE)
 {
+  CM_Profiler::Reset();
   for (int i = tc_first; i < tc_numCategories; i++) {
-    m_logger.AddCategory((KX_TimeCategory)i);
+    // The category zones are named from the labels without the trailing colon.
+    const std::string &label = m_profileLabels[i];
+    CM_Profiler::AddCategory(label.substr(0, label.size() - 1));
   }
 
 #ifdef WITH_PYTHON
@@ -168,6 +182,11 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
 
   m_scenes = new EXP_ListValue<KX_Scene>();
   m_renderingCameras = {};
+
+  m_globalDictStorage = new KX_GlobalDictStorage();
+  m_streamingManager = new KX_StreamingManager(this);
+
+  CM_FrameArena::SetActive(&m_frameArena);
 }
 
 /**
@@ -180,6 +199,11 @@ KX_KetsjiEngine::~KX_KetsjiEngine()
 #endif
 
   m_scenes->Release();
+
+  delete m_globalDictStorage;
+  delete m_streamingManager;
+
+  CM_FrameArena::SetActive(nullptr);
 }
 
 /* EEVEE integration */
@@ -203,12 +227,12 @@ int KX_KetsjiEngine::ShadingTypeRuntime()
  */
 void KX_KetsjiEngine::CountDepsgraphTime()
 {
-  m_logger.StartLog(tc_depsgraph);
+  CM_Profiler::StartCategory(tc_depsgraph);
 }
 
 void KX_KetsjiEngine::EndCountDepsgraphTime()
 {
-  m_logger.StartLog(tc_rasterizer);
+  CM_Profiler::StartCategory(tc_rasterizer);
 }
 
 std::vector<KX_Camera *> KX_KetsjiEngine::GetRenderingCameras()
@@ -241,12 +265,132 @@ void KX_KetsjiEngine::SetNetworkMessageManager(KX_NetworkMessageManager *manager
   m_networkMessageManager = manager;
 }
 
+double KX_KetsjiEngine::GetCategoryTime(KX_TimeCategory category) const
+{
+  return CM_Profiler::GetStats(CM_Profiler::GetCategoryZone(category)).m_average;
+}
+
 #ifdef WITH_PYTHON
+/// Convert a profiler zone and its children to a python dictionary.
+static PyObject *profile_zone_to_dict(unsigned int index)
+{
+  const CM_Profiler::Zone &zone = CM_Profiler::GetZones()[index];
+  const CM_Profiler::Stats stats = CM_Profiler::GetStats(index);
+
+  PyObject *dict = PyDict_New();
+  const std::pair<const char *, PyObject *> items[] = {
+      {"time", PyFloat_FromDouble(stats.m_average * 1000.0)},
+      {"p50", PyFloat_FromDouble(stats.m_p50 * 1000.0)},
+      {"p95", PyFloat_FromDouble(stats.m_p95 * 1000.0)},
+      {"p99", PyFloat_FromDouble(stats.m_p99 * 1000.0)},
+      {"calls", PyFloat_FromDouble(stats.m_calls)},
+      {"children", PyDict_New()}};
+
+  for (const std::pair<const char *, PyObject *> &item : items) {
+    PyDict_SetItemString(dict, item.first, item.second);
+    Py_DECREF(item.second);
+  }
+
+  PyObject *children = items[5].second;
+  for (unsigned int child : zone.m_children) {
+    PyObject *childDict = profile_zone_to_dict(child);
+    PyDict_SetItemString(children, CM_Profiler::GetZones()[child].m_name.c_str(), childDict);
+    Py_DECREF(childDict);
+  }
+
+  return dict;
+}
+
 PyObject *KX_KetsjiEngine::GetPyProfileDict()
 {
   Py_INCREF(m_pyprofiledict);
   return m_pyprofiledict;
 }
+
+void KX_KetsjiEngine::UpdatePyProfileDict(double tottime)
+{
+  for (int i = tc_first; i < tc_numCategories; ++i) {
+    double time = GetCategoryTime((KX_TimeCategory)i);
+    PyObject *val = PyTuple_New(2);
+    PyTuple_SetItem(val, 0, PyFloat_FromDouble(time * 1000.0));
+    PyTuple_SetItem(val, 1, PyFloat_FromDouble(time / tottime * 100.0));
+
+    PyDict_SetItemString(m_pyprofiledict, m_profileLabels[i].c_str(), val);
+    Py_DECREF(val);
+  }
+
+  // Timings of the last logic frame per component class, all scenes merged.
+  PyObject *components = PyDict_New();
+  for (KX_Scene *scene : m_scenes) {
+    scene->GetPythonProxyManager().MergeProfileInfo(components);
+  }
+  PyDict_SetItemString(m_pyprofiledict, "Components", components);
+  Py_DECREF(components);
+
+  // Armature animations of the last update, all scenes merged.
+  const KX_Scene::AnimationStats animStats = GetAnimationStats();
+  PyObject *animations = PyDict_New();
+  PyObject *item = PyLong_FromLong(animStats.m_updated);
+  PyDict_SetItemString(animations, "updated", item);
+  Py_DECREF(item);
+  item = PyLong_FromLong(animStats.m_culled);
+  PyDict_SetItemString(animations, "culled", item);
+  Py_DECREF(item);
+  item = PyLong_FromLong(animStats.m_throttled);
+  PyDict_SetItemString(animations, "throttled", item);
+  Py_DECREF(item);
+  PyDict_SetItemString(m_pyprofiledict, "Animations", animations);
+  Py_DECREF(animations);
+
+  // Sound voices of the last mix.
+  AudioStats audioStats;
+  if (GetAudioStats(audioStats)) {
+    PyObject *audio = PyDict_New();
+    item = PyLong_FromLong(audioStats.m_realVoices);
+    PyDict_SetItemString(audio, "voices", item);
+    Py_DECREF(item);
+    item = PyLong_FromLong(audioStats.m_virtualVoices);
+    PyDict_SetItemString(audio, "virtual", item);
+    Py_DECREF(item);
+    item = PyFloat_FromDouble(audioStats.m_mixTime * 1000.0);
+    PyDict_SetItemString(audio, "mix_time", item);
+    Py_DECREF(item);
+    PyDict_SetItemString(m_pyprofiledict, "Audio", audio);
+    Py_DECREF(audio);
+  }
+
+  // Transient allocations of the last logic frame.
+  if (m_flags & FRAME_ARENA_STATS) {
+    const CM_FrameArena::Stats &arenaStats = m_frameArena.GetLastFrameStats();
+    PyObject *arena = PyDict_New();
+    item = PyLong_FromLong(arenaStats.m_allocations);
+    PyDict_SetItemString(arena, "allocations", item);
+    Py_DECREF(item);
+    item = PyLong_FromSize_t(arenaStats.m_bytes);
+    PyDict_SetItemString(arena, "bytes", item);
+    Py_DECREF(item);
+    item = PyLong_FromLong(arenaStats.m_heapCalls);
+    PyDict_SetItemString(arena, "heap_calls", item);
+    Py_DECREF(item);
+    PyDict_SetItemString(m_pyprofiledict, "FrameArena", arena);
+    Py_DECREF(arena);
+  }
+
+  // Tree of the zones, only built when they are measured.
+  if (CM_Profiler::IsMeasuring()) {
+    PyObject *zones = PyDict_New();
+    for (unsigned int root : CM_Profiler::GetRoots()) {
+      PyObject *rootDict = profile_zone_to_dict(root);
+      PyDict_SetItemString(zones, CM_Profiler::GetZones()[root].m_name.c_str(), rootDict);
+      Py_DECREF(rootDict);
+    }
+    PyDict_SetItemString(m_pyprofiledict, "Zones", zones);
+    Py_DECREF(zones);
+  }
+  else if (PyDict_GetItemString(m_pyprofiledict, "Zones")) {
+    PyDict_DelItemString(m_pyprofiledict, "Zones");
+  }
+}
 #endif
 
 void KX_KetsjiEngine::SetConverter(BL_Converter *converter)
@@ -273,44 +417,36 @@ void KX_KetsjiEngine::BeginFrame()
 void KX_KetsjiEngine::EndFrame()
 {
   // Show profiling info
-  m_logger.StartLog(tc_overhead);
+  CM_Profiler::StartCategory(tc_overhead);
   if (m_flags & (SHOW_PROFILE | SHOW_FRAMERATE | SHOW_DEBUG_PROPERTIES)) {
     RenderDebugProperties();
   }
 
   m_rasterizer->FlushDebugDraw(m_canvas);
 
-  double tottime = m_logger.GetAverage();
+  double tottime = CM_Profiler::GetAverageFrameTime();
   if (tottime < 1e-6)
     tottime = 1e-6;
 
 #ifdef WITH_PYTHON
-  for (int i = tc_first; i < tc_numCategories; ++i) {
-    double time = m_logger.GetAverage((KX_TimeCategory)i);
-    PyObject *val = PyTuple_New(2);
-    PyTuple_SetItem(val, 0, PyFloat_FromDouble(time * 1000.0));
-    PyTuple_SetItem(val, 1, PyFloat_FromDouble(time / tottime * 100.0));
-
-    PyDict_SetItemString(m_pyprofiledict, m_profileLabels[i].c_str(), val);
-    Py_DECREF(val);
-  }
+  UpdatePyProfileDict(tottime);
 #endif
 
   m_average_framerate = 1.0 / tottime;
 
   // Go to next profiling measurement, time spent after this call is shown in the next frame.
-  m_logger.NextMeasurement();
+  CM_Profiler::NextFrame();
 
-  m_logger.StartLog(tc_rasterizer);
+  CM_Profiler::StartCategory(tc_rasterizer);
   m_rasterizer->EndFrame();
 
-  m_logger.StartLog(tc_logic);
+  CM_Profiler::StartCategory(tc_logic);
   m_canvas->FlushScreenshots();
 
   // swap backbuffer (drawing into this buffer) <-> front/visible buffer
-  m_logger.StartLog(tc_latency);
+  CM_Profiler::StartCategory(tc_latency);
   m_canvas->SwapBuffers();
-  m_logger.StartLog(tc_rasterizer);
+  CM_Profiler::StartCategory(tc_rasterizer);
 
   m_canvas->EndDraw();
 }
@@ -318,44 +454,36 @@ void KX_KetsjiEngine::EndFrame()
 void KX_KetsjiEngine::EndFrameViewportRender()
 {
   // Show profiling info
-  m_logger.StartLog(tc_overhead);
+  CM_Profiler::StartCategory(tc_overhead);
   if (m_flags & (SHOW_PROFILE | SHOW_FRAMERATE | SHOW_DEBUG_PROPERTIES)) {
     RenderDebugProperties();
   }
 
   m_rasterizer->FlushDebugDraw(m_canvas);
 
-  double tottime = m_logger.GetAverage();
+  double tottime = CM_Profiler::GetAverageFrameTime();
   if (tottime < 1e-6)
     tottime = 1e-6;
 
 #ifdef WITH_PYTHON
-  for (int i = tc_first; i < tc_numCategories; ++i) {
-    double time = m_logger.GetAverage((KX_TimeCategory)i);
-    PyObject *val = PyTuple_New(2);
-    PyTuple_SetItem(val, 0, PyFloat_FromDouble(time * 1000.0));
-    PyTuple_SetItem(val, 1, PyFloat_FromDouble(time / tottime * 100.0));
-
-    PyDict_SetItemString(m_pyprofiledict, m_profileLabels[i].c_str(), val);
-    Py_DECREF(val);
-  }
+  UpdatePyProfileDict(tottime);
 #endif
 
   m_average_framerate = 1.0 / tottime;
 
   // Go to next profiling measurement, time spent after this call is shown in the next frame.
-  m_logger.NextMeasurement();
+  CM_Profiler::NextFrame();
 
-  m_logger.StartLog(tc_rasterizer);
+  CM_Profiler::StartCategory(tc_rasterizer);
   // m_rasterizer->EndFrame();
 
-  m_logger.StartLog(tc_logic);
+  CM_Profiler::StartCategory(tc_logic);
   m_canvas->FlushScreenshots();
 
   // swap backbuffer (drawing into this buffer) <-> front/visible buffer
-  m_logger.StartLog(tc_latency);
+  CM_Profiler::StartCategory(tc_latency);
   // m_canvas->SwapBuffers();
-  m_logger.StartLog(tc_rasterizer);
+  CM_Profiler::StartCategory(tc_rasterizer);
 
   m_canvas->EndDraw();
 }
@@ -469,14 +597,15 @@ KX_KetsjiEngine::FrameTimes KX_KetsjiEngine::GetFrameTimes()
 
 bool KX_KetsjiEngine::NextFrame()
 {
-  m_logger.StartLog(tc_services);
+  CM_TraceZone traceZone("NextFrame");
+  CM_Profiler::StartCategory(tc_services);
 
   const FrameTimes times = GetFrameTimes();
 
   // Exit if zero frame is sheduled.
   if (times.frames == 0) {
     // Start logging time spent outside main loop
-    m_logger.StartLog(tc_outside);
+    CM_Profiler::StartCategory(tc_outside);
 
     return false;
   }
@@ -484,7 +613,12 @@ bool KX_KetsjiEngine::NextFrame()
   for (unsigned short i = 0; i < times.frames; ++i) {
     m_frameTime += times.framestep;
 
-    m_converter->MergeAsyncLoads();
+    {
+      CM_TraceZone mergeZone("MergeAsyncLoads");
+      m_converter->MergeAsyncLoads();
+    }
+    m_streamingManager->Update();
+    m_globalDictStorage->Update();
 
     m_inputDevice->ReleaseMoveEvent();
 
@@ -512,69 +646,93 @@ bool KX_KetsjiEngine::NextFrame()
        * entire scene. Objects can be suspended individually, and
        * the settings for that precede the logic and physics
        * update. */
-      m_logger.StartLog(tc_logic);
+      CM_Profiler::StartCategory(tc_logic);
 
       if (i == 0) {  // No need to UpdateObjectActivity several times
         scene->UpdateObjectActivity();
       }
 
-      m_logger.StartLog(tc_physics);
+      CM_Profiler::StartCategory(tc_physics);
 
       // set Python hooks for each scene
       KX_SetActiveScene(scene);
 
       // Process sensors, and controllers
-      m_logger.StartLog(tc_logic);
-      scene->LogicBeginFrame(m_frameTime, times.framestep);
+      CM_Profiler::StartCategory(tc_logic);
+      {
+        CM_ProfileZone zone(scene->GetName());
+        scene->LogicBeginFrame(m_frameTime, times.framestep);
+      }
 
       // Scenegraph needs to be updated again, because Logic Controllers
       // can affect the local matrices.
-      m_logger.StartLog(tc_scenegraph);
-      scene->UpdateParents(m_frameTime);
+      CM_Profiler::StartCategory(tc_scenegraph);
+      {
+        CM_ProfileZone zone(scene->GetName());
+        scene->UpdateParents(m_frameTime);
+      }
 
       // Process actuators
 
       // Do some cleanup work for this logic frame
-      m_logger.StartLog(tc_logic);
-      scene->LogicUpdateFrame(m_frameTime);
+      CM_Profiler::StartCategory(tc_logic);
+      {
+        CM_ProfileZone zone(scene->GetName());
+        scene->LogicUpdateFrame(m_frameTime);
 
-      scene->LogicEndFrame();
+        scene->LogicEndFrame();
+      }
 
       // Actuators can affect the scenegraph
-      m_logger.StartLog(tc_scenegraph);
-      scene->UpdateParents(m_frameTime);
+      CM_Profiler::StartCategory(tc_scenegraph);
+      {
+        CM_ProfileZone zone(scene->GetName());
+        scene->UpdateParents(m_frameTime);
+      }
 
-      m_logger.StartLog(tc_physics);
+      CM_Profiler::StartCategory(tc_physics);
+      {
+        CM_ProfileZone zone(scene->GetName());
 
-      // Perform physics calculations on the scene. This can involve
-      // many iterations of the physics solver.
-      scene->GetPhysicsEnvironment()->ProceedDeltaTime(
-          m_frameTime, times.timestep, times.framestep);  // m_deltatimerealDeltaTime);
+        // Perform physics calculations on the scene. This can involve
+        // many iterations of the physics solver.
+        {
+          CM_TraceZone physicsZone("ProceedDeltaTime");
+          scene->GetPhysicsEnvironment()->ProceedDeltaTime(
+              m_frameTime, times.timestep, times.framestep);  // m_deltatimerealDeltaTime);
+        }
 
-      /* No need to call sofbody update more than 1 time */
-      if (i == times.frames - 1) {
-        scene->GetPhysicsEnvironment()->UpdateSoftBodies();
+        /* No need to call sofbody update more than 1 time */
+        if (i == times.frames - 1) {
+          CM_ProfileZone softBodyZone("Soft Bodies");
+          scene->GetPhysicsEnvironment()->UpdateSoftBodies();
+        }
       }
 
-      m_logger.StartLog(tc_scenegraph);
-      scene->UpdateParents(m_frameTime);
+      CM_Profiler::StartCategory(tc_scenegraph);
+      {
+        CM_ProfileZone zone(scene->GetName());
+        scene->UpdateParents(m_frameTime);
+      }
 
-      m_logger.StartLog(tc_services);
+      CM_Profiler::StartCategory(tc_services);
     }
 
-    m_logger.StartLog(tc_network);
+    CM_Profiler::StartCategory(tc_network);
     m_networkMessageManager->ClearMessages();
 
     // update system devices
-    m_logger.StartLog(tc_logic);
+    CM_Profiler::StartCategory(tc_logic);
     m_inputDevice->ClearInputs();
 
     // scene management
     ProcessScheduledScenes();
+
+    m_frameArena.EndFrame();
   }
 
   // Start logging time spent outside main loop
-  m_logger.StartLog(tc_outside);
+  CM_Profiler::StartCategory(tc_outside);
 
   return m_doRender;
 }
@@ -762,7 +920,8 @@ bool KX_KetsjiEngine::GetFrameRenderData(std::vector<FrameRenderData> &frameData
 
 void KX_KetsjiEngine::Render()
 {
-  m_logger.StartLog(tc_rasterizer);
+  CM_TraceZone traceZone("Render");
+  CM_Profiler::StartCategory(tc_rasterizer);
 
   BeginFrame();
 
@@ -855,6 +1014,28 @@ void KX_KetsjiEngine::Render()
   }
 }
 
+void KX_KetsjiEngine::EndFrameWithoutRender()
+{
+  // The animations are else updated by the render of the cameras.
+  CM_Profiler::StartCategory(tc_animations);
+  for (KX_Scene *scene : m_scenes) {
+    CM_ProfileZone zone(scene->GetName());
+    UpdateAnimations(scene);
+  }
+
+  CM_Profiler::StartCategory(tc_services);
+
+  double tottime = CM_Profiler::GetAverageFrameTime();
+  if (tottime < 1e-6) {
+    tottime = 1e-6;
+  }
+  m_average_framerate = 1.0 / tottime;
+
+  CM_Profiler::NextFrame();
+
+  CM_Profiler::StartCategory(tc_outside);
+}
+
 void KX_KetsjiEngine::RequestExit(KX_ExitRequest exitrequestmode)
 {
   m_exitcode = exitrequestmode;
@@ -957,6 +1138,32 @@ void KX_KetsjiEngine::GetSceneViewport(KX_Scene *scene,
   }
 }
 
+KX_Scene::AnimationStats KX_KetsjiEngine::GetAnimationStats() const
+{
+  KX_Scene::AnimationStats stats = {0, 0, 0};
+  for (KX_Scene *scene : m_scenes) {
+    const KX_Scene::AnimationStats &sceneStats = scene->GetAnimationStats();
+    stats.m_updated += sceneStats.m_updated;
+    stats.m_culled += sceneStats.m_culled;
+    stats.m_throttled += sceneStats.m_throttled;
+  }
+
+  return stats;
+}
+
+bool KX_KetsjiEngine::GetAudioStats(AudioStats &stats) const
+{
+#ifdef WITH_AUDASPACE
+  AUD_Device *device = (AUD_Device *)BKE_sound_get_device();
+  if (device) {
+    return AUD_Device_getVoiceStats(
+        device, &stats.m_realVoices, &stats.m_virtualVoices, &stats.m_mixTime);
+  }
+#endif  // WITH_AUDASPACE
+
+  return false;
+}
+
 void KX_KetsjiEngine::UpdateAnimations(KX_Scene *scene)
 {
   // Handle the animations independently of the logic time step
@@ -1080,12 +1287,16 @@ void KX_KetsjiEngine::RenderCamera(KX_Scene *scene,
 
   m_rasterizer->SetEye(RAS_Rasterizer::RAS_STEREO_LEFTEYE /*cameraFrameData.m_eye*/);
 
-  m_logger.StartLog(tc_scenegraph);
+  CM_Profiler::StartCategory(tc_scenegraph);
 
-  m_logger.StartLog(tc_animations);
-  UpdateAnimations(scene);
+  CM_Profiler::StartCategory(tc_animations);
+  {
+    CM_ProfileZone zone(scene->GetName());
+    CM_TraceZone traceZone("UpdateAnimations");
+    UpdateAnimations(scene);
+  }
 
-  m_logger.StartLog(tc_rasterizer);
+  CM_Profiler::StartCategory(tc_rasterizer);
 
 #ifdef WITH_PYTHON
   // Run any pre-drawing python callbacks
@@ -1147,6 +1358,8 @@ void KX_KetsjiEngine::StopEngine()
 {
   if (m_bInitialized) {
     m_converter->FinalizeAsyncLoads();
+    m_streamingManager->Clear();
+    m_globalDictStorage->Finalize();
 
     while (m_scenes->GetCount() > 0) {
       KX_Scene *scene = m_scenes->GetFront();
@@ -1260,7 +1473,7 @@ void KX_KetsjiEngine::RenderDebugProperties()
       break;
   }
 
-  float tottime = m_logger.GetAverage();
+  float tottime = CM_Profiler::GetAverageFrameTime();
   if (tottime < 1e-6f) {
     tottime = 1e-6f;
   }
@@ -1299,7 +1512,7 @@ void KX_KetsjiEngine::RenderDebugProperties()
       debugDraw.RenderText2D(
           m_profileLabels[j], MT_Vector2(xcoord + const_xindent, ycoord), white);
 
-      double time = m_logger.GetAverage((KX_TimeCategory)j);
+      double time = GetCategoryTime((KX_TimeCategory)j);
 
       debugtxt = (boost::format("%5.2fms | %d%%") % (time * 1000.f) %
                   (int)(time / tottime * 100.f))
@@ -1312,6 +1525,26 @@ void KX_KetsjiEngine::RenderDebugProperties()
           MT_Vector2(xcoord + (int)(2.2 * profile_indent), ycoord), boxSize, white);
       ycoord += const_ysize;
     }
+
+    const KX_Scene::AnimationStats animStats = GetAnimationStats();
+    debugDraw.RenderText2D("Armatures:", MT_Vector2(xcoord + const_xindent, ycoord), white);
+    debugtxt = (boost::format("%d | %d culled | %d throttled") % animStats.m_updated %
+                animStats.m_culled % animStats.m_throttled)
+                   .str();
+    debugDraw.RenderText2D(
+        debugtxt, MT_Vector2(xcoord + const_xindent + profile_indent, ycoord), white);
+    ycoord += const_ysize;
+
+    AudioStats audioStats;
+    if (GetAudioStats(audioStats)) {
+      debugDraw.RenderText2D("Sounds:", MT_Vector2(xcoord + const_xindent, ycoord), white);
+      debugtxt = (boost::format("%d | %d virtual | %.2fms mix") % audioStats.m_realVoices %
+                  audioStats.m_virtualVoices % (audioStats.m_mixTime * 1000.0f))
+                     .str();
+      debugDraw.RenderText2D(
+          debugtxt, MT_Vector2(xcoord + const_xindent + profile_indent, ycoord), white);
+      ycoord += const_ysize;
+    }
   }
   // Add the ymargin for titles below the other section of debug info
   ycoord += title_y_top_margin;
@@ -1598,6 +1831,16 @@ bool KX_KetsjiEngine::GetRender()
   return m_doRender;
 }
 
+unsigned int KX_KetsjiEngine::GetRandomSeed() const
+{
+  return m_randomSeed;
+}
+
+void KX_KetsjiEngine::SetRandomSeed(unsigned int seed)
+{
+  m_randomSeed = seed;
+}
+
 void KX_KetsjiEngine::ProcessScheduledScenes(void)
 {
   // Check whether there will be changes to the list of scenes
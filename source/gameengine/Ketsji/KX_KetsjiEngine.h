@@ -36,17 +36,19 @@
 #include <vector>
 
 #include "CM_Clock.h"
+#include "CM_FrameArena.h"
 #include "EXP_Python.h"
 #include "KX_ISystem.h"
 #include "KX_Scene.h"
-#include "KX_TimeCategoryLogger.h"
 #include "MT_Matrix4x4.h"
 #include "RAS_CameraData.h"
 #include "RAS_Rasterizer.h"
 
 class KX_ISystem;
 class BL_Converter;
+class KX_GlobalDictStorage;
 class KX_NetworkMessageManager;
+class KX_StreamingManager;
 class RAS_ICanvas;
 class RAS_FrameBuffer;
 class SCA_IInputDevice;
@@ -90,7 +92,9 @@ class KX_KetsjiEngine {
     /// Automatic add debug properties to the debug list.
     AUTO_ADD_DEBUG_PROPERTIES = (1 << 6),
     /// Use override camera?
-    CAMERA_OVERRIDE = (1 << 7)
+    CAMERA_OVERRIDE = (1 << 7),
+    /// Report the allocations of the frame arena in the profile dictionary.
+    FRAME_ARENA_STATS = (1 << 8)
   };
 
  private:
@@ -139,6 +143,12 @@ class KX_KetsjiEngine {
   RAS_Rasterizer *m_rasterizer;
   KX_ISystem *m_kxsystem;
   BL_Converter *m_converter;
+  /// Background saves and loads of bge.logic.globalDict.
+  KX_GlobalDictStorage *m_globalDictStorage;
+  /// Libraries loaded by regions under a memory budget.
+  KX_StreamingManager *m_streamingManager;
+  /// Transient allocations of the logic and physics frames.
+  CM_FrameArena m_frameArena;
   KX_NetworkMessageManager *m_networkMessageManager;
 #ifdef WITH_PYTHON
   PyObject *m_pyprofiledict;
@@ -193,6 +203,8 @@ class KX_KetsjiEngine {
   double m_anim_framerate;
 
   bool m_doRender; /* whether or not the scene should be rendered after the logic frame */
+  /// Seed of the random generators without seed, 0 to seed them from the time.
+  unsigned int m_randomSeed;
 
   /// Key used to exit the BGE
   short m_exitkey;
@@ -226,9 +238,6 @@ class KX_KetsjiEngine {
     tc_numCategories
   } KX_TimeCategory;
 
-  /// Time logger.
-  KX_TimeCategoryLogger m_logger;
-
   /// Labels for profiling display.
   static const std::string m_profileLabels[tc_numCategories];
   /// Last estimated framerate
@@ -289,6 +298,14 @@ class KX_KetsjiEngine {
   void BeginFrame();
   FrameTimes GetFrameTimes();
 
+  /// Average time of a profiling category in seconds.
+  double GetCategoryTime(KX_TimeCategory category) const;
+
+#ifdef WITH_PYTHON
+  /// Fill the python profiling dictionary with the current averages.
+  void UpdatePyProfileDict(double tottime);
+#endif
+
  public:
   KX_KetsjiEngine(KX_ISystem *system,
                   struct bContext *C,
@@ -326,6 +343,14 @@ class KX_KetsjiEngine {
   {
     return m_converter;
   }
+  KX_GlobalDictStorage *GetGlobalDictStorage()
+  {
+    return m_globalDictStorage;
+  }
+  KX_StreamingManager *GetStreamingManager()
+  {
+    return m_streamingManager;
+  }
 
   RAS_Rasterizer *GetRasterizer()
   {
@@ -347,6 +372,10 @@ class KX_KetsjiEngine {
   /// returns true if an update happened to indicate -> Render
   bool NextFrame();
   void Render();
+  /** Update the animations and end the profiled frame when the frame is not rendered,
+   * replacing Render() for the frames computed without display.
+   */
+  void EndFrameWithoutRender();
 
   void StartEngine();
   void StopEngine();
@@ -383,6 +412,18 @@ class KX_KetsjiEngine {
 
   // Update animations for object in this scene
   void UpdateAnimations(KX_Scene *scene);
+  /// Armature animation counts of the last update, all scenes merged.
+  KX_Scene::AnimationStats GetAnimationStats() const;
+
+  struct AudioStats {
+    /// Number of sounds mixed and skipped in the last mix.
+    int m_realVoices;
+    int m_virtualVoices;
+    /// Duration of the last mix in seconds.
+    float m_mixTime;
+  };
+  /// Sound mixer counts of the last mix, return false if the audio device doesn't provide them.
+  bool GetAudioStats(AudioStats &stats) const;
 
   bool GetFlag(FlagType flag) const;
   /// Enable or disable a set of flags.
@@ -472,6 +513,9 @@ class KX_KetsjiEngine {
    */
   bool GetRender();
 
+  unsigned int GetRandomSeed() const;
+  void SetRandomSeed(unsigned int seed);
+
   /// Allow debug bounding box debug.
   void SetShowBoundingBox(KX_DebugOption mode);
   /// Returns the current setting for bounding box debug.
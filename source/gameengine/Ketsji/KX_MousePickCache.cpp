@@ -0,0 +1,218 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_MousePickCache.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_MousePickCache.h"
+
+#include "CM_Message.h"
+#include "KX_Camera.h"
+#include "KX_ClientObjectInfo.h"
+#include "KX_KetsjiEngine.h"
+#include "KX_Scene.h"
+#include "PHY_IPhysicsController.h"
+#include "PHY_IPhysicsEnvironment.h"
+#include "RAS_ICanvas.h"
+
+/// Collect all the objects hit by a pick ray.
+class KX_MousePickCallback : public PHY_IRayCastFilterCallback {
+ private:
+  std::vector<KX_MousePickCache::Hit> &m_hits;
+
+ public:
+  KX_MousePickCallback(PHY_IPhysicsController *ignoreController,
+                       std::vector<KX_MousePickCache::Hit> &hits)
+      // Get the UV mapping, the sensors expose it.
+      : PHY_IRayCastFilterCallback(ignoreController, false, true), m_hits(hits)
+  {
+  }
+
+  virtual bool needBroadphaseRayCast(PHY_IPhysicsController *controller)
+  {
+    KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(controller->GetNewClientInfo());
+    if (!info) {
+      BLI_assert(info && "Physics controller with no client object info");
+      return false;
+    }
+
+    if (info->m_type > KX_ClientObjectInfo::ACTOR) {
+      // Unknown type of object, skip it.
+      // Should not occur as the sensor objects are filtered in RayTestAll()
+      CM_Error("invalid client type " << info->m_type << " found ray casting");
+      return false;
+    }
+
+    return true;
+  }
+
+  virtual void reportHit(PHY_RayCastResult *result)
+  {
+    KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(
+        result->m_controller->GetNewClientInfo());
+    m_hits.push_back({info->m_gameobject,
+                      MT_Vector3(result->m_hitPoint),
+                      MT_Vector3(result->m_hitNormal),
+                      MT_Vector2(result->m_hitUV)});
+  }
+};
+
+KX_MousePickCache::KX_MousePickCache(KX_Scene *scene) : m_scene(scene)
+{
+}
+
+KX_MousePickCache::~KX_MousePickCache()
+{
+}
+
+void KX_MousePickCache::ComputePick(Pick &pick, KX_KetsjiEngine *engine) const
+{
+  /* All screen handling in the gameengine is done by GL,
+   * specifically the model/view and projection parts. The viewport
+   * part is in the creator.
+   *
+   * The theory is this:
+   * WCS - world coordinates
+   * -> wcs_camcs_trafo ->
+   * camCS - camera coordinates
+   * -> camcs_clip_trafo ->
+   * clipCS - normalized device coordinates?
+   * -> normview_win_trafo
+   * winCS - window coordinates
+   *
+   * The first two transforms are respectively the model/view and
+   * the projection matrix. These are passed to the rasterizer, and
+   * we store them in the camera for easy access.
+   *
+   * For normalized device coords (xn = x/w, yn = y/w/zw) the
+   * windows coords become (lb = left bottom)
+   *
+   * xwin = [(xn + 1.0) * width]/2 + x_lb
+   * ywin = [(yn + 1.0) * height]/2 + y_lb
+   *
+   * Inverting (blender y is flipped!):
+   *
+   * xn = 2(xwin - x_lb)/width - 1.0
+   * yn = 2(ywin - y_lb)/height - 1.0
+   *    = 2(height - y_blender - y_lb)/height - 1.0
+   *    = 1.0 - 2(y_blender - y_lb)/height
+   *
+   * */
+
+  /* Because we don't want to worry about resize events, camera
+   * changes and all that crap, we just determine this over and
+   * over. Stop whining. We have lots of other calculations to do
+   * here as well. These reads are not the main cost. If there is no
+   * canvas, the test is irrelevant. The 1.0 makes sure the
+   * calculations don't bomb. Maybe we should explicitly guard for
+   * division by 0.0...*/
+
+  RAS_Rect area, viewport;
+  RAS_ICanvas *canvas = engine->GetCanvas();
+  short y_inv = canvas->GetHeight() - pick.m_y;
+
+  const RAS_Rect displayArea = engine->GetRasterizer()->GetRenderArea(
+      canvas, RAS_Rasterizer::RAS_STEREO_LEFTEYE);
+  engine->GetSceneViewport(m_scene, pick.m_camera, displayArea, area, viewport);
+
+  /* Check if the mouse is in the viewport */
+  pick.m_inViewport = (pick.m_x < viewport.GetRight() && pick.m_x > viewport.GetLeft() &&
+                       y_inv < viewport.GetTop() && y_inv > viewport.GetBottom());
+  if (!pick.m_inViewport) {
+    return;
+  }
+
+  const float height = float(viewport.GetTop() - viewport.GetBottom() + 1);
+  const float width = float(viewport.GetRight() - viewport.GetLeft() + 1);
+
+  const float x_lb = float(viewport.GetLeft());
+  const float y_lb = float(viewport.GetBottom());
+
+  /* y_inv - inverting for a bounds check is only part of it, now make relative to view bounds */
+  y_inv = (viewport.GetTop() - y_inv) + viewport.GetBottom();
+
+  /* The z coordinates don't have to be exact, just in front and behind of the near and far
+   * clip planes. */
+  MT_Vector4 frompoint((2 * (pick.m_x - x_lb) / width) - 1.0f,
+                       1.0f - (2 * (y_inv - y_lb) / height),
+                       -1.0f,
+                       1.0f);
+  MT_Vector4 topoint((2 * (pick.m_x - x_lb) / width) - 1.0f,
+                     1.0f - (2 * (y_inv - y_lb) / height),
+                     1.0f,
+                     1.0f);
+
+  const MT_Matrix4x4 camcs_wcs_matrix = MT_Matrix4x4(pick.m_camera->GetCameraToWorld());
+  MT_Matrix4x4 clip_camcs_matrix = MT_Matrix4x4(pick.m_camera->GetProjectionMatrix());
+  clip_camcs_matrix.invert();
+
+  /* shoot-points: clip to cam to wcs . win to clip was already done.*/
+  frompoint = camcs_wcs_matrix * (clip_camcs_matrix * frompoint);
+  topoint = camcs_wcs_matrix * (clip_camcs_matrix * topoint);
+
+  /* from hom wcs to 3d wcs: */
+  pick.m_source.setValue(
+      frompoint[0] / frompoint[3], frompoint[1] / frompoint[3], frompoint[2] / frompoint[3]);
+  pick.m_target.setValue(topoint[0] / topoint[3], topoint[1] / topoint[3], topoint[2] / topoint[3]);
+
+  PHY_IPhysicsEnvironment *physicsEnv = m_scene->GetPhysicsEnvironment();
+  if (!physicsEnv) {
+    return;
+  }
+
+  // The camera never hits itself.
+  KX_MousePickCallback callback(pick.m_camera->GetPhysicsController(), pick.m_hits);
+  physicsEnv->RayTestAll(callback,
+                         pick.m_source.x(),
+                         pick.m_source.y(),
+                         pick.m_source.z(),
+                         pick.m_target.x(),
+                         pick.m_target.y(),
+                         pick.m_target.z());
+}
+
+const KX_MousePickCache::Pick &KX_MousePickCache::GetPick(KX_Camera *cam,
+                                                          int x,
+                                                          int y,
+                                                          KX_KetsjiEngine *engine)
+{
+  for (const Pick &pick : m_picks) {
+    if (pick.m_camera == cam && pick.m_x == x && pick.m_y == y) {
+      return pick;
+    }
+  }
+
+  m_picks.emplace_back();
+  Pick &pick = m_picks.back();
+  pick.m_camera = cam;
+  pick.m_x = x;
+  pick.m_y = y;
+  ComputePick(pick, engine);
+
+  return pick;
+}
+
+void KX_MousePickCache::Clear()
+{
+  m_picks.clear();
+}
@@ -0,0 +1,84 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_MousePickCache.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "MT_Vector2.h"
+#include "MT_Vector3.h"
+
+class KX_Camera;
+class KX_GameObject;
+class KX_KetsjiEngine;
+class KX_Scene;
+
+/** Mouse picking rays shared by the mouse focus sensors of a scene.
+ *
+ * The ray under the mouse is computed once per camera and frame, with all the objects it hits
+ * sorted by distance. Each sensor then resolves its own filters against this hit list instead
+ * of casting its own ray.
+ */
+class KX_MousePickCache {
+ public:
+  struct Hit {
+    KX_GameObject *m_object;
+    MT_Vector3 m_point;
+    MT_Vector3 m_normal;
+    MT_Vector2 m_uv;
+  };
+
+  struct Pick {
+    KX_Camera *m_camera;
+    int m_x;
+    int m_y;
+    /// False if the mouse is outside of the camera viewport, the ray and hits are then unset.
+    bool m_inViewport;
+    /// Ray in world coordinates, from the near to the far clip plane.
+    MT_Vector3 m_source;
+    MT_Vector3 m_target;
+    /// Closest hit of every object along the ray, from the closest object.
+    std::vector<Hit> m_hits;
+  };
+
+ private:
+  KX_Scene *m_scene;
+  /// Picks of the current frame, a deque keeps the returned references valid.
+  std::deque<Pick> m_picks;
+
+  void ComputePick(Pick &pick, KX_KetsjiEngine *engine) const;
+
+ public:
+  KX_MousePickCache(KX_Scene *scene);
+  ~KX_MousePickCache();
+
+  /// Return the pick of a camera at a mouse position, computing it once per frame.
+  const Pick &GetPick(KX_Camera *cam, int x, int y, KX_KetsjiEngine *engine);
+
+  /// Invalidate the picks, at the beginning of a logic frame.
+  void Clear();
+};
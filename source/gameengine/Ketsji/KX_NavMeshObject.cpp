@@ -36,6 +36,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BL_Converter.h"
+#include "CM_FrameArena.h"
 #include "CM_Message.h"
 #include "DetourStatNavMeshBuilder.h"
 #include "KX_Globals.h"
@@ -1124,7 +1125,7 @@ int KX_NavMeshObject::FindPath(const MT_Vector3 &from,
 
   int pathLen = 0;
   if (sPolyRef && ePolyRef) {
-    dtStatPolyRef *polys = new dtStatPolyRef[maxPathLen];
+    dtStatPolyRef *polys = CM_FrameArena::GetActive()->NewArray<dtStatPolyRef>(maxPathLen);
     int npolys;
     npolys = m_navMesh->findPath(sPolyRef, ePolyRef, spos, epos, polys, maxPathLen);
     if (npolys) {
@@ -1136,8 +1137,6 @@ int KX_NavMeshObject::FindPath(const MT_Vector3 &from,
         waypoint.getValue(&path[i * 3]);
       }
     }
-
-    delete[] polys;
   }
 
   return pathLen;
@@ -32,7 +32,12 @@
 #  include "KX_GameObject.h"
 
 KX_PythonComponent::KX_PythonComponent(const std::string &name)
-    : KX_PythonProxy(), m_gameobj(nullptr), m_name(name)
+    : KX_PythonProxy(),
+      m_gameobj(nullptr),
+      m_name(name),
+      m_pyType(nullptr),
+      m_updateOffset(0),
+      m_updateRequested(false)
 {
 }
 
@@ -55,6 +60,8 @@ void KX_PythonComponent::ProcessReplica()
   KX_PythonProxy::ProcessReplica();
 
   m_gameobj = nullptr;
+  m_updateOffset = 0;
+  m_updateRequested = false;
 }
 
 KX_GameObject *KX_PythonComponent::GetGameObject() const
@@ -67,6 +74,34 @@ void KX_PythonComponent::SetGameObject(KX_GameObject *gameobj)
   m_gameobj = gameobj;
 }
 
+PyTypeObject *KX_PythonComponent::GetPyType()
+{
+  if (!m_pyType) {
+    PyObject *proxy = GetProxy();
+    m_pyType = Py_TYPE(proxy);
+    Py_DECREF(proxy);
+  }
+
+  return m_pyType;
+}
+
+unsigned int KX_PythonComponent::GetUpdateOffset() const
+{
+  return m_updateOffset;
+}
+
+void KX_PythonComponent::SetUpdateOffset(unsigned int offset)
+{
+  m_updateOffset = offset;
+}
+
+bool KX_PythonComponent::ConsumeUpdateRequest()
+{
+  const bool requested = m_updateRequested;
+  m_updateRequested = false;
+  return requested;
+}
+
 PyObject *KX_PythonComponent::py_component_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
   KX_PythonComponent *comp = new KX_PythonComponent(type->tp_name);
@@ -119,6 +154,7 @@ PyTypeObject KX_PythonComponent::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "KX_P
                                          py_component_new};
 
 PyMethodDef KX_PythonComponent::Methods[] = {
+    EXP_PYMETHODTABLE_NOARGS(KX_PythonComponent, requestUpdate),
     {nullptr, nullptr}  // Sentinel
 };
 
@@ -130,6 +166,15 @@ PyAttributeDef KX_PythonComponent::Attributes[] = {
     EXP_PYATTRIBUTE_NULL  // Sentinel
 };
 
+EXP_PYMETHODDEF_DOC_NOARGS(KX_PythonComponent,
+                           requestUpdate,
+                           "requestUpdate()\n"
+                           "Schedule an update of an on-demand component for the next logic frame\n")
+{
+  m_updateRequested = true;
+  Py_RETURN_NONE;
+}
+
 PyObject *KX_PythonComponent::pyattr_get_object(EXP_PyObjectPlus *self_v,
                                                 const EXP_PYATTRIBUTE_DEF *attrdef)
 {
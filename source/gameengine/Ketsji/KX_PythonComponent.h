@@ -31,9 +31,17 @@ class KX_GameObject;
 class KX_PythonComponent : public KX_PythonProxy {
   Py_Header
 
-      private : KX_GameObject *m_gameobj;
+ private:
+  KX_GameObject *m_gameobj;
   std::string m_name;
 
+  /// Python class of the component, cached for update scheduling.
+  PyTypeObject *m_pyType;
+  /// Offset in the update interval for staggered components.
+  unsigned int m_updateOffset;
+  /// Set by requestUpdate() for on-demand components.
+  bool m_updateRequested;
+
  public:
   KX_PythonComponent(const std::string &name);
   virtual ~KX_PythonComponent();
@@ -46,10 +54,20 @@ class KX_PythonComponent : public KX_PythonProxy {
   KX_GameObject *GetGameObject() const;
   void SetGameObject(KX_GameObject *gameobj);
 
+  PyTypeObject *GetPyType();
+
+  unsigned int GetUpdateOffset() const;
+  void SetUpdateOffset(unsigned int offset);
+
+  /// Return true if an update was requested and clear the request.
+  bool ConsumeUpdateRequest();
+
   virtual KX_PythonProxy *NewInstance();
 
   static PyObject *py_component_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
 
+  EXP_PYMETHOD_DOC_NOARGS(KX_PythonComponent, requestUpdate);
+
   // Attributes
   static PyObject *pyattr_get_object(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
 };
@@ -103,6 +103,11 @@
 #include "BL_Converter.h"
 #include "BL_Shader.h"
 #include "CM_Message.h"
+#include "CM_PoolAllocator.h"
+#include "CM_Profiler.h"
+#include "CM_Trace.h"
+#include "KX_GlobalDictStatus.h"
+#include "KX_GlobalDictStorage.h"
 #include "KX_Globals.h"
 #include "KX_LibLoadStatus.h"
 #include "KX_MeshProxy.h" /* for creating a new library of mesh objects */
@@ -111,6 +116,7 @@
 #include "KX_PyConstraintBinding.h"
 #include "KX_PyMath.h"
 #include "KX_PythonInitTypes.h"
+#include "KX_StreamingManager.h"
 #include "PHY_IPhysicsEnvironment.h"
 #include "RAS_2DFilterManager.h"
 #include "RAS_ICanvas.h"
@@ -274,6 +280,29 @@ static PyObject *gPyLoadGlobalDict(PyObject *)
   Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR(gPySaveGlobalDictAsync_doc,
+             "saveGlobalDictAsync()\n"
+             "Saves bge.logic.globalDict to a file in background, returns a KX_GlobalDictStatus");
+static PyObject *gPySaveGlobalDictAsync(PyObject *)
+{
+  KX_GlobalDictStatus *status = saveGamePythonConfigAsync();
+  if (!status) {
+    PyErr_SetString(PyExc_ValueError,
+                    "bge.logic.saveGlobalDictAsync(): could not marshal bge.logic.globalDict");
+    return nullptr;
+  }
+
+  return status->NewProxy(true);
+}
+
+PyDoc_STRVAR(gPyLoadGlobalDictAsync_doc,
+             "loadGlobalDictAsync()\n"
+             "Loads bge.logic.globalDict from a file in background, returns a KX_GlobalDictStatus");
+static PyObject *gPyLoadGlobalDictAsync(PyObject *)
+{
+  return loadGamePythonConfigAsync()->NewProxy(true);
+}
+
 PyDoc_STRVAR(gPyGetProfileInfo_doc,
              "getProfileInfo()\n"
              "returns a dictionary with profiling information");
@@ -282,6 +311,74 @@ static PyObject *gPyGetProfileInfo(PyObject *)
   return KX_GetActiveEngine()->GetPyProfileDict();
 }
 
+PyDoc_STRVAR(gPySetProfileZones_doc,
+             "setProfileZones(enable)\n"
+             "enables the measure of the nested profiling zones from the next frame");
+static PyObject *gPySetProfileZones(PyObject *, PyObject *args)
+{
+  int enable;
+  if (!PyArg_ParseTuple(args, "i:setProfileZones", &enable)) {
+    return nullptr;
+  }
+
+  CM_Profiler::SetEnabled(enable);
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gPyGetProfileZones_doc,
+             "getProfileZones()\n"
+             "returns True if the nested profiling zones are measured");
+static PyObject *gPyGetProfileZones(PyObject *)
+{
+  return PyBool_FromLong(CM_Profiler::IsEnabled());
+}
+
+PyDoc_STRVAR(gPyStartTrace_doc,
+             "startTrace(filepath)\n"
+             "starts capturing the frames timeline, written to filepath by stopTrace()");
+static PyObject *gPyStartTrace(PyObject *, PyObject *args)
+{
+  char *filepath;
+  if (!PyArg_ParseTuple(args, "s:startTrace", &filepath)) {
+    return nullptr;
+  }
+
+  return PyBool_FromLong(CM_Trace::Start(filepath));
+}
+
+PyDoc_STRVAR(gPyStopTrace_doc,
+             "stopTrace()\n"
+             "stops the capture of the frames timeline and writes its trace file");
+static PyObject *gPyStopTrace(PyObject *)
+{
+  return PyBool_FromLong(CM_Trace::Stop());
+}
+
+PyDoc_STRVAR(gPyGetAllocatorInfo_doc,
+             "getAllocatorInfo()\n"
+             "returns a dictionary with the allocation counters of the engine objects");
+static PyObject *gPyGetAllocatorInfo(PyObject *)
+{
+  const CM_PoolAllocator::Stats stats = CM_PoolAllocator::GetStats();
+
+  PyObject *info = PyDict_New();
+  const std::pair<const char *, PyObject *> items[] = {
+      {"pools", PyBool_FromLong(stats.m_enabled)},
+      {"allocations", PyLong_FromUnsignedLongLong(stats.m_allocations)},
+      {"frees", PyLong_FromUnsignedLongLong(stats.m_frees)},
+      {"large_allocations", PyLong_FromUnsignedLongLong(stats.m_largeAllocations)},
+      {"live_objects", PyLong_FromUnsignedLongLong(stats.m_allocations - stats.m_frees)},
+      {"requested_bytes", PyLong_FromUnsignedLongLong(stats.m_requestedBytes)},
+      {"block_bytes", PyLong_FromUnsignedLongLong(stats.m_blockBytes)},
+      {"reserved_bytes", PyLong_FromUnsignedLongLong(stats.m_reservedBytes)}};
+  for (const std::pair<const char *, PyObject *> &item : items) {
+    PyDict_SetItemString(info, item.first, item.second);
+    Py_DECREF(item.second);
+  }
+
+  return info;
+}
+
 PyDoc_STRVAR(gPySendMessage_doc,
              "sendMessage(subject, [body, to, from])\n"
              "sends a message in same manner as a message actuator"
@@ -591,6 +688,7 @@ static PyObject *gLibLoad(PyObject *, PyObject *args, PyObject *kwds)
 {
   KX_Scene *kx_scene = nullptr;
   PyObject *pyscene = Py_None;
+  PyObject *pynames = Py_None;
   char *path;
   char *group;
   Py_buffer py_buffer;
@@ -609,11 +707,12 @@ static PyObject *gLibLoad(PyObject *, PyObject *args, PyObject *kwds)
                                  "load_scripts",
                                  "asynchronous",
                                  "scene",
+                                 "names",
                                  nullptr};
 
   if (!PyArg_ParseTupleAndKeywords(args,
                                    kwds,
-                                   "ss|y*iiIiO:LibLoad",
+                                   "ss|y*iiIiOO:LibLoad",
                                    const_cast<char **>(kwlist),
                                    &path,
                                    &group,
@@ -622,9 +721,33 @@ static PyObject *gLibLoad(PyObject *, PyObject *args, PyObject *kwds)
                                    &verbose,
                                    &load_scripts,
                                    &asynchronous,
-                                   &pyscene))
+                                   &pyscene,
+                                   &pynames))
     return nullptr;
 
+  std::vector<std::string> names;
+  if (pynames != Py_None) {
+    bool valid = PyList_Check(pynames);
+    for (Py_ssize_t i = 0, size = valid ? PyList_GET_SIZE(pynames) : 0; i < size; ++i) {
+      PyObject *item = PyList_GET_ITEM(pynames, i);
+      // Strings which can't be encoded in UTF-8 are rejected too.
+      const char *name = PyUnicode_Check(item) ? PyUnicode_AsUTF8(item) : nullptr;
+      if (!name) {
+        valid = false;
+        break;
+      }
+      names.push_back(name);
+    }
+
+    if (!valid) {
+      if (py_buffer.buf) {
+        PyBuffer_Release(&py_buffer);
+      }
+      PyErr_SetString(PyExc_TypeError, "names must be a list of strings");
+      return nullptr;
+    }
+  }
+
   if (!ConvertPythonToScene(pyscene, &kx_scene, true, "invalid scene")) {
     return nullptr;
   }
@@ -650,14 +773,15 @@ static PyObject *gLibLoad(PyObject *, PyObject *args, PyObject *kwds)
     BLI_strncpy(abs_path, path, sizeof(abs_path));
     BLI_path_abs(abs_path, KX_GetMainPath().c_str());
 
-    if ((status = converter->LinkBlendFilePath(abs_path, group, kx_scene, &err_str, options))) {
+    if ((status = converter->LinkBlendFilePath(
+             abs_path, group, names, kx_scene, &err_str, options))) {
       return status->GetProxy();
     }
   }
   else {
 
     if ((status = converter->LinkBlendFileMemory(
-             py_buffer.buf, py_buffer.len, path, group, kx_scene, &err_str, options))) {
+             py_buffer.buf, py_buffer.len, path, group, names, kx_scene, &err_str, options))) {
       PyBuffer_Release(&py_buffer);
       return status->GetProxy();
     }
@@ -757,6 +881,139 @@ static PyObject *gLibList(PyObject *, PyObject *args)
   return list;
 }
 
+PyDoc_STRVAR(gLibRequest_doc,
+             "LibRequest(region, blend, type, priority=0.0, position=None, scene=None, "
+             "load_actions=False, load_scripts=True, asynchronous=True)\n"
+             "holds a library for a region, it's loaded by the streaming manager");
+static PyObject *gLibRequest(PyObject *, PyObject *args, PyObject *kwds)
+{
+  KX_Scene *kx_scene = nullptr;
+  PyObject *pyscene = Py_None;
+  PyObject *pyposition = Py_None;
+  char *region;
+  char *path;
+  char *group;
+  float priority = 0.0f;
+  int load_actions = 0, load_scripts = 1, asynchronous = 1;
+
+  static const char *kwlist[] = {"region",
+                                 "blend",
+                                 "type",
+                                 "priority",
+                                 "position",
+                                 "scene",
+                                 "load_actions",
+                                 "load_scripts",
+                                 "asynchronous",
+                                 nullptr};
+
+  if (!PyArg_ParseTupleAndKeywords(args,
+                                   kwds,
+                                   "sss|fOOiii:LibRequest",
+                                   const_cast<char **>(kwlist),
+                                   &region,
+                                   &path,
+                                   &group,
+                                   &priority,
+                                   &pyposition,
+                                   &pyscene,
+                                   &load_actions,
+                                   &load_scripts,
+                                   &asynchronous)) {
+    return nullptr;
+  }
+
+  MT_Vector3 position;
+  if (pyposition != Py_None && !PyVecTo(pyposition, position)) {
+    return nullptr;
+  }
+
+  if (!ConvertPythonToScene(pyscene, &kx_scene, true, "invalid scene")) {
+    return nullptr;
+  }
+  if (!kx_scene) {
+    kx_scene = KX_GetActiveScene();
+  }
+
+  short options = 0;
+  if (load_actions != 0)
+    options |= BL_Converter::LIB_LOAD_LOAD_ACTIONS;
+  if (load_scripts != 0)
+    options |= BL_Converter::LIB_LOAD_LOAD_SCRIPTS;
+  if (asynchronous != 0)
+    options |= BL_Converter::LIB_LOAD_ASYNC;
+
+  char abs_path[FILE_MAX];
+  BLI_strncpy(abs_path, path, sizeof(abs_path));
+  BLI_path_abs(abs_path, KX_GetMainPath().c_str());
+
+  KX_GetActiveEngine()->GetStreamingManager()->Request(region,
+                                                       abs_path,
+                                                       group,
+                                                       kx_scene,
+                                                       options,
+                                                       priority,
+                                                       (pyposition != Py_None) ? &position :
+                                                                                 nullptr);
+
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gLibRelease_doc,
+             "LibRelease(region, blend=\"\")\n"
+             "releases a library held by a region, or all its libraries if blend is empty");
+static PyObject *gLibRelease(PyObject *, PyObject *args)
+{
+  char *region;
+  char *path = (char *)"";
+
+  if (!PyArg_ParseTuple(args, "s|s:LibRelease", &region, &path)) {
+    return nullptr;
+  }
+
+  char abs_path[FILE_MAX] = "";
+  if (path[0] != '\0') {
+    BLI_strncpy(abs_path, path, sizeof(abs_path));
+    BLI_path_abs(abs_path, KX_GetMainPath().c_str());
+  }
+
+  KX_GetActiveEngine()->GetStreamingManager()->Release(region, abs_path);
+
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gSetLibBudget_doc,
+             "setLibBudget(size)\n"
+             "sets the memory budget in bytes of the streamed libraries, 0 for none");
+static PyObject *gSetLibBudget(PyObject *, PyObject *args)
+{
+  unsigned long long size;
+  if (!PyArg_ParseTuple(args, "K:setLibBudget", &size)) {
+    return nullptr;
+  }
+
+  KX_GetActiveEngine()->GetStreamingManager()->SetBudget(size);
+
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gGetLibBudget_doc,
+             "getLibBudget()\n"
+             "returns the memory budget in bytes of the streamed libraries");
+static PyObject *gGetLibBudget(PyObject *)
+{
+  return PyLong_FromSize_t(KX_GetActiveEngine()->GetStreamingManager()->GetBudget());
+}
+
+PyDoc_STRVAR(gGetLibStreamingInfo_doc,
+             "getLibStreamingInfo()\n"
+             "returns a dictionary with the residency and loading statistics of the streamed "
+             "libraries");
+static PyObject *gGetLibStreamingInfo(PyObject *)
+{
+  return KX_GetActiveEngine()->GetStreamingManager()->GetPyInfo();
+}
+
 struct PyNextFrameState pynextframestate;
 static PyObject *gPyNextFrame(PyObject *)
 {
@@ -788,6 +1045,14 @@ static struct PyMethodDef game_methods[] = {
      (PyCFunction)gPyLoadGlobalDict,
      METH_NOARGS,
      (const char *)gPyLoadGlobalDict_doc},
+    {"saveGlobalDictAsync",
+     (PyCFunction)gPySaveGlobalDictAsync,
+     METH_NOARGS,
+     (const char *)gPySaveGlobalDictAsync_doc},
+    {"loadGlobalDictAsync",
+     (PyCFunction)gPyLoadGlobalDictAsync,
+     METH_NOARGS,
+     (const char *)gPyLoadGlobalDictAsync_doc},
     {"sendMessage", (PyCFunction)gPySendMessage, METH_VARARGS, (const char *)gPySendMessage_doc},
     {"getCurrentController",
      (PyCFunction)SCA_PythonController::sPyGetCurrentController,
@@ -917,11 +1182,24 @@ static struct PyMethodDef game_methods[] = {
      METH_NOARGS,
      (const char *)"Render next frame (if Python has control)"},
     {"getProfileInfo", (PyCFunction)gPyGetProfileInfo, METH_NOARGS, gPyGetProfileInfo_doc},
+    {"setProfileZones", (PyCFunction)gPySetProfileZones, METH_VARARGS, gPySetProfileZones_doc},
+    {"getProfileZones", (PyCFunction)gPyGetProfileZones, METH_NOARGS, gPyGetProfileZones_doc},
+    {"startTrace", (PyCFunction)gPyStartTrace, METH_VARARGS, gPyStartTrace_doc},
+    {"stopTrace", (PyCFunction)gPyStopTrace, METH_NOARGS, gPyStopTrace_doc},
+    {"getAllocatorInfo", (PyCFunction)gPyGetAllocatorInfo, METH_NOARGS, gPyGetAllocatorInfo_doc},
     /* library functions */
     {"LibLoad", (PyCFunction)gLibLoad, METH_VARARGS | METH_KEYWORDS, (const char *)""},
     {"LibNew", (PyCFunction)gLibNew, METH_VARARGS, (const char *)""},
     {"LibFree", (PyCFunction)gLibFree, METH_VARARGS, (const char *)""},
     {"LibList", (PyCFunction)gLibList, METH_VARARGS, (const char *)""},
+    {"LibRequest", (PyCFunction)gLibRequest, METH_VARARGS | METH_KEYWORDS, gLibRequest_doc},
+    {"LibRelease", (PyCFunction)gLibRelease, METH_VARARGS, gLibRelease_doc},
+    {"setLibBudget", (PyCFunction)gSetLibBudget, METH_VARARGS, gSetLibBudget_doc},
+    {"getLibBudget", (PyCFunction)gGetLibBudget, METH_NOARGS, gGetLibBudget_doc},
+    {"getLibStreamingInfo",
+     (PyCFunction)gGetLibStreamingInfo,
+     METH_NOARGS,
+     gGetLibStreamingInfo_doc},
 
     {nullptr, (PyCFunction) nullptr, 0, nullptr}};
 
@@ -2958,136 +3236,133 @@ PyMODINIT_FUNC initApplicationPythonBinding()
 }
 
 // utility function for loading and saving the globalDict
-void saveGamePythonConfig()
+static bool marshalGamePythonConfig(std::vector<char> &data)
 {
-  char *marshal_buffer = nullptr;
-  int marshal_length = 0;
   PyObject *gameLogic = PyImport_ImportModule("GameLogic");
-  if (gameLogic) {
-    PyObject *pyGlobalDict = PyDict_GetItemString(PyModule_GetDict(gameLogic),
-                                                  "globalDict");  // Same as importing the module
-    if (pyGlobalDict) {
+  if (!gameLogic) {
+    PyErr_Clear();
+    CM_Error("bge.logic failed to import bge.logic.globalDict will be lost");
+    return false;
+  }
+
+  PyObject *pyGlobalDict = PyDict_GetItemString(PyModule_GetDict(gameLogic),
+                                                "globalDict");  // Same as importing the module
+  if (!pyGlobalDict) {
+    Py_DECREF(gameLogic);
+    CM_Error("bge.logic.globalDict was removed");
+    return false;
+  }
+
 #  ifdef Py_MARSHAL_VERSION
-      PyObject *pyGlobalDictMarshal = PyMarshal_WriteObjectToString(
-          pyGlobalDict, 2);  // Py_MARSHAL_VERSION == 2 as of Py2.5
+  PyObject *pyGlobalDictMarshal = PyMarshal_WriteObjectToString(
+      pyGlobalDict, 2);  // Py_MARSHAL_VERSION == 2 as of Py2.5
 #  else
-      PyObject *pyGlobalDictMarshal = PyMarshal_WriteObjectToString(pyGlobalDict);
+  PyObject *pyGlobalDictMarshal = PyMarshal_WriteObjectToString(pyGlobalDict);
 #  endif
-      if (pyGlobalDictMarshal) {
-        // for testing only
-        // PyObject_Print(pyGlobalDictMarshal, stderr, 0);
-        char *marshal_cstring;
-
-        marshal_cstring = PyBytes_AsString(pyGlobalDictMarshal);  // py3 uses byte arrays
-        marshal_length = PyBytes_Size(pyGlobalDictMarshal);
-        marshal_buffer = new char[marshal_length + 1];
-        memcpy(marshal_buffer, marshal_cstring, marshal_length);
-        Py_DECREF(pyGlobalDictMarshal);
-      }
-      else {
-        CM_Error("bge.logic.globalDict could not be marshal'd");
-      }
-    }
-    else {
-      CM_Error("bge.logic.globalDict was removed");
-    }
-    Py_DECREF(gameLogic);
-  }
-  else {
+  Py_DECREF(gameLogic);
+
+  if (!pyGlobalDictMarshal) {
     PyErr_Clear();
-    CM_Error("bge.logic failed to import bge.logic.globalDict will be lost");
+    CM_Error("bge.logic.globalDict could not be marshal'd");
+    return false;
+  }
+
+  // py3 uses byte arrays
+  const char *marshal_cstring = PyBytes_AsString(pyGlobalDictMarshal);
+  data.assign(marshal_cstring, marshal_cstring + PyBytes_Size(pyGlobalDictMarshal));
+  Py_DECREF(pyGlobalDictMarshal);
+
+  if (data.empty()) {
+    CM_Error("could not create marshal buffer");
+    return false;
   }
 
-  std::string marshal_path = pathGamePythonConfig();
+  return true;
+}
 
-  if (marshal_length && marshal_buffer) {
-    FILE *fp = fopen(marshal_path.c_str(), "wb");
+bool restoreGamePythonConfig(const std::vector<char> &data)
+{
+  PyObject *gameLogic = PyImport_ImportModule("GameLogic");
+  if (!gameLogic) {
+    PyErr_Clear();
+    CM_Error("bge.logic failed to import bge.logic.globalDict will be lost");
+    return false;
+  }
 
-    if (fp) {
-      if (fwrite(marshal_buffer, 1, marshal_length, fp) != marshal_length) {
-        CM_Error("could not write marshal data");
-      }
+  PyObject *pyGlobalDict = PyMarshal_ReadObjectFromString(data.data(), data.size());
+  if (!pyGlobalDict) {
+    Py_DECREF(gameLogic);
+    PyErr_Clear();
+    CM_Error("could not marshall string");
+    return false;
+  }
 
-      fclose(fp);
-    }
-    else {
-      CM_Error("could not open marshal file");
-    }
+  PyObject *pyGlobalDict_orig = PyDict_GetItemString(
+      PyModule_GetDict(gameLogic), "globalDict");  // Same as importing the module.
+  if (pyGlobalDict_orig) {
+    PyDict_Clear(pyGlobalDict_orig);
+    PyDict_Update(pyGlobalDict_orig, pyGlobalDict);
   }
   else {
-    CM_Error("could not create marshal buffer");
+    /* this should not happen, but cant find the original globalDict, just assign it then
+     */
+    PyDict_SetItemString(PyModule_GetDict(gameLogic),
+                         "globalDict",
+                         pyGlobalDict);  // Same as importing the module.
+  }
+  Py_DECREF(gameLogic);
+  Py_DECREF(pyGlobalDict);
+
+  return true;
+}
+
+void saveGamePythonConfig()
+{
+  std::vector<char> data;
+  if (!marshalGamePythonConfig(data)) {
+    return;
   }
 
-  if (marshal_buffer) {
-    delete[] marshal_buffer;
+  // Don't let a pending background save overwrite this one.
+  KX_GlobalDictStorage *storage = KX_GetActiveEngine()->GetGlobalDictStorage();
+  storage->Wait();
+
+  std::string error;
+  if (!KX_GlobalDictStorage::WriteFile(pathGamePythonConfig(), data, false, error)) {
+    CM_Error(error);
   }
 }
 
 void loadGamePythonConfig()
 {
-  std::string marshal_path = pathGamePythonConfig();
+  KX_GlobalDictStorage *storage = KX_GetActiveEngine()->GetGlobalDictStorage();
+  storage->Wait();
 
-  FILE *fp = fopen(marshal_path.c_str(), "rb");
+  std::vector<char> data;
+  std::string error;
+  if (!KX_GlobalDictStorage::ReadFile(pathGamePythonConfig(), data, error)) {
+    CM_Error(error);
+    return;
+  }
 
-  if (fp) {
-    // obtain file size:
-    fseek(fp, 0, SEEK_END);
-    size_t marshal_length = ftell(fp);
-    if (marshal_length == -1) {
-      CM_Error("could not read position of '" << marshal_path << "'");
-      fclose(fp);
-      return;
-    }
-    rewind(fp);
-
-    char *marshal_buffer = (char *)malloc(sizeof(char) * marshal_length);
-
-    int result = fread(marshal_buffer, 1, marshal_length, fp);
-
-    if (result == marshal_length) {
-      /* Restore the dict */
-      PyObject *gameLogic = PyImport_ImportModule("GameLogic");
-
-      if (gameLogic) {
-        PyObject *pyGlobalDict = PyMarshal_ReadObjectFromString(marshal_buffer, marshal_length);
-        if (pyGlobalDict) {
-          PyObject *pyGlobalDict_orig = PyDict_GetItemString(
-              PyModule_GetDict(gameLogic), "globalDict");  // Same as importing the module.
-          if (pyGlobalDict_orig) {
-            PyDict_Clear(pyGlobalDict_orig);
-            PyDict_Update(pyGlobalDict_orig, pyGlobalDict);
-          }
-          else {
-            /* this should not happen, but cant find the original globalDict, just assign it then
-             */
-            PyDict_SetItemString(PyModule_GetDict(gameLogic),
-                                 "globalDict",
-                                 pyGlobalDict);  // Same as importing the module.
-          }
-          Py_DECREF(gameLogic);
-          Py_DECREF(pyGlobalDict);
-        }
-        else {
-          Py_DECREF(gameLogic);
-          PyErr_Clear();
-          CM_Error("could not marshall string");
-        }
-      }
-      else {
-        PyErr_Clear();
-        CM_Error("bge.logic failed to import bge.logic.globalDict will be lost");
-      }
-    }
-    else {
-      CM_Error("could not read all of '" << marshal_path << "'");
-    }
+  restoreGamePythonConfig(data);
+}
 
-    free(marshal_buffer);
-    fclose(fp);
-  }
-  else {
-    CM_Error("could not open '" << marshal_path << "'");
+KX_GlobalDictStatus *saveGamePythonConfigAsync()
+{
+  std::vector<char> data;
+  if (!marshalGamePythonConfig(data)) {
+    return nullptr;
   }
+
+  KX_GlobalDictStorage *storage = KX_GetActiveEngine()->GetGlobalDictStorage();
+  return storage->SaveAsync(pathGamePythonConfig(), std::move(data));
+}
+
+KX_GlobalDictStatus *loadGamePythonConfigAsync()
+{
+  KX_GlobalDictStorage *storage = KX_GetActiveEngine()->GetGlobalDictStorage();
+  return storage->LoadAsync(pathGamePythonConfig());
 }
 
 std::string pathGamePythonConfig()
@@ -32,11 +32,13 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "DEV_JoystickDefines.h"  // For JOYINDEX_MAX
 #include "EXP_Python.h"
 #include "MT_Vector3.h"
 
+class KX_GlobalDictStatus;
 class KX_KetsjiEngine;
 
 #ifdef WITH_PYTHON
@@ -72,6 +74,11 @@ void setupGamePython(KX_KetsjiEngine *ketsjiengine,
 std::string pathGamePythonConfig();
 void saveGamePythonConfig();
 void loadGamePythonConfig();
+/// Restore bge.logic.globalDict from marshaled data.
+bool restoreGamePythonConfig(const std::vector<char> &data);
+/// Save and load bge.logic.globalDict in background, the save returns nullptr on marshal failure.
+KX_GlobalDictStatus *saveGamePythonConfigAsync();
+KX_GlobalDictStatus *loadGamePythonConfigAsync();
 
 /// Create a python interpreter and stop the engine until the interpreter is active.
 void createPythonConsole();
@@ -51,6 +51,7 @@
 #  include "KX_ConstraintWrapper.h"
 #  include "KX_EmptyObject.h"
 #  include "KX_FontObject.h"
+#  include "KX_GlobalDictStatus.h"
 #  include "KX_LibLoadStatus.h"
 #  include "KX_Light.h"
 #  include "KX_LodLevel.h"
@@ -233,6 +234,7 @@ PyMODINIT_FUNC initGameTypesPythonBinding(void)
     PyType_Ready_Attr(dict, SCA_GameActuator, init_getset);
     PyType_Ready_Attr(dict, KX_GameObject, init_getset);
     PyType_Ready_Attr(dict, KX_EmptyObject, init_getset);
+    PyType_Ready_Attr(dict, KX_GlobalDictStatus, init_getset);
     PyType_Ready_Attr(dict, KX_LibLoadStatus, init_getset);
     PyType_Ready_Attr(dict, KX_LightObject, init_getset);
     PyType_Ready_Attr(dict, KX_LodLevel, init_getset);
@@ -31,6 +31,7 @@
 KX_PythonProxy::KX_PythonProxy()
     : EXP_Value(),
       m_init(false),
+      m_startSucceeded(false),
       m_pp(nullptr),
 #ifdef WITH_PYTHON
       m_update(nullptr),
@@ -60,6 +61,16 @@ void KX_PythonProxy::SetPrototype(PythonProxy *pp)
   m_pp = pp;
 }
 
+bool KX_PythonProxy::IsStarted() const
+{
+  return m_init;
+}
+
+bool KX_PythonProxy::IsStartSucceeded() const
+{
+  return m_startSucceeded;
+}
+
 void KX_PythonProxy::Start()
 {
   if (!m_pp || m_init) {
@@ -72,7 +83,11 @@ void KX_PythonProxy::Start()
   PyObject *proxy = GetProxy();
   PyObject *arg_dict = (PyObject *)BKE_python_proxy_argument_dict_new(m_pp);
 
-  if (PyObject_CallMethod(proxy, "start", "O", arg_dict)) {
+  PyObject *ret = PyObject_CallMethod(proxy, "start", "O", arg_dict);
+  if (ret) {
+    m_startSucceeded = true;
+    Py_DECREF(ret);
+
     if (PyObject_HasAttrString(proxy, "update")) {
       m_update = PyObject_GetAttrString(proxy, "update");
     }
@@ -132,6 +147,7 @@ void KX_PythonProxy::ProcessReplica()
   EXP_Value::ProcessReplica();
 
   m_init = false;
+  m_startSucceeded = false;
 #ifdef WITH_PYTHON
   m_update = nullptr;
   m_dispose = nullptr;
@@ -30,6 +30,8 @@ class KX_PythonProxy : public EXP_Value {
 
  private:
   bool m_init;
+  /// True when the start callback returned without error.
+  bool m_startSucceeded;
 
   PythonProxy *m_pp;
 
@@ -52,6 +54,11 @@ class KX_PythonProxy : public EXP_Value {
 
   void SetPrototype(PythonProxy *pp);
 
+  /// Return true when the start callback was already invoked.
+  bool IsStarted() const;
+  /// Return true when the start callback was invoked and didn't raise.
+  bool IsStartSucceeded() const;
+
   virtual void Start();
 
   virtual void Update();
@@ -23,7 +23,11 @@
 #include "KX_PythonProxyManager.h"
 
 #include "CM_List.h"
+#include "CM_Message.h"
+#include "CM_Trace.h"
+#include "EXP_ListValue.h"
 #include "KX_GameObject.h"
+#include "KX_PythonComponent.h"
 
 static bool compareObjectDepth(KX_GameObject *o1, KX_GameObject *o2)
 {
@@ -36,6 +40,11 @@ KX_PythonProxyManager::KX_PythonProxyManager()
 
 KX_PythonProxyManager::~KX_PythonProxyManager()
 {
+#ifdef WITH_PYTHON
+  for (auto &pair : m_componentTypes) {
+    Py_XDECREF(pair.second.m_updateAll);
+  }
+#endif
 }
 
 void KX_PythonProxyManager::Register(KX_GameObject *gameobj)
@@ -51,6 +60,188 @@ void KX_PythonProxyManager::Unregister(KX_GameObject *gameobj)
   m_objects_changed = true;
 }
 
+#ifdef WITH_PYTHON
+KX_PythonProxyManager::ComponentType &KX_PythonProxyManager::GetComponentType(
+    KX_PythonComponent *comp)
+{
+  PyTypeObject *pytype = comp->GetPyType();
+
+  const auto it = m_componentTypes.find(pytype);
+  if (it != m_componentTypes.end()) {
+    return it->second;
+  }
+
+  ComponentType &type = m_componentTypes[pytype];
+  type.m_name = pytype->tp_name;
+  type.m_mode = UPDATE_FRAME;
+  type.m_interval = 1;
+  type.m_nextOffset = 0;
+  type.m_updateAll = nullptr;
+  type.m_time = 0;
+  type.m_count = 0;
+  type.m_lastTime = 0;
+  type.m_lastCount = 0;
+
+  // Read the scheduling settings from the class attributes.
+  PyObject *cls = (PyObject *)pytype;
+  PyObject *mode = PyObject_GetAttrString(cls, "updateMode");
+  if (mode) {
+    static const std::map<std::string, UpdateMode> modeNames = {{"FRAME", UPDATE_FRAME},
+                                                                {"INTERVAL", UPDATE_INTERVAL},
+                                                                {"STAGGERED", UPDATE_STAGGERED},
+                                                                {"DEMAND", UPDATE_DEMAND}};
+    const char *name = PyUnicode_Check(mode) ? PyUnicode_AsUTF8(mode) : nullptr;
+    const auto modeIt = name ? modeNames.find(name) : modeNames.end();
+    if (modeIt != modeNames.end()) {
+      type.m_mode = modeIt->second;
+    }
+    else {
+      CM_Warning("component " << type.m_name
+                              << ": invalid updateMode, expected \"FRAME\", \"INTERVAL\", "
+                                 "\"STAGGERED\" or \"DEMAND\"");
+    }
+    Py_DECREF(mode);
+  }
+
+  PyObject *interval = PyObject_GetAttrString(cls, "updateInterval");
+  if (interval) {
+    const long value = PyLong_Check(interval) ? PyLong_AsLong(interval) : 0;
+    if (value >= 1) {
+      type.m_interval = value;
+    }
+    else {
+      CM_Warning("component " << type.m_name << ": updateInterval must be an integer >= 1");
+    }
+    Py_DECREF(interval);
+  }
+
+  PyObject *updateAll = PyObject_GetAttrString(cls, "update_all");
+  if (updateAll) {
+    if (PyCallable_Check(updateAll)) {
+      type.m_updateAll = updateAll;
+    }
+    else {
+      Py_DECREF(updateAll);
+    }
+  }
+
+  // Missing attributes are not errors.
+  PyErr_Clear();
+
+  return type;
+}
+
+void KX_PythonProxyManager::UpdateComponent(KX_PythonComponent *comp)
+{
+  ComponentType &type = GetComponentType(comp);
+
+  if (!comp->IsStarted()) {
+    // A component without prototype is never started.
+    if (comp->GetPrototype()) {
+      comp->SetUpdateOffset(type.m_nextOffset++);
+      comp->Start();
+    }
+    return;
+  }
+
+  // A component whose start failed is never updated, batched or not.
+  if (!comp->IsStartSucceeded()) {
+    return;
+  }
+
+  switch (type.m_mode) {
+    case UPDATE_FRAME: {
+      break;
+    }
+    case UPDATE_INTERVAL: {
+      if ((m_frame % type.m_interval) != 0) {
+        return;
+      }
+      break;
+    }
+    case UPDATE_STAGGERED: {
+      if (((m_frame + comp->GetUpdateOffset()) % type.m_interval) != 0) {
+        return;
+      }
+      break;
+    }
+    case UPDATE_DEMAND: {
+      if (!comp->ConsumeUpdateRequest()) {
+        return;
+      }
+      break;
+    }
+  }
+
+  if (type.m_updateAll) {
+    if (type.m_batch.empty()) {
+      m_batchedTypes.push_back(&type);
+    }
+    type.m_batch.push_back(comp);
+    return;
+  }
+
+  CM_TraceZone traceZone(type.m_name.c_str());
+  const CM_Clock::Rep start = m_clock.GetTimeNano();
+  comp->Update();
+  type.m_time += m_clock.GetTimeNano() - start;
+  ++type.m_count;
+}
+
+void KX_PythonProxyManager::UpdateBatches()
+{
+  // Batches are called in the order their first instance was met, keeping the update deterministic.
+  for (ComponentType *type : m_batchedTypes) {
+    CM_TraceZone traceZone(type->m_name.c_str());
+    const CM_Clock::Rep start = m_clock.GetTimeNano();
+
+    const unsigned int size = type->m_batch.size();
+    PyObject *instances = PyList_New(size);
+    for (unsigned int i = 0; i < size; ++i) {
+      PyList_SET_ITEM(instances, i, type->m_batch[i]->GetProxy());
+    }
+
+    PyObject *ret = PyObject_CallOneArg(type->m_updateAll, instances);
+    if (!ret && PyErr_Occurred()) {
+      type->m_batch.front()->LogError("Failed to invoke the update_all callback.");
+    }
+
+    Py_XDECREF(ret);
+    Py_DECREF(instances);
+
+    type->m_time += m_clock.GetTimeNano() - start;
+    type->m_count += size;
+    type->m_batch.clear();
+  }
+
+  m_batchedTypes.clear();
+}
+
+void KX_PythonProxyManager::MergeProfileInfo(PyObject *dict) const
+{
+  for (const auto &pair : m_componentTypes) {
+    const ComponentType &type = pair.second;
+
+    double time = type.m_lastTime * 1.0e-6;
+    unsigned int count = type.m_lastCount;
+
+    // Sum the timings of the same component class used in several scenes.
+    PyObject *item = PyDict_GetItemString(dict, type.m_name.c_str());
+    if (item) {
+      time += PyFloat_AsDouble(PyTuple_GET_ITEM(item, 0));
+      count += PyLong_AsUnsignedLong(PyTuple_GET_ITEM(item, 1));
+    }
+
+    PyObject *val = PyTuple_New(2);
+    PyTuple_SET_ITEM(val, 0, PyFloat_FromDouble(time));
+    PyTuple_SET_ITEM(val, 1, PyLong_FromUnsignedLong(count));
+
+    PyDict_SetItemString(dict, type.m_name.c_str(), val);
+    Py_DECREF(val);
+  }
+}
+#endif  // WITH_PYTHON
+
 void KX_PythonProxyManager::Update()
 {
   if (m_objects_changed) {
@@ -59,12 +250,39 @@ void KX_PythonProxyManager::Update()
     m_objects_changed = false;
   }
 
+#ifdef WITH_PYTHON
+  for (auto &pair : m_componentTypes) {
+    ComponentType &type = pair.second;
+    type.m_lastTime = type.m_time;
+    type.m_lastCount = type.m_count;
+    type.m_time = 0;
+    type.m_count = 0;
+  }
+
   /* Update object components, we copy the object pointer in a second list to make
    * sure that we iterate on a list which will not be modified, indeed components
-   * can add objects in theirs update.
+   * can add objects in theirs update. The list is a member to not reallocate it every frame.
    */
-  const std::vector<KX_GameObject *> objects = m_objects;
-  for (KX_GameObject *gameobj : objects) {
+  m_updateObjects.assign(m_objects.begin(), m_objects.end());
+  for (KX_GameObject *gameobj : m_updateObjects) {
+    if (gameobj->IsLogicSuspended()) {
+      continue;
+    }
+
+    EXP_ListValue<KX_PythonComponent> *components = gameobj->GetComponents();
+    if (components) {
+      for (KX_PythonComponent *comp : components) {
+        UpdateComponent(comp);
+      }
+    }
+
+    // Update the python proxy of the object itself.
     gameobj->Update();
   }
+
+  // Instances of classes defining update_all are updated with one call per class.
+  UpdateBatches();
+#endif  // WITH_PYTHON
+
+  ++m_frame;
 }
@@ -1,13 +1,72 @@
 #pragma once
 
+#include <map>
+#include <string>
 #include <vector>
 
+#include "CM_Clock.h"
+#include "EXP_Python.h"
+
 class KX_GameObject;
+class KX_PythonComponent;
 
 class KX_PythonProxyManager {
+ public:
+  /// Scheduling class of a component type, read from the class attribute "updateMode".
+  enum UpdateMode {
+    /// Update every logic frame (default).
+    UPDATE_FRAME = 0,
+    /// Update all instances together every "updateInterval" frames.
+    UPDATE_INTERVAL,
+    /// Update every "updateInterval" frames, instances spread over the interval.
+    UPDATE_STAGGERED,
+    /// Update only when requested by KX_PythonComponent.requestUpdate().
+    UPDATE_DEMAND
+  };
+
  private:
+  /// Per component class update settings and statistics.
+  struct ComponentType {
+    std::string m_name;
+    UpdateMode m_mode;
+    unsigned int m_interval;
+    /// Stagger offset given to the next started instance.
+    unsigned int m_nextOffset;
+#ifdef WITH_PYTHON
+    /// Class level update_all(instances) hook, nullptr when the class doesn't define it.
+    PyObject *m_updateAll;
+#endif
+    /// Started instances to pass to m_updateAll this frame.
+    std::vector<KX_PythonComponent *> m_batch;
+
+    /// Time spent in the current frame.
+    CM_Clock::Rep m_time;
+    /// Number of instances updated in the current frame.
+    unsigned int m_count;
+    /// Time and count of the last complete frame, used for profiling.
+    CM_Clock::Rep m_lastTime;
+    unsigned int m_lastCount;
+  };
+
   std::vector<KX_GameObject *> m_objects;
   bool m_objects_changed = false;
+  /// Copy of m_objects iterated during update, kept as member to reuse its allocation.
+  std::vector<KX_GameObject *> m_updateObjects;
+
+#ifdef WITH_PYTHON
+  std::map<PyTypeObject *, ComponentType> m_componentTypes;
+  /// Component types with a non-empty batch in the current frame, by order of first instance.
+  std::vector<ComponentType *> m_batchedTypes;
+#endif
+  /// Logic frame counter used for interval and staggered updates.
+  unsigned int m_frame = 0;
+  CM_Clock m_clock;
+
+#ifdef WITH_PYTHON
+  ComponentType &GetComponentType(KX_PythonComponent *comp);
+  void UpdateComponent(KX_PythonComponent *comp);
+  void UpdateBatches();
+#endif
 
  public:
   KX_PythonProxyManager();
@@ -17,4 +76,9 @@ class KX_PythonProxyManager {
   void Unregister(KX_GameObject *gameobj);
 
   void Update();
+
+#ifdef WITH_PYTHON
+  /// Add the component timings of the last frame in a dictionary of name -> (ms, instances).
+  void MergeProfileInfo(PyObject *dict) const;
+#endif
 };
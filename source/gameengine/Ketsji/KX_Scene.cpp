@@ -64,6 +64,7 @@
 #include "BL_DataConversion.h"
 #include "BL_SceneConverter.h"
 #include "CM_List.h"
+#include "CM_Profiler.h"
 #include "EXP_FloatValue.h"
 #include "KX_2DFilterManager.h"
 #include "KX_BlenderCanvas.h"
@@ -74,6 +75,7 @@
 #include "KX_Light.h"
 #include "KX_LodManager.h"
 #include "KX_MotionState.h"
+#include "KX_MousePickCache.h"
 #include "KX_NetworkMessageScene.h"
 #include "KX_NodeRelationships.h"
 #include "KX_ObstacleSimulation.h"
@@ -151,6 +153,11 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
       m_overrideCullingCamera(nullptr),
       m_ueberExecutionPriority(0),
       m_blenderScene(scene),
+      m_animationCulling(true),
+      m_animationLodDistance(0.0f),
+      m_animationLodRate(2),
+      m_animationFrame(0),
+      m_animationStats{0, 0, 0},
       m_isActivedHysteresis(false),
       m_lodHysteresisValue(0),
       m_isRuntime(true)  // eevee
@@ -205,6 +212,8 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
       m_obstacleSimulation = nullptr;
   }
 
+  m_mousePickCache = new KX_MousePickCache(this);
+
   m_animationPool = BLI_task_pool_create(&m_animationPoolData, TASK_PRIORITY_LOW);
 
 #ifdef WITH_PYTHON
@@ -385,6 +394,8 @@ KX_Scene::~KX_Scene()
   if (m_obstacleSimulation)
     delete m_obstacleSimulation;
 
+  delete m_mousePickCache;
+
   if (m_animationPool) {
     BLI_task_pool_free(m_animationPool);
   }
@@ -1575,6 +1586,11 @@ void KX_Scene::SetActivityCulling(bool b)
   m_activityCulling = b;
 }
 
+KX_ActivityCullingManager &KX_Scene::GetActivityCullingManager()
+{
+  return m_activityCullingManager;
+}
+
 void KX_Scene::AddObjectDebugProperties(class KX_GameObject *gameobj)
 {
   Object *blenderobject = gameobj->GetBlenderObject();
@@ -1658,6 +1674,8 @@ KX_GameObject *KX_Scene::AddNodeReplicaObject(SG_Node *node, KX_GameObject *game
     m_proxyManager.Register(newobj);
   }
 
+  m_activityCullingManager.Register(newobj);
+
   replicanode->SetSGClientObject(newobj);
 
   // this is the list of object that are send to the graphics pipeline
@@ -2197,6 +2215,7 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
   }
 
   m_proxyManager.Unregister(gameobj);
+  m_activityCullingManager.Unregister(gameobj);
 
   gameobj->RemoveMeshes();
 
@@ -2371,6 +2390,9 @@ void KX_Scene::RenderDebugProperties(RAS_DebugDraw &debugDraw,
 // logic stuff
 void KX_Scene::LogicBeginFrame(double curtime, double framestep)
 {
+  // The objects or the cameras may have moved since the last picks.
+  m_mousePickCache->Clear();
+
   // have a look at temp objects ...
   for (KX_GameObject *gameobj : m_tempObjectList) {
     EXP_FloatValue *propval = (EXP_FloatValue *)gameobj->GetProperty("::timebomb");
@@ -2399,73 +2421,142 @@ void KX_Scene::AddAnimatedObject(KX_GameObject *gameobj)
   CM_ListAddIfNotFound(m_animatedlist, gameobj);
 }
 
-// static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(threadid))
-//{
-//  KX_GameObject *gameobj, *parent;
-//  bool needs_update;
-//  KX_Scene::AnimationPoolData *data = (KX_Scene::AnimationPoolData
-//  *)BLI_task_pool_user_data(pool); double curtime = data->curtime;
+void KX_Scene::UpdateAnimations(double curtime)
+{
+  m_animationStats = {0, 0, 0};
+  ++m_animationFrame;
 
-//  gameobj = (KX_GameObject *)taskdata;
+  // The cameras rendering the scene, their frustums are the ones of the last render.
+  std::vector<KX_Camera *> cameras;
+  for (KX_Camera *cam : m_cameralist) {
+    if ((cam == m_active_camera || cam->GetViewport()) && cam->hasValidProjectionMatrix()) {
+      cameras.push_back(cam);
+    }
+  }
 
-//  // Non-armature updates are fast enough, so just update them
-//  needs_update = gameobj->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE;
+  const unsigned int numObjects = m_animatedlist.size();
+  /* Range of the bounds of the visible meshes parented to each armature, an armature without
+   * mesh children is never culled as its pose could be used by other objects. */
+  std::vector<unsigned int> firstBounds(numObjects + 1, 0);
+  std::vector<bool> hasMeshes(numObjects, false);
+  std::array<std::vector<float>, 6> bounds;
 
-//  if (!needs_update) {
-//    // If we got here, we're looking to update an armature, so check its children meshes
-//    // to see if we need to bother with a more expensive pose update
-//    const std::vector<KX_GameObject *> children = gameobj->GetChildren();
+  if (m_animationCulling && !cameras.empty()) {
+    for (unsigned int i = 0; i < numObjects; ++i) {
+      firstBounds[i] = bounds[0].size();
+      KX_GameObject *gameobj = m_animatedlist[i];
+      if (gameobj->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE ||
+          gameobj->IsActionsSuspended())
+      {
+        continue;
+      }
 
-//    bool has_mesh = false, has_non_mesh = false;
+      for (KX_GameObject *child : gameobj->GetFrameChildren()) {
+        if (child->GetMeshCount() == 0) {
+          continue;
+        }
+        hasMeshes[i] = true;
+        if (!child->GetVisible()) {
+          continue;
+        }
 
-//    // Check for meshes that haven't been culled
-//    for (KX_GameObject *child : children) {
-//      // if (!child->GetCulled()) { // eevee disable armature animation culling
-//      needs_update = true;
-//      break;
-//      //}
+        MT_Vector3 min;
+        MT_Vector3 max;
+        child->GetWorldAabb(min, max);
+        for (unsigned short axis = 0; axis < 3; ++axis) {
+          bounds[axis].push_back(min[axis]);
+          bounds[axis + 3].push_back(max[axis]);
+        }
+      }
+    }
+  }
+  firstBounds[numObjects] = bounds[0].size();
+
+  // Visibility of the meshes in any of the cameras.
+  const unsigned int numBounds = bounds[0].size();
+  std::vector<uint32_t> visibleMask((numBounds + 31) / 32, 0);
+  if (numBounds > 0) {
+    std::vector<uint32_t> mask(visibleMask.size());
+    for (KX_Camera *cam : cameras) {
+      cam->GetFrustum().AabbsInsideFrustum(bounds[0].data(),
+                                           bounds[1].data(),
+                                           bounds[2].data(),
+                                           bounds[3].data(),
+                                           bounds[4].data(),
+                                           bounds[5].data(),
+                                           numBounds,
+                                           mask.data());
+      for (unsigned int i = 0, size = mask.size(); i < size; ++i) {
+        visibleMask[i] |= mask[i];
+      }
+    }
+  }
 
-//      if (child->GetMeshCount() == 0)
-//        has_non_mesh = true;
-//      else
-//        has_mesh = true;
-//    }
+  const bool useLod = (m_animationLodDistance > 0.0f && m_animationLodRate > 1 &&
+                       !cameras.empty());
+  const float lodDistance2 = m_animationLodDistance * m_animationLodDistance;
 
-//    // If we didn't find a non-culled mesh, check to see
-//    // if we even have any meshes, and update if this
-//    // armature has only non-mesh children.
-//    if (!needs_update && !has_mesh && has_non_mesh)
-//      needs_update = true;
-//  }
+  for (unsigned int i = 0; i < numObjects; ++i) {
+    KX_GameObject *gameobj = m_animatedlist[i];
+    if (gameobj->IsActionsSuspended()) {
+      continue;
+    }
 
-//  // If the object is a culled armature, then we manage only the animation time and end of its
-//  // animations.
-//  gameobj->UpdateActionManager(curtime, needs_update);
+    // Non-armature updates are fast enough, so just update them.
+    bool needsUpdate = true;
+    if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
+      if (hasMeshes[i]) {
+        needsUpdate = false;
+        for (unsigned int j = firstBounds[i]; j < firstBounds[i + 1]; ++j) {
+          if (visibleMask[j / 32] & (1u << (j % 32))) {
+            needsUpdate = true;
+            break;
+          }
+        }
+      }
 
-//  if (needs_update) {
-//    const std::vector<KX_GameObject *> children = gameobj->GetChildren();
-//    parent = gameobj->GetParent();
-//  }
-//}
+      if (!needsUpdate) {
+        ++m_animationStats.m_culled;
+      }
+      // Far armatures are updated every few frames, spread over the frames by their index.
+      else if (useLod && (m_animationFrame + i) % m_animationLodRate != 0) {
+        const MT_Vector3 &position = gameobj->NodeGetWorldPosition();
+        bool far = true;
+        for (KX_Camera *cam : cameras) {
+          if ((cam->NodeGetWorldPosition() - position).length2() < lodDistance2) {
+            far = false;
+            break;
+          }
+        }
 
-void KX_Scene::UpdateAnimations(double curtime)
-{
-  // m_animationPoolData.curtime = curtime;
+        if (far) {
+          needsUpdate = false;
+          ++m_animationStats.m_throttled;
+        }
+      }
 
-  for (KX_GameObject *gameobj : m_animatedlist) {
-    // BLI_task_pool_push(m_animationPool, update_anim_thread_func, gameobj, false,
-    // TASK_PRIORITY_LOW);
-    if (!gameobj->IsActionsSuspended()) {
-      gameobj->UpdateActionManager(curtime, true);
+      if (needsUpdate) {
+        ++m_animationStats.m_updated;
+      }
     }
+
+    /* If the object is a culled or throttled armature, then we manage only the animation time
+     * and end of its animations. */
+    gameobj->UpdateActionManager(curtime, needsUpdate);
   }
+}
 
-  // BLI_task_pool_work_and_wait(m_animationPool);
+const KX_Scene::AnimationStats &KX_Scene::GetAnimationStats() const
+{
+  return m_animationStats;
 }
 
 void KX_Scene::LogicUpdateFrame(double curtime)
 {
-  m_proxyManager.Update();
+  {
+    CM_ProfileZone zone("Components");
+    m_proxyManager.Update();
+  }
 
   m_logicmgr->UpdateFrame(curtime);
 }
@@ -2567,22 +2658,7 @@ void KX_Scene::UpdateObjectActivity(void)
     return;
   }
 
-  for (KX_GameObject *gameobj : m_objectlist) {
-    // If the object doesn't manage activity culling we don't compute distance.
-    if (gameobj->GetActivityCullingInfo().m_flags ==
-        KX_GameObject::ActivityCullingInfo::ACTIVITY_NONE) {
-      continue;
-    }
-
-    // For each camera compute the distance to objects and keep the minimum distance.
-    const MT_Vector3 &obpos = gameobj->NodeGetWorldPosition();
-    float dist = FLT_MAX;
-    for (const MT_Vector3 &campos : camPositions) {
-      // Keep the minimum distance.
-      dist = min_ff((obpos - campos).length2(), dist);
-    }
-    gameobj->UpdateActivity(dist);
-  }
+  m_activityCullingManager.Update(camPositions);
 }
 
 KX_NetworkMessageScene *KX_Scene::GetNetworkMessageScene()
@@ -2718,6 +2794,9 @@ bool KX_Scene::MergeScene(KX_Scene *other)
   for (KX_GameObject *gameobj : *other->GetObjectList()) {
     MergeScene_GameObject(gameobj, this, other);
 
+    other->GetActivityCullingManager().Unregister(gameobj);
+    m_activityCullingManager.Register(gameobj);
+
     /* add properties to debug list for LibLoad objects */
     if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::AUTO_ADD_DEBUG_PROPERTIES)) {
       AddObjectDebugProperties(gameobj);
@@ -3226,6 +3305,30 @@ int KX_Scene::pyattr_set_gravity(EXP_PyObjectPlus *self_v,
   return PY_SET_ATTR_SUCCESS;
 }
 
+PyObject *KX_Scene::pyattr_get_activity_culling_slices(EXP_PyObjectPlus *self_v,
+                                                       const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_Scene *self = static_cast<KX_Scene *>(self_v);
+  return PyLong_FromLong(self->m_activityCullingManager.GetSlices());
+}
+
+int KX_Scene::pyattr_set_activity_culling_slices(EXP_PyObjectPlus *self_v,
+                                                 const EXP_PYATTRIBUTE_DEF *attrdef,
+                                                 PyObject *value)
+{
+  KX_Scene *self = static_cast<KX_Scene *>(self_v);
+
+  const long slices = PyLong_AsLong(value);
+  if ((slices == -1 && PyErr_Occurred()) || slices < 1) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.activityCullingSlices = int: KX_Scene, expected an integer above 0");
+    return PY_SET_ATTR_FAIL;
+  }
+
+  self->m_activityCullingManager.SetSlices(slices);
+  return PY_SET_ATTR_SUCCESS;
+}
+
 PyAttributeDef KX_Scene::Attributes[] = {
     EXP_PYATTRIBUTE_RO_FUNCTION("name", KX_Scene, pyattr_get_name),
     EXP_PYATTRIBUTE_RO_FUNCTION("objects", KX_Scene, pyattr_get_objects),
@@ -3250,6 +3353,14 @@ PyAttributeDef KX_Scene::Attributes[] = {
         "pre_draw_setup", KX_Scene, pyattr_get_drawing_callback, pyattr_set_drawing_callback),
     EXP_PYATTRIBUTE_RW_FUNCTION("gravity", KX_Scene, pyattr_get_gravity, pyattr_set_gravity),
     EXP_PYATTRIBUTE_BOOL_RO("activityCulling", KX_Scene, m_activityCulling),
+    EXP_PYATTRIBUTE_BOOL_RW("animationCulling", KX_Scene, m_animationCulling),
+    EXP_PYATTRIBUTE_FLOAT_RW(
+        "animationLodDistance", 0.0f, FLT_MAX, KX_Scene, m_animationLodDistance),
+    EXP_PYATTRIBUTE_INT_RW("animationLodRate", 1, 1000, true, KX_Scene, m_animationLodRate),
+    EXP_PYATTRIBUTE_RW_FUNCTION("activityCullingSlices",
+                                KX_Scene,
+                                pyattr_get_activity_culling_slices,
+                                pyattr_set_activity_culling_slices),
     EXP_PYATTRIBUTE_BOOL_RO("dbvt_culling", KX_Scene, m_dbvt_culling),
     EXP_PYATTRIBUTE_RO_FUNCTION("logger", KX_Scene, KX_PythonProxy::pyattr_get_logger),
     EXP_PYATTRIBUTE_RO_FUNCTION("loggerName", KX_Scene, KX_PythonProxy::pyattr_get_logger_name),
@@ -39,6 +39,7 @@
 
 #include "EXP_PyObjectPlus.h"
 #include "EXP_Value.h"
+#include "KX_ActivityCullingManager.h"
 #include "KX_PhysicsEngineEnums.h"
 #include "KX_PythonProxy.h"
 #include "KX_PythonProxyManager.h"
@@ -82,6 +83,7 @@ class RAS_2DFilterManager;
 class KX_2DFilterManager;
 class BL_SceneConverter;
 struct KX_ClientObjectInfo;
+class KX_MousePickCache;
 class KX_ObstacleSimulation;
 struct TaskPool;
 
@@ -111,6 +113,13 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
     double curtime;
   };
 
+  /// Number of armatures updated, culled and throttled by the last animation update.
+  struct AnimationStats {
+    unsigned int m_updated;
+    unsigned int m_culled;
+    unsigned int m_throttled;
+  };
+
  private:
   Py_Header
 
@@ -190,6 +199,9 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
 
   KX_PythonProxyManager m_proxyManager;
 
+  /// Spatial grid of the objects used for activity culling.
+  KX_ActivityCullingManager m_activityCullingManager;
+
   /**
    * physics engine abstraction
    */
@@ -300,9 +312,22 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
 
   KX_ObstacleSimulation *m_obstacleSimulation;
 
+  /// Mouse picking rays shared by the mouse focus sensors.
+  KX_MousePickCache *m_mousePickCache;
+
   AnimationPoolData m_animationPoolData;
   TaskPool *m_animationPool;
 
+  /// Skip the pose evaluation of the armatures whose meshes are all outside the camera frustums.
+  bool m_animationCulling;
+  /** Distance to the cameras beyond which the armature poses are evaluated only every
+   * m_animationLodRate frames, 0 to disable.
+   */
+  float m_animationLodDistance;
+  int m_animationLodRate;
+  unsigned int m_animationFrame;
+  AnimationStats m_animationStats;
+
   /**
    * LOD Hysteresis settings
    */
@@ -417,6 +442,7 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   void LogicBeginFrame(double curtime, double framestep);
   void LogicUpdateFrame(double curtime);
   void UpdateAnimations(double curtime);
+  const AnimationStats &GetAnimationStats() const;
 
   void LogicEndFrame();
 
@@ -505,6 +531,8 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   // Enable/disable activity culling.
   void SetActivityCulling(bool b);
 
+  KX_ActivityCullingManager &GetActivityCullingManager();
+
   // use of DBVT tree for camera culling
   void SetDbvtCulling(bool b)
   {
@@ -552,6 +580,11 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
     return m_obstacleSimulation;
   }
 
+  KX_MousePickCache *GetMousePickCache()
+  {
+    return m_mousePickCache;
+  }
+
   /**  Inherited from EXP_Value -- returns the name of this object. */
   virtual std::string GetName();
 
@@ -617,6 +650,11 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   static int pyattr_set_gravity(EXP_PyObjectPlus *self_v,
                                 const EXP_PYATTRIBUTE_DEF *attrdef,
                                 PyObject *value);
+  static PyObject *pyattr_get_activity_culling_slices(EXP_PyObjectPlus *self_v,
+                                                      const EXP_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_set_activity_culling_slices(EXP_PyObjectPlus *self_v,
+                                                const EXP_PYATTRIBUTE_DEF *attrdef,
+                                                PyObject *value);
 
   /* getitem/setitem */
   static PyMappingMethods Mapping;
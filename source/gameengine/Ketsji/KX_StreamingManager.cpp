@@ -0,0 +1,336 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_StreamingManager.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_StreamingManager.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_fileops.h"
+
+#include "BL_Converter.h"
+#include "CM_Message.h"
+#include "KX_Camera.h"
+#include "KX_KetsjiEngine.h"
+#include "KX_LibLoadStatus.h"
+#include "KX_Scene.h"
+
+KX_StreamingManager::KX_StreamingManager(KX_KetsjiEngine *engine)
+    : m_engine(engine),
+      m_budget(0),
+      m_frame(0),
+      m_numLoads(0),
+      m_numEvictions(0),
+      m_numFailures(0)
+{
+}
+
+KX_StreamingManager::~KX_StreamingManager()
+{
+}
+
+void KX_StreamingManager::SetBudget(size_t budget)
+{
+  m_budget = budget;
+}
+
+size_t KX_StreamingManager::GetBudget() const
+{
+  return m_budget;
+}
+
+size_t KX_StreamingManager::GetResidentSize() const
+{
+  size_t size = 0;
+  for (const auto &pair : m_libraries) {
+    if (pair.second.m_state != LIBRARY_QUEUED) {
+      size += pair.second.m_size;
+    }
+  }
+  return size;
+}
+
+void KX_StreamingManager::Request(const std::string &region,
+                                  const std::string &path,
+                                  const std::string &group,
+                                  KX_Scene *scene,
+                                  short options,
+                                  float priority,
+                                  const MT_Vector3 *position)
+{
+  std::map<std::string, Library>::iterator it = m_libraries.find(path);
+  if (it == m_libraries.end()) {
+    Library library;
+    library.m_status = nullptr;
+    library.m_memoryStart = 0;
+    library.m_size = 0;
+    // A library already loaded by LibLoad is only tracked, its size is unknown.
+    library.m_owned = !m_engine->GetConverter()->GetMainDynamicPath(path);
+    library.m_state = library.m_owned ? LIBRARY_QUEUED : LIBRARY_RESIDENT;
+    it = m_libraries.emplace(path, library).first;
+  }
+
+  Library &library = it->second;
+  if (library.m_state == LIBRARY_QUEUED || library.m_regions.empty()) {
+    library.m_group = group;
+    library.m_scene = scene;
+    library.m_options = options;
+  }
+  library.m_regions.insert(region);
+  library.m_priority = priority;
+  library.m_hasPosition = (position != nullptr);
+  if (position) {
+    library.m_position = *position;
+  }
+  library.m_lastUsed = m_frame;
+}
+
+void KX_StreamingManager::Release(const std::string &region, const std::string &path)
+{
+  for (std::map<std::string, Library>::iterator it = m_libraries.begin();
+       it != m_libraries.end();)
+  {
+    Library &library = it->second;
+    if (!path.empty() && it->first != path) {
+      ++it;
+      continue;
+    }
+
+    library.m_regions.erase(region);
+    // A library no longer needed before its load is just dropped.
+    if (library.m_regions.empty() && library.m_state == LIBRARY_QUEUED) {
+      it = m_libraries.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
+void KX_StreamingManager::Evict()
+{
+  if (m_budget == 0) {
+    return;
+  }
+
+  BL_Converter *converter = m_engine->GetConverter();
+  size_t size = GetResidentSize();
+  while (size > m_budget) {
+    std::map<std::string, Library>::iterator lru = m_libraries.end();
+    for (std::map<std::string, Library>::iterator it = m_libraries.begin();
+         it != m_libraries.end();
+         ++it)
+    {
+      const Library &library = it->second;
+      if (library.m_owned && library.m_state == LIBRARY_RESIDENT && library.m_regions.empty() &&
+          (lru == m_libraries.end() || library.m_lastUsed < lru->second.m_lastUsed))
+      {
+        lru = it;
+      }
+    }
+
+    // All the resident libraries are held by a region.
+    if (lru == m_libraries.end() || !converter->FreeBlendFile(lru->first)) {
+      break;
+    }
+
+    size -= lru->second.m_size;
+    m_libraries.erase(lru);
+    ++m_numEvictions;
+  }
+}
+
+void KX_StreamingManager::LoadNext()
+{
+  std::map<std::string, Library>::iterator next = m_libraries.end();
+  for (std::map<std::string, Library>::iterator it = m_libraries.begin(); it != m_libraries.end();
+       ++it)
+  {
+    const Library &library = it->second;
+    // The libraries are linked on the main thread, one load per frame limits the stalls.
+    if (library.m_state == LIBRARY_LOADING) {
+      return;
+    }
+    if (library.m_state == LIBRARY_QUEUED &&
+        (next == m_libraries.end() || library.m_priority < next->second.m_priority))
+    {
+      next = it;
+    }
+  }
+
+  if (next == m_libraries.end() || (m_budget != 0 && GetResidentSize() >= m_budget)) {
+    return;
+  }
+
+  Library &library = next->second;
+  BL_Converter *converter = m_engine->GetConverter();
+  char *err_str = nullptr;
+  library.m_memoryStart = MEM_get_memory_in_use();
+  KX_LibLoadStatus *status = converter->LinkBlendFilePath(
+      next->first.c_str(),
+      const_cast<char *>(library.m_group.c_str()),
+      std::vector<std::string>(),
+      library.m_scene,
+      &err_str,
+      library.m_options);
+
+  if (!status) {
+    CM_Error("can't stream library \"" << next->first << "\": " << (err_str ? err_str : ""));
+    m_libraries.erase(next);
+    ++m_numFailures;
+    return;
+  }
+
+  library.m_status = status;
+  library.m_state = LIBRARY_LOADING;
+  // The synchronous loads are already converted and merged.
+  FinishLoad(next->first, library);
+  ++m_numLoads;
+}
+
+void KX_StreamingManager::FinishLoad(const std::string &path, Library &library)
+{
+  if (!m_engine->GetConverter()->IsLoadFinished(library.m_status)) {
+    return;
+  }
+
+  /* The memory in use also changes with the allocations of the game during an async load, the
+   * size of the file is a lower bound of the library data. */
+  const size_t memory = MEM_get_memory_in_use();
+  const size_t memorySize = (memory > library.m_memoryStart) ? memory - library.m_memoryStart : 0;
+  const size_t fileSize = BLI_file_size(path.c_str());
+  library.m_size = (fileSize == size_t(-1)) ? memorySize : std::max(memorySize, fileSize);
+  library.m_state = LIBRARY_RESIDENT;
+}
+
+void KX_StreamingManager::Update()
+{
+  ++m_frame;
+
+  if (m_libraries.empty()) {
+    return;
+  }
+
+  BL_Converter *converter = m_engine->GetConverter();
+  EXP_ListValue<KX_Scene> *scenes = m_engine->CurrentScenes();
+
+  for (std::map<std::string, Library>::iterator it = m_libraries.begin();
+       it != m_libraries.end();)
+  {
+    Library &library = it->second;
+    const bool sceneValid = scenes->SearchValue(library.m_scene);
+
+    // The async loads are finished by BL_Converter::MergeAsyncLoads just before the update.
+    if (library.m_state == LIBRARY_LOADING) {
+      FinishLoad(it->first, library);
+    }
+
+    // The scene to merge into was removed before the load, or the library was freed by LibFree.
+    if ((library.m_state == LIBRARY_QUEUED && !sceneValid) ||
+        (library.m_state == LIBRARY_RESIDENT && !converter->GetMainDynamicPath(it->first)))
+    {
+      it = m_libraries.erase(it);
+      continue;
+    }
+
+    if (!library.m_regions.empty()) {
+      library.m_lastUsed = m_frame;
+    }
+
+    if (library.m_hasPosition && sceneValid) {
+      KX_Camera *camera = library.m_scene->GetActiveCamera();
+      if (camera) {
+        library.m_priority = (camera->NodeGetWorldPosition() - library.m_position).length();
+      }
+    }
+
+    ++it;
+  }
+
+  Evict();
+  LoadNext();
+}
+
+void KX_StreamingManager::Clear()
+{
+  m_libraries.clear();
+}
+
+#ifdef WITH_PYTHON
+
+PyObject *KX_StreamingManager::GetPyInfo() const
+{
+  static const char *stateNames[] = {"QUEUED", "LOADING", "RESIDENT"};
+
+  unsigned int numStates[3] = {0, 0, 0};
+  PyObject *libraries = PyDict_New();
+  for (const auto &pair : m_libraries) {
+    const Library &library = pair.second;
+    ++numStates[library.m_state];
+
+    PyObject *regions = PyList_New(library.m_regions.size());
+    unsigned int i = 0;
+    for (const std::string &region : library.m_regions) {
+      PyList_SET_ITEM(regions, i++, PyUnicode_FromString(region.c_str()));
+    }
+
+    PyObject *dict = PyDict_New();
+    const std::pair<const char *, PyObject *> items[] = {
+        {"state", PyUnicode_FromString(stateNames[library.m_state])},
+        {"size", PyLong_FromSize_t(library.m_size)},
+        {"priority", PyFloat_FromDouble(library.m_priority)},
+        {"regions", regions}};
+    for (const std::pair<const char *, PyObject *> &item : items) {
+      PyDict_SetItemString(dict, item.first, item.second);
+      Py_DECREF(item.second);
+    }
+
+    PyDict_SetItemString(libraries, pair.first.c_str(), dict);
+    Py_DECREF(dict);
+  }
+
+  PyObject *info = PyDict_New();
+  const std::pair<const char *, PyObject *> items[] = {
+      {"budget", PyLong_FromSize_t(m_budget)},
+      {"resident_size", PyLong_FromSize_t(GetResidentSize())},
+      {"queued", PyLong_FromLong(numStates[LIBRARY_QUEUED])},
+      {"loading", PyLong_FromLong(numStates[LIBRARY_LOADING])},
+      {"resident", PyLong_FromLong(numStates[LIBRARY_RESIDENT])},
+      {"loads", PyLong_FromLong(m_numLoads)},
+      {"evictions", PyLong_FromLong(m_numEvictions)},
+      {"failures", PyLong_FromLong(m_numFailures)},
+      {"libraries", libraries}};
+  for (const std::pair<const char *, PyObject *> &item : items) {
+    PyDict_SetItemString(info, item.first, item.second);
+    Py_DECREF(item.second);
+  }
+
+  return info;
+}
+
+#endif  // WITH_PYTHON
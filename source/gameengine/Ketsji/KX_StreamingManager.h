@@ -0,0 +1,128 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_StreamingManager.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "MT_Vector3.h"
+
+#ifdef WITH_PYTHON
+#  include "EXP_Python.h"
+#endif
+
+class KX_KetsjiEngine;
+class KX_LibLoadStatus;
+class KX_Scene;
+
+/** Streaming of the libraries loaded through the converter under a memory budget.
+ *
+ * Libraries are requested by named regions (e.g. a level section), a library is needed while at
+ * least one region holds it. The needed libraries are loaded one at a time, the lowest priority
+ * value first; the priority of a library given a position is its distance to the active camera of
+ * its scene. Released libraries stay resident, when the memory of the resident libraries exceeds
+ * the budget the least recently used of them are freed, and no load starts while it's exceeded.
+ * A library already loaded by LibLoad is owned by the scripts, it's never freed nor counted.
+ */
+class KX_StreamingManager {
+ public:
+  enum LibraryState { LIBRARY_QUEUED = 0, LIBRARY_LOADING, LIBRARY_RESIDENT };
+
+ private:
+  struct Library {
+    std::string m_group;
+    KX_Scene *m_scene;
+    short m_options;
+    /// Regions holding the library.
+    std::set<std::string> m_regions;
+    LibraryState m_state;
+    float m_priority;
+    bool m_hasPosition;
+    MT_Vector3 m_position;
+    KX_LibLoadStatus *m_status;
+    /// True if the library was loaded by the manager, which can then free it.
+    bool m_owned;
+    /// Memory in use when the load started, in bytes.
+    size_t m_memoryStart;
+    /** Memory allocated from the start of the load to the end of its merge, at least the size of
+     * the file, in bytes. An estimate including the other allocations done meanwhile. */
+    size_t m_size;
+    /// Frame the library was last held by a region, for eviction.
+    unsigned int m_lastUsed;
+  };
+
+  KX_KetsjiEngine *m_engine;
+  /// Budget in bytes of the resident libraries, 0 for none.
+  size_t m_budget;
+  std::map<std::string, Library> m_libraries;
+  unsigned int m_frame;
+
+  unsigned int m_numLoads;
+  unsigned int m_numEvictions;
+  unsigned int m_numFailures;
+
+  size_t GetResidentSize() const;
+  /// Free the least recently used released libraries until the resident size fits the budget.
+  void Evict();
+  /// Start the load of the queued library of lowest priority.
+  void LoadNext();
+  /// Make a loading library resident and measure its size once its load is merged.
+  void FinishLoad(const std::string &path, Library &library);
+
+ public:
+  KX_StreamingManager(KX_KetsjiEngine *engine);
+  ~KX_StreamingManager();
+
+  void SetBudget(size_t budget);
+  size_t GetBudget() const;
+
+  /** Hold a library for a region, queuing its load if it's not resident.
+   * \param group The data-block type to load, as in LibLoad.
+   * \param options The BL_Converter::LIB_LOAD_* options of the load.
+   * \param position The position used for the priority, nullptr to use priority.
+   */
+  void Request(const std::string &region,
+               const std::string &path,
+               const std::string &group,
+               KX_Scene *scene,
+               short options,
+               float priority,
+               const MT_Vector3 *position);
+  /// Release a library held by a region, or all the libraries of the region if path is empty.
+  void Release(const std::string &region, const std::string &path);
+
+  /// Update the priorities, start a load and evict libraries, once per frame.
+  void Update();
+  /// Forget all the libraries, the converter frees them at exit.
+  void Clear();
+
+#ifdef WITH_PYTHON
+  /// Return a dictionary of the residency and loading statistics.
+  PyObject *GetPyInfo() const;
+#endif
+};
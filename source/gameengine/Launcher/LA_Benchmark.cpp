@@ -0,0 +1,199 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Launcher/LA_Benchmark.cpp
+ *  \ingroup player
+ */
+
+#include "LA_Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "CM_Message.h"
+#include "CM_Profiler.h"
+#include "EXP_ListValue.h"
+#include "KX_KetsjiEngine.h"
+#include "KX_Scene.h"
+#include "PHY_IPhysicsEnvironment.h"
+
+void LA_Benchmark::Count::Add(unsigned int value)
+{
+  m_last = value;
+  m_max = std::max(m_max, value);
+}
+
+LA_Benchmark::LA_Benchmark(const std::string &filePath, unsigned int numFrames, unsigned int seed)
+    : m_filePath(filePath),
+      m_numFrames(numFrames),
+      m_seed(seed),
+      m_step(0),
+      m_frame(0),
+      m_objects({0, 0}),
+      m_controllers({0, 0}),
+      m_activeBodies({0, 0}),
+      m_contactManifolds({0, 0})
+{
+  m_categoryTimes.resize(CM_Profiler::GetNumCategories());
+  for (std::vector<float> &times : m_categoryTimes) {
+    times.reserve(numFrames);
+  }
+  m_frameTimes.reserve(numFrames);
+}
+
+unsigned int LA_Benchmark::GetSeed() const
+{
+  return m_seed;
+}
+
+double LA_Benchmark::GetClockTime(double ticRate) const
+{
+  return m_step / ticRate;
+}
+
+bool LA_Benchmark::IsFinished() const
+{
+  return (m_frame >= m_numFrames);
+}
+
+void LA_Benchmark::AddFrame(KX_KetsjiEngine *engine)
+{
+  // The first frame has no elapsed time, it proceeds no logic step.
+  if (m_step++ == 0) {
+    return;
+  }
+
+  float frameTime = 0.0f;
+  for (unsigned int i = 0, size = m_categoryTimes.size(); i < size; ++i) {
+    const float time = CM_Profiler::GetLastFrameTime(CM_Profiler::GetCategoryZone(i));
+    m_categoryTimes[i].push_back(time);
+    frameTime += time;
+  }
+  m_frameTimes.push_back(frameTime);
+
+  unsigned int objects = 0;
+  unsigned int controllers = 0;
+  unsigned int activeBodies = 0;
+  unsigned int contactManifolds = 0;
+  for (KX_Scene *scene : engine->CurrentScenes()) {
+    objects += scene->GetObjectList()->GetCount();
+    PHY_IPhysicsEnvironment *physEnv = scene->GetPhysicsEnvironment();
+    controllers += physEnv->GetNumControllers();
+    activeBodies += physEnv->GetNumActiveBodies();
+    contactManifolds += physEnv->GetNumContactManifolds();
+  }
+
+  m_objects.Add(objects);
+  m_controllers.Add(controllers);
+  m_activeBodies.Add(activeBodies);
+  m_contactManifolds.Add(contactManifolds);
+
+  ++m_frame;
+}
+
+static void write_times(std::ofstream &file, std::vector<float> times)
+{
+  if (times.empty()) {
+    file << "{}";
+    return;
+  }
+
+  const unsigned int size = times.size();
+  double sum = 0.0;
+  for (float time : times) {
+    sum += time;
+  }
+  const auto minmax = std::minmax_element(times.begin(), times.end());
+  const double min = *minmax.first;
+  const double max = *minmax.second;
+
+  const auto percentile = [&times, size](double p) {
+    const unsigned int rank = std::max(1u, (unsigned int)std::ceil(p * size));
+    std::nth_element(times.begin(), times.begin() + (rank - 1), times.end());
+    return (double)times[rank - 1];
+  };
+
+  // Times in milliseconds.
+  file << "{\"mean\": " << sum / size * 1000.0 << ", \"min\": " << min * 1000.0
+       << ", \"max\": " << max * 1000.0 << ", \"p50\": " << percentile(0.5) * 1000.0
+       << ", \"p95\": " << percentile(0.95) * 1000.0
+       << ", \"p99\": " << percentile(0.99) * 1000.0 << "}";
+}
+
+bool LA_Benchmark::WriteFile(const std::string &blendFile, double ticRate) const
+{
+  std::ofstream file(m_filePath, std::ios::trunc);
+  if (!file) {
+    CM_Error("can't write benchmark file \"" << m_filePath << "\"");
+    return false;
+  }
+
+  std::string blendName;
+  for (char c : blendFile) {
+    if (c == '"' || c == '\\') {
+      blendName += '\\';
+    }
+    blendName += c;
+  }
+
+  file << "{\n";
+  file << "  \"file\": \"" << blendName << "\",\n";
+  file << "  \"frames\": " << m_frame << ",\n";
+  file << "  \"tic_rate\": " << ticRate << ",\n";
+  file << "  \"seed\": " << m_seed << ",\n";
+  file << "  \"real_time\": " << m_clock.GetTimeSecond() << ",\n";
+
+  file << "  \"times\": {\n";
+  for (unsigned int i = 0, size = m_categoryTimes.size(); i < size; ++i) {
+    const CM_Profiler::Zone &zone = CM_Profiler::GetZones()[CM_Profiler::GetCategoryZone(i)];
+    file << "    \"" << zone.m_name << "\": ";
+    write_times(file, m_categoryTimes[i]);
+    file << ",\n";
+  }
+  file << "    \"Frame\": ";
+  write_times(file, m_frameTimes);
+  file << "\n  },\n";
+
+  file << "  \"counts\": {\n";
+  const std::pair<const char *, const Count &> counts[] = {
+      {"objects", m_objects},
+      {"physics_controllers", m_controllers},
+      {"active_bodies", m_activeBodies},
+      {"contact_manifolds", m_contactManifolds}};
+  for (unsigned int i = 0; i < 4; ++i) {
+    file << "    \"" << counts[i].first << "\": {\"last\": " << counts[i].second.m_last
+         << ", \"max\": " << counts[i].second.m_max << "}" << ((i < 3) ? ",\n" : "\n");
+  }
+  file << "  }\n";
+  file << "}\n";
+
+  file.close();
+  if (!file) {
+    CM_Error("can't write benchmark file \"" << m_filePath << "\"");
+    return false;
+  }
+
+  CM_Message("Benchmark of " << m_frame << " frames written to \"" << m_filePath << "\"");
+
+  return true;
+}
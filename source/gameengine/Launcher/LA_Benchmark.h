@@ -0,0 +1,85 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file LA_Benchmark.h
+ *  \ingroup player
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "CM_Clock.h"
+
+class KX_KetsjiEngine;
+
+/** Measure of a fixed number of frames computed without render.
+ *
+ * The frames advance the engine clock by exactly one logic step, so that a run of a game is
+ * reproducible. The first frame only starts the engine clock and isn't measured. The time of the
+ * profiler categories and the object and physics counts of each frame are collected and their
+ * statistics written to a JSON file at the end of the run.
+ */
+class LA_Benchmark {
+ private:
+  struct Count {
+    unsigned int m_last;
+    unsigned int m_max;
+
+    void Add(unsigned int value);
+  };
+
+  std::string m_filePath;
+  unsigned int m_numFrames;
+  unsigned int m_seed;
+  /// Number of frames run, including the first frame not measured.
+  unsigned int m_step;
+  /// Number of frames measured.
+  unsigned int m_frame;
+
+  /// Time in seconds of each category and of the whole frame for each frame.
+  std::vector<std::vector<float>> m_categoryTimes;
+  std::vector<float> m_frameTimes;
+
+  Count m_objects;
+  Count m_controllers;
+  Count m_activeBodies;
+  Count m_contactManifolds;
+
+  /// Real time of the whole run.
+  CM_Clock m_clock;
+
+ public:
+  LA_Benchmark(const std::string &filePath, unsigned int numFrames, unsigned int seed);
+
+  unsigned int GetSeed() const;
+  /// Engine clock time of the next frame.
+  double GetClockTime(double ticRate) const;
+  /// Return true when all the frames were measured.
+  bool IsFinished() const;
+
+  /// Collect the measures of the last frame.
+  void AddFrame(KX_KetsjiEngine *engine);
+  /// Write the statistics of the measured frames.
+  bool WriteFile(const std::string &blendFile, double ticRate) const;
+};
@@ -37,7 +37,9 @@
 
 #include "BL_Converter.h"
 #include "BL_DataConversion.h"
+#include "BL_MeshCache.h"
 #include "CM_Message.h"
+#include "CM_Trace.h"
 #include "DEV_EventConsumer.h"
 #include "DEV_InputDevice.h"
 #include "DEV_Joystick.h"
@@ -49,9 +51,15 @@
 #include "KX_PyConstraintBinding.h"
 #include "KX_PythonInit.h"
 #include "KX_PythonMain.h"
+#include "LA_Benchmark.h"
 #include "LA_System.h"
 #include "LA_SystemCommandLine.h"
 
+#ifdef WITH_BULLET
+#  include "CcdBvhCache.h"
+#  include "CcdShapeCache.h"
+#endif
+
 #ifdef WITH_PYTHON
 #  include "Texture.h"  // For FreeAllTextures.
 #endif                  // WITH_PYTHON
@@ -84,6 +92,7 @@ LA_Launcher::LA_Launcher(GHOST_ISystem *system,
       m_canvas(nullptr),
       m_rasterizer(nullptr),
       m_converter(nullptr),
+      m_benchmark(nullptr),
 #ifdef WITH_PYTHON
       m_globalDict(nullptr),
       m_gameLogic(nullptr),
@@ -141,6 +150,21 @@ void LA_Launcher::InitEngine()
   bool frameRate = (SYS_GetCommandLineInt(syshandle, "show_framerate", 0) != 0);
   bool nodepwarnings = (SYS_GetCommandLineInt(syshandle, "ignore_deprecation_warnings", 1) != 0);
   bool restrictAnimFPS = (gm.flag & GAME_RESTRICT_ANIM_UPDATES) != 0;
+  bool warmMeshCache = (SYS_GetCommandLineInt(syshandle, "warm_mesh_cache", 0) != 0);
+  bool meshCache = warmMeshCache || (SYS_GetCommandLineInt(syshandle, "mesh_cache", 0) != 0);
+  bool bvhCache = warmMeshCache || (SYS_GetCommandLineInt(syshandle, "bvh_cache", 0) != 0);
+  int hullMaxVertices = SYS_GetCommandLineInt(syshandle, "hull_max_vertices", 0);
+  const char *traceFile = SYS_GetCommandLineString(syshandle, "trace_file", nullptr);
+  const int benchmarkFrames = SYS_GetCommandLineInt(syshandle, "benchmark_frames", 0);
+  const char *benchmarkFile = SYS_GetCommandLineString(
+      syshandle, "benchmark_file", "benchmark.json");
+  const int benchmarkSeed = SYS_GetCommandLineInt(syshandle, "benchmark_seed", 1);
+  const bool benchmark = (benchmarkFrames > 0);
+  const int audioMaxVoices = SYS_GetCommandLineInt(syshandle, "audio_max_voices", 0);
+  const float audioVirtualVolume = SYS_GetCommandLineFloat(
+      syshandle, "audio_virtual_volume", 0.001f);
+  const int audioRenderThreads = SYS_GetCommandLineInt(syshandle, "audio_render_threads", 1);
+  const bool frameArenaStats = (SYS_GetCommandLineInt(syshandle, "frame_arena_stats", 0) != 0);
 
   // Setup python console keys used as shortcut.
   for (unsigned short i = 0; i < 4; ++i) {
@@ -150,12 +174,20 @@ void LA_Launcher::InitEngine()
   }
   m_pythonConsole.use = (gm.flag & GAME_PYTHON_CONSOLE);
 
+  /* The benchmark advances the clock of one logic step per frame, each frame then proceeds
+   * exactly one logic and physics step independently of the real time. */
+  if (benchmark) {
+    fixed_framerate = false;
+  }
+
   const KX_KetsjiEngine::FlagType flags =
       (KX_KetsjiEngine::FlagType)((fixed_framerate ? KX_KetsjiEngine::FIXED_FRAMERATE : 0) |
+                                  (benchmark ? KX_KetsjiEngine::USE_EXTERNAL_CLOCK : 0) |
                                   (frameRate ? KX_KetsjiEngine::SHOW_FRAMERATE : 0) |
                                   (restrictAnimFPS ? KX_KetsjiEngine::RESTRICT_ANIMATION : 0) |
                                   (properties ? KX_KetsjiEngine::SHOW_DEBUG_PROPERTIES : 0) |
-                                  (profile ? KX_KetsjiEngine::SHOW_PROFILE : 0));
+                                  (profile ? KX_KetsjiEngine::SHOW_PROFILE : 0) |
+                                  (frameArenaStats ? KX_KetsjiEngine::FRAME_ARENA_STATS : 0));
 
   m_rasterizer = new RAS_Rasterizer();
 
@@ -223,7 +255,11 @@ void LA_Launcher::InitEngine()
 #endif
 
   m_ketsjiEngine->SetFlag(flags, true);
-  m_ketsjiEngine->SetRender(true);
+  m_ketsjiEngine->SetRender(!benchmark);
+  if (benchmark) {
+    // Seed the random actuators without seed, they are converted with the scenes.
+    m_ketsjiEngine->SetRandomSeed(benchmarkSeed);
+  }
 
   m_ketsjiEngine->SetTicRate(gm.ticrate);
   m_ketsjiEngine->SetMaxLogicFrame(gm.maxlogicstep);
@@ -246,9 +282,27 @@ void LA_Launcher::InitEngine()
                   m_argv,
                   m_context,
                   &m_audioDeviceIsInitialized);
+
+  if (benchmark) {
+    PyObject *random = PyImport_ImportModule("random");
+    PyObject *ret = random ? PyObject_CallMethod(random, "seed", "i", benchmarkSeed) : nullptr;
+    if (!ret) {
+      PyErr_Print();
+    }
+    Py_XDECREF(ret);
+    Py_XDECREF(random);
+  }
 #endif  // WITH_PYTHON
 
   // Create a scene converter, create and convert the stratingscene.
+  BL_MeshCache::SetEnabled(meshCache);
+#ifdef WITH_BULLET
+  CcdBvhCache::SetEnabled(bvhCache);
+  CcdShapeCache::SetHullMaxVertices(max_ii(hullMaxVertices, 0));
+#else
+  (void)bvhCache;
+  (void)hullMaxVertices;
+#endif
   m_converter = new BL_Converter(m_maggie, m_ketsjiEngine);
   m_ketsjiEngine->SetConverter(m_converter);
 
@@ -264,6 +318,12 @@ void LA_Launcher::InitEngine()
     AUD_Device_setSpeedOfSound(device, m_startScene->audio.speed_of_sound);
     AUD_Device_setDopplerFactor(device, m_startScene->audio.doppler_factor);
     AUD_Device_setDistanceModel(device, AUD_DistanceModel(m_startScene->audio.distance_model));
+    /* Batch the parameters of the sounds set by the actuators and the scripts, they are
+     * committed once per frame so that they don't race with the mixing thread and all the
+     * parameters of a frame reach the same mix. */
+    AUD_Device_setParameterBatching(device, true);
+    AUD_Device_setVoiceBudget(device, audioMaxVoices, audioVirtualVolume);
+    AUD_Device_setRenderThreads(device, audioRenderThreads);
   }
 #endif  // WITH_AUDASPACE
 
@@ -273,6 +333,29 @@ void LA_Launcher::InitEngine()
   m_ketsjiEngine->AddScene(m_kxStartScene);
   m_kxStartScene->Release();
 
+  if (warmMeshCache) {
+    // Convert all the other scenes only to fill the mesh cache and quit.
+    for (Scene *scene = (Scene *)m_maggie->scenes.first; scene; scene = (Scene *)scene->id.next) {
+      if (scene != m_startScene) {
+        KX_Scene *kxscene = m_ketsjiEngine->CreateScene(scene, false);
+        m_converter->RemoveScene(kxscene);
+      }
+    }
+    BL_MeshCache::PrintStats();
+#ifdef WITH_BULLET
+    CcdBvhCache::PrintStats();
+#endif
+    m_ketsjiEngine->RequestExit(KX_ExitRequest::QUIT_GAME);
+  }
+
+  if (benchmark) {
+    m_benchmark = new LA_Benchmark(benchmarkFile, benchmarkFrames, benchmarkSeed);
+  }
+
+  if (traceFile && traceFile[0] != '\0') {
+    CM_Trace::Start(traceFile);
+  }
+
   m_ketsjiEngine->StartEngine();
 
   /* Set the animation playback rate for ipo's and actions the
@@ -292,6 +375,15 @@ void LA_Launcher::ExitEngine()
   DEV_Joystick::Close();
   m_ketsjiEngine->StopEngine();
 
+  // Write the capture started by the command line or not stopped by python.
+  CM_Trace::Stop();
+
+  if (m_benchmark) {
+    m_benchmark->WriteFile(m_maggie->filepath, m_ketsjiEngine->GetTicRate());
+    delete m_benchmark;
+    m_benchmark = nullptr;
+  }
+
 #ifdef WITH_PYTHON
 
   /* Clears the dictionary by hand:
@@ -360,8 +452,13 @@ void LA_Launcher::ExitEngine()
 
 #ifdef WITH_AUDASPACE
   if (m_audioDeviceIsInitialized) {
+    AUD_Device *device = BKE_sound_get_device();
+    AUD_Device_setParameterBatching(device, false);
+    // Restore the mixing of all the voices.
+    AUD_Device_setVoiceBudget(device, 0, -1.0f);
+    AUD_Device_setRenderThreads(device, 1);
     // Stop all remaining playing sounds.
-    AUD_Device_stopAll(BKE_sound_get_device());
+    AUD_Device_stopAll(device);
   }
 #endif  // WITH_AUDASPACE
 
@@ -468,9 +565,20 @@ bool LA_Launcher::EngineNextFrame()
   // Check if we can create a python console debugging.
   HandlePythonConsole();
 #endif
+  if (m_benchmark) {
+    m_ketsjiEngine->SetClockTime(m_benchmark->GetClockTime(m_ketsjiEngine->GetTicRate()));
+  }
+
   // Kick the engine.
   bool renderFrame = m_ketsjiEngine->NextFrame();
 
+#ifdef WITH_AUDASPACE
+  if (m_audioDeviceIsInitialized) {
+    // Apply the sound parameters of the frame all together.
+    AUD_Device_commitParameters(BKE_sound_get_device());
+  }
+#endif  // WITH_AUDASPACE
+
   // First check if we want to exit.
   m_exitRequested = m_ketsjiEngine->GetExitCode();
   m_exitString = m_ketsjiEngine->GetExitString();
@@ -479,6 +587,14 @@ bool LA_Launcher::EngineNextFrame()
     if (renderFrame) {
       RenderEngine();
     }
+    else if (m_benchmark) {
+      m_ketsjiEngine->EndFrameWithoutRender();
+      m_benchmark->AddFrame(m_ketsjiEngine);
+      if (m_benchmark->IsFinished()) {
+        m_exitRequested = KX_ExitRequest::QUIT_GAME;
+        m_exitString = "benchmark finished";
+      }
+    }
   }
 
   m_system->processEvents(false);
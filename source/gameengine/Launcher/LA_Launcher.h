@@ -35,6 +35,7 @@
 
 class KX_Scene;
 class KX_ISystem;
+class LA_Benchmark;
 class BL_Converter;
 class KX_NetworkMessageManager;
 class RAS_ICanvas;
@@ -78,6 +79,8 @@ class LA_Launcher {
   BL_Converter *m_converter;
   /// Manage messages.
   KX_NetworkMessageManager *m_networkMessageManager;
+  /// Measure of the frames in benchmark mode, nullptr otherwise.
+  LA_Benchmark *m_benchmark;
 
 #ifdef WITH_PYTHON
   PyObject *m_globalDict;
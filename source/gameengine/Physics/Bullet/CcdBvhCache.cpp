@@ -0,0 +1,334 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Physics/Bullet/CcdBvhCache.cpp
+ *  \ingroup physbullet
+ */
+
+#include "CcdBvhCache.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+#ifndef WIN32
+#  include <sys/mman.h>
+#  include <unistd.h>
+#else
+#  include <io.h>
+#  include <windows.h>
+#endif
+
+#include <xxhash.h>
+
+#include "BKE_appdir.hh"
+#include "BLI_fileops.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
+
+#include "CM_Message.h"
+
+/// Increase when the file layout changes to invalidate old entries.
+static const unsigned int BVH_CACHE_VERSION = 1;
+static const char BVH_CACHE_MAGIC[8] = {'B', 'G', 'E', 'B', 'V', 'H', '\0', '\0'};
+
+struct BvhCacheHeader {
+  char magic[8];
+  uint64_t key;
+  uint32_t version;
+  /// Size of btScalar and Bullet version, the serialized layout depends on both.
+  uint32_t scalarSize;
+  uint32_t bulletVersion;
+  uint32_t dataSize;
+};
+
+/// Offset of the serialized BVH in the file, the BVH requires an aligned buffer.
+static const size_t BVH_CACHE_DATA_OFFSET = 64;
+static_assert(sizeof(BvhCacheHeader) <= BVH_CACHE_DATA_OFFSET, "BVH cache header too large");
+
+bool CcdBvhCache::m_enabled = false;
+std::string CcdBvhCache::m_directory;
+std::atomic<unsigned int> CcdBvhCache::m_hits(0);
+std::atomic<unsigned int> CcdBvhCache::m_misses(0);
+std::atomic<unsigned int> CcdBvhCache::m_stores(0);
+
+CcdBvhCache::Entry::Entry()
+    : m_memory(nullptr),
+      m_length(0),
+#ifdef WIN32
+      m_handle(nullptr),
+#endif
+      m_bvh(nullptr)
+{
+}
+
+CcdBvhCache::Entry::~Entry()
+{
+  if (m_bvh) {
+    // The BVH arrays don't own the mapped memory.
+    m_bvh->~btOptimizedBvh();
+  }
+
+  if (m_memory) {
+#ifndef WIN32
+    munmap(m_memory, m_length);
+#else
+    UnmapViewOfFile(m_memory);
+    CloseHandle(m_handle);
+#endif
+  }
+}
+
+bool CcdBvhCache::Entry::Open(const std::string &path)
+{
+  const int file = BLI_open(path.c_str(), O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    return false;
+  }
+
+  /* The deserialization constructs the BVH in the buffer, the file is mapped copy on write
+   * so only the modified pages are duplicated. */
+#ifndef WIN32
+  struct stat st;
+  if (fstat(file, &st) == 0 && st.st_size > 0) {
+    void *memory = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    if (memory != MAP_FAILED) {
+      m_memory = memory;
+      m_length = st.st_size;
+    }
+  }
+#else
+  HANDLE fileHandle = (HANDLE)_get_osfhandle(file);
+  LARGE_INTEGER size;
+  if (fileHandle != INVALID_HANDLE_VALUE && GetFileSizeEx(fileHandle, &size) &&
+      size.QuadPart > 0)
+  {
+    m_handle = CreateFileMapping(fileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (m_handle) {
+      m_memory = MapViewOfFile(m_handle, FILE_MAP_COPY, 0, 0, 0);
+      if (m_memory) {
+        m_length = size.QuadPart;
+      }
+      else {
+        CloseHandle(m_handle);
+        m_handle = nullptr;
+      }
+    }
+  }
+#endif
+
+  close(file);
+
+  return (m_memory != nullptr);
+}
+
+btOptimizedBvh *CcdBvhCache::Entry::GetBvh() const
+{
+  return m_bvh;
+}
+
+void CcdBvhCache::Entry::SetBvh(btOptimizedBvh *bvh)
+{
+  m_bvh = bvh;
+}
+
+const char *CcdBvhCache::Entry::GetData() const
+{
+  return (const char *)m_memory;
+}
+
+size_t CcdBvhCache::Entry::GetLength() const
+{
+  return m_length;
+}
+
+bool CcdBvhCache::IsEnabled()
+{
+  return m_enabled;
+}
+
+void CcdBvhCache::SetEnabled(bool enabled)
+{
+  m_enabled = enabled;
+  // Resolve the directory before any parallel BVH build.
+  if (m_enabled) {
+    GetDirectory();
+  }
+}
+
+const std::string &CcdBvhCache::GetDirectory()
+{
+  if (m_directory.empty()) {
+    char path[FILE_MAX];
+    if (!BKE_appdir_folder_caches(path, sizeof(path))) {
+      BLI_strncpy(path, BKE_tempdir_base(), sizeof(path));
+    }
+    BLI_path_append(path, sizeof(path), "bge_bvh");
+    m_directory = path;
+  }
+  return m_directory;
+}
+
+void CcdBvhCache::SetDirectory(const std::string &directory)
+{
+  m_directory = directory;
+}
+
+std::string CcdBvhCache::GetFilePath(Key key)
+{
+  std::stringstream name;
+  name << std::hex << key << ".bgebvh";
+
+  char path[FILE_MAX];
+  BLI_path_join(path, sizeof(path), GetDirectory().c_str(), name.str().c_str());
+  return path;
+}
+
+CcdBvhCache::Key CcdBvhCache::ComputeKey(const btAlignedObjectArray<btScalar> &vertices,
+                                         const std::vector<int> &triangles,
+                                         unsigned int numTriangles)
+{
+  XXH3_state_t *state = XXH3_createState();
+  XXH3_64bits_reset(state);
+
+  const uint32_t sizes[] = {uint32_t(vertices.size()), uint32_t(triangles.size()), numTriangles};
+  XXH3_64bits_update(state, &BVH_CACHE_VERSION, sizeof(BVH_CACHE_VERSION));
+  XXH3_64bits_update(state, sizes, sizeof(sizes));
+  XXH3_64bits_update(state, &vertices[0], vertices.size() * sizeof(btScalar));
+  XXH3_64bits_update(state, triangles.data(), triangles.size() * sizeof(int));
+
+  const Key key = XXH3_64bits_digest(state);
+  XXH3_freeState(state);
+
+  return key;
+}
+
+CcdBvhCache::Entry *CcdBvhCache::Load(Key key)
+{
+  const std::string path = GetFilePath(key);
+
+  Entry *entry = new Entry();
+  if (!entry->Open(path)) {
+    delete entry;
+    ++m_misses;
+    return nullptr;
+  }
+
+  const BvhCacheHeader *header = (const BvhCacheHeader *)entry->GetData();
+  const bool valid = (entry->GetLength() >= BVH_CACHE_DATA_OFFSET &&
+                      memcmp(header->magic, BVH_CACHE_MAGIC, sizeof(BVH_CACHE_MAGIC)) == 0 &&
+                      header->key == key && header->version == BVH_CACHE_VERSION &&
+                      header->scalarSize == sizeof(btScalar) &&
+                      header->bulletVersion == BT_BULLET_VERSION &&
+                      header->dataSize == entry->GetLength() - BVH_CACHE_DATA_OFFSET);
+
+  btOptimizedBvh *bvh = nullptr;
+  if (valid) {
+    // The deserialization checks the buffer size against the serialized node counts.
+    bvh = btOptimizedBvh::deSerializeInPlace(
+        (void *)(entry->GetData() + BVH_CACHE_DATA_OFFSET), header->dataSize, false);
+  }
+
+  if (!bvh) {
+    CM_Warning("outdated or invalid collision BVH cache file \"" << path << "\"");
+    delete entry;
+    ++m_misses;
+    return nullptr;
+  }
+
+  entry->SetBvh(bvh);
+
+  ++m_hits;
+  return entry;
+}
+
+void CcdBvhCache::Store(Key key, btOptimizedBvh *bvh)
+{
+  const std::string &directory = GetDirectory();
+  if (!BLI_exists(directory.c_str()) && !BLI_dir_create_recursive(directory.c_str())) {
+    CM_Error("can't create collision BVH cache directory \"" << directory << "\"");
+    return;
+  }
+
+  const unsigned int dataSize = bvh->calculateSerializeBufferSize();
+  std::vector<char> buffer(BVH_CACHE_DATA_OFFSET + dataSize + 16);
+  // Align the serialized data in the buffer like in the mapped file.
+  char *data = (char *)(((uintptr_t)buffer.data() + 15) & ~uintptr_t(15));
+
+  BvhCacheHeader *header = (BvhCacheHeader *)data;
+  memset(data, 0, BVH_CACHE_DATA_OFFSET);
+  memcpy(header->magic, BVH_CACHE_MAGIC, sizeof(BVH_CACHE_MAGIC));
+  header->key = key;
+  header->version = BVH_CACHE_VERSION;
+  header->scalarSize = sizeof(btScalar);
+  header->bulletVersion = BT_BULLET_VERSION;
+  header->dataSize = dataSize;
+
+  if (!bvh->serializeInPlace(data + BVH_CACHE_DATA_OFFSET, dataSize, false)) {
+    CM_Error("can't serialize collision BVH for cache");
+    return;
+  }
+
+  const std::string path = GetFilePath(key);
+  // Write in a temporary file renamed at the end to never expose a partial file.
+  std::stringstream tmpPath;
+  tmpPath << path << "." << std::this_thread::get_id() << ".tmp";
+
+  std::ofstream file(tmpPath.str(), std::ios::binary | std::ios::trunc);
+  if (!file) {
+    CM_Error("can't write collision BVH cache file \"" << tmpPath.str() << "\"");
+    return;
+  }
+
+  file.write(data, BVH_CACHE_DATA_OFFSET + dataSize);
+  file.close();
+  if (!file || BLI_rename_overwrite(tmpPath.str().c_str(), path.c_str()) != 0) {
+    CM_Error("can't write collision BVH cache file \"" << path << "\"");
+    BLI_delete(tmpPath.str().c_str(), false, false);
+    return;
+  }
+
+  ++m_stores;
+}
+
+unsigned int CcdBvhCache::GetHits()
+{
+  return m_hits;
+}
+
+unsigned int CcdBvhCache::GetMisses()
+{
+  return m_misses;
+}
+
+void CcdBvhCache::PrintStats()
+{
+  CM_Message(std::endl << "Collision BVH cache:");
+  CM_Message("\t directory: " << GetDirectory());
+  CM_Message("\t hits: " << m_hits);
+  CM_Message("\t misses: " << m_misses);
+  CM_Message("\t stored: " << m_stores);
+}
@@ -0,0 +1,105 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CcdBvhCache.h
+ *  \ingroup physbullet
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btScalar.h"
+
+class btOptimizedBvh;
+
+/** On-disk cache of the triangle mesh collision BVHs.
+ *
+ * A BVH is stored under a hash of the vertices and triangles of the mesh interface it was
+ * built from, using the Bullet in-place serialization. The cache file is memory-mapped copy
+ * on write and the BVH is used directly from the mapped memory instead of being rebuilt.
+ */
+class CcdBvhCache {
+ public:
+  typedef uint64_t Key;
+
+  /// A BVH loaded from the cache, valid as long as the entry exists.
+  class Entry {
+   private:
+    void *m_memory;
+    size_t m_length;
+#ifdef WIN32
+    void *m_handle;
+#endif
+    btOptimizedBvh *m_bvh;
+
+   public:
+    Entry();
+    ~Entry();
+
+    bool Open(const std::string &path);
+    btOptimizedBvh *GetBvh() const;
+    void SetBvh(btOptimizedBvh *bvh);
+    const char *GetData() const;
+    size_t GetLength() const;
+  };
+
+ private:
+  static bool m_enabled;
+  static std::string m_directory;
+
+  static std::atomic<unsigned int> m_hits;
+  static std::atomic<unsigned int> m_misses;
+  static std::atomic<unsigned int> m_stores;
+
+  static std::string GetFilePath(Key key);
+
+ public:
+  static bool IsEnabled();
+  static void SetEnabled(bool enabled);
+
+  /// Return the cache directory, by default in the user cache folder.
+  static const std::string &GetDirectory();
+  static void SetDirectory(const std::string &directory);
+
+  /// Compute the cache key of the triangles of a mesh interface.
+  static Key ComputeKey(const btAlignedObjectArray<btScalar> &vertices,
+                        const std::vector<int> &triangles,
+                        unsigned int numTriangles);
+
+  /** Load a BVH from the cache.
+   * \return The cache entry owning the BVH or nullptr if the cache doesn't contain a valid
+   * entry for this key.
+   */
+  static Entry *Load(Key key);
+  /// Write a BVH to the cache.
+  static void Store(Key key, btOptimizedBvh *bvh);
+
+  static unsigned int GetHits();
+  static unsigned int GetMisses();
+
+  static void PrintStats();
+};
@@ -28,6 +28,7 @@
 #include "BKE_context.hh"
 #include "BKE_mesh.hh"
 #include "BKE_mesh_legacy_convert.hh"
+#include "BLI_task.hh"
 #include "DEG_depsgraph_query.hh"
 #include "DNA_meshdata_types.h"
 
@@ -38,6 +39,7 @@
 #include "LinearMath/btConvexHull.h"
 
 #include "CcdPhysicsEnvironment.h"
+#include "CcdShapeCache.h"
 #include "KX_GameObject.h"
 #include "RAS_DisplayArray.h"
 #include "RAS_MeshObject.h"
@@ -191,6 +193,7 @@ CcdPhysicsController::CcdPhysicsController(const CcdConstructionInfo &ci) : m_cc
 {
   m_prototypeTransformInitialized = false;
   m_softbodyMappingDone = false;
+  m_softBodyNumVertices = 0;
   m_newClientInfo = 0;
   m_registerCount = 0;
   m_softBodyTransformInitialized = false;
@@ -305,6 +308,7 @@ bool CcdPhysicsController::CreateSoftbody()
   // disable soft body until first sneak preview is ready
   if (!m_cci.m_bSoft || !m_cci.m_collisionShape ||
       ((shapeType != CONVEX_HULL_SHAPE_PROXYTYPE) &&
+       (shapeType != CONVEX_POINT_CLOUD_SHAPE_PROXYTYPE) &&
        (shapeType != TRIANGLE_MESH_SHAPE_PROXYTYPE) &&
        (shapeType != SCALED_TRIANGLE_MESH_SHAPE_PROXYTYPE))) {
     return false;
@@ -313,12 +317,22 @@ bool CcdPhysicsController::CreateSoftbody()
   btSoftBody *psb = nullptr;
   btSoftBodyWorldInfo &worldInfo = m_cci.m_physicsEnv->GetDynamicsWorld()->getWorldInfo();
 
-  if (m_cci.m_collisionShape->getShapeType() ==
-      CONVEX_HULL_SHAPE_PROXYTYPE) {  // Disabled in upbge 0.3
-    btConvexHullShape *convexHull = (btConvexHullShape *)m_cci.m_collisionShape;
+  if (ELEM(m_cci.m_collisionShape->getShapeType(),
+           CONVEX_HULL_SHAPE_PROXYTYPE,
+           CONVEX_POINT_CLOUD_SHAPE_PROXYTYPE)) {  // Disabled in upbge 0.3
     {
-      int nvertices = convexHull->getNumPoints();
-      const btVector3 *vertices = convexHull->getPoints();
+      int nvertices;
+      const btVector3 *vertices;
+      if (m_cci.m_collisionShape->getShapeType() == CONVEX_HULL_SHAPE_PROXYTYPE) {
+        btConvexHullShape *convexHull = (btConvexHullShape *)m_cci.m_collisionShape;
+        nvertices = convexHull->getNumPoints();
+        vertices = convexHull->getPoints();
+      }
+      else {
+        btConvexPointCloudShape *pointCloud = (btConvexPointCloudShape *)m_cci.m_collisionShape;
+        nvertices = pointCloud->getNumPoints();
+        vertices = pointCloud->getUnscaledPoints();
+      }
 
       HullDesc hdsc(QF_TRIANGLES, nvertices, vertices);
       HullResult hres;
@@ -532,6 +546,13 @@ bool CcdPhysicsController::CreateSoftbody()
   }
   m_softbodyMappingDone = true;
 
+  if (m_softBodyVertexNodes.empty()) {
+    RAS_MeshObject *rasMesh = GetShapeInfo()->GetMesh();
+    if (rasMesh && rasMesh->GetOrigMesh()) {
+      CreateSoftBodyVertexNodes(rasMesh, rasMesh->GetOrigMesh(), psb->m_nodes.size());
+    }
+  }
+
   btTransform startTrans;
   m_bulletMotionState->getWorldTransform(startTrans);
 
@@ -654,6 +675,9 @@ void CcdPhysicsController::SetGravity(const MT_Vector3 &gravity)
 
 static void DeleteBulletShape(btCollisionShape *shape, bool free)
 {
+  // The shared hull points are freed by the cache with their last user.
+  CcdShapeCache::ReleaseShape(shape);
+
   if (shape->getShapeType() == SCALED_TRIANGLE_MESH_SHAPE_PROXYTYPE) {
     /* If we use Bullet scaled shape (btScaledBvhTriangleMeshShape) we have to
      * free the child of the unscaled shape (btTriangleMeshShape) here.
@@ -712,6 +736,7 @@ bool CcdPhysicsController::ReplaceControllerShape(btCollisionShape *newShape)
     m_object = nullptr;
     // force complete reinitialization
     m_softbodyMappingDone = false;
+    m_softBodyVertexNodes.clear();
     m_prototypeTransformInitialized = false;
     m_softBodyTransformInitialized = false;
 
@@ -837,77 +862,87 @@ bool CcdPhysicsController::SynchronizeMotionStates(float time)
   return true;
 }
 
-void CcdPhysicsController::UpdateSoftBody()
+void CcdPhysicsController::CreateSoftBodyVertexNodes(RAS_MeshObject *rasMesh,
+                                                     Mesh *me,
+                                                     unsigned int numNodes)
 {
-  btSoftBody *sb = GetSoftBody();
-  if (sb) {
-    if (sb->m_pose.m_bframe || sb->m_pose.m_bvolume) {
+  m_softBodyVertexNodes.clear();
+  m_softBodyNumVertices = me->verts_num;
 
-      RAS_MeshObject *rasMesh = GetShapeInfo()->GetMesh();
+  BKE_mesh_tessface_ensure(me);
 
-      if (rasMesh) {
-        KX_GameObject *gameobj = KX_GameObject::GetClientObject(
-            (KX_ClientObjectInfo *)GetNewClientInfo());
-        Object *ob = gameobj->GetBlenderObject();
-        Mesh *me = (Mesh *)ob->data;
-        BKE_mesh_tessface_ensure(me);
+  const int *index_mf_to_mpoly = (const int *)CustomData_get_layer(&me->fdata_legacy,
+                                                                   CD_ORIGINDEX);
+  const int *index_mp_to_orig = (const int *)CustomData_get_layer(&me->face_data, CD_ORIGINDEX);
+  if (!index_mf_to_mpoly) {
+    index_mp_to_orig = nullptr;
+  }
 
-        const int *index_mf_to_mpoly = (const int *)CustomData_get_layer(&me->fdata_legacy, CD_ORIGINDEX);
-        const int *index_mp_to_orig = (const int *)CustomData_get_layer(&me->face_data, CD_ORIGINDEX);
-        if (!index_mf_to_mpoly) {
-          index_mp_to_orig = nullptr;
+  const MFace *faces = (MFace *)CustomData_get_layer(&me->fdata_legacy, CD_MFACE);
+  const int numpolys = me->totface_legacy;
+
+  // Node of each vertex, -1 for the vertices not used by a collision polygon.
+  std::vector<int> vertexNodes(me->verts_num, -1);
+
+  for (int p2 = 0; p2 < numpolys; p2++) {
+    const MFace *face = &faces[p2];
+    const int origi = index_mf_to_mpoly ?
+                          DM_origindex_mface_mpoly(index_mf_to_mpoly, index_mp_to_orig, p2) :
+                          p2;
+    RAS_Polygon *poly = (origi != ORIGINDEX_NONE) ? rasMesh->GetPolygon(origi) : nullptr;
+
+    // only use polygons that have the collisionflag set
+    if (poly) {
+      const unsigned int verts[4] = {face->v1, face->v2, face->v3, face->v4};
+      for (unsigned short k = 0, size = face->v4 ? 4 : 3; k < size; ++k) {
+        const unsigned int node = poly->GetVertexInfo(k).getSoftBodyIndex();
+        if (node < numNodes) {
+          vertexNodes[verts[k]] = node;
         }
+      }
+    }
+  }
 
-        float(*positions)[3] = reinterpret_cast<float(*)[3]>(
-            me->vert_positions_for_write().data());
-        const MFace *faces = (MFace *)CustomData_get_layer(&me->fdata_legacy, CD_MFACE);
-        int numpolys = me->totface_legacy;
-
-        btSoftBody::tNodeArray &nodes(sb->m_nodes);
-
-        for (int p2 = 0; p2 < numpolys; p2++) {
-          const MFace *face = &faces[p2];
-          const int origi = index_mf_to_mpoly ?
-                                DM_origindex_mface_mpoly(index_mf_to_mpoly, index_mp_to_orig, p2) :
-                                p2;
-          RAS_Polygon *poly = (origi != ORIGINDEX_NONE) ? rasMesh->GetPolygon(origi) : nullptr;
-
-          // only add polygons that have the collisionflag set
-          if (poly) {
-            float *v1 = &positions[face->v1][0];
-            float *v2 = &positions[face->v2][0];
-            float *v3 = &positions[face->v3][0];
-
-            int i1 = poly->GetVertexInfo(0).getSoftBodyIndex();
-            int i2 = poly->GetVertexInfo(1).getSoftBodyIndex();
-            int i3 = poly->GetVertexInfo(2).getSoftBodyIndex();
-
-            MT_Vector3 p1 = ToMoto(nodes.at(i1).m_x - sb->m_pose.m_com);
-            MT_Vector3 p2 = ToMoto(nodes.at(i2).m_x - sb->m_pose.m_com);
-            MT_Vector3 p3 = ToMoto(nodes.at(i3).m_x - sb->m_pose.m_com);
-
-            // Do we need object_to_world? maybe
-            copy_v3_v3(v1, p1.getValue());
-            copy_v3_v3(v2, p2.getValue());
-            copy_v3_v3(v3, p3.getValue());
-
-            if (face->v4) {
-              float *v4 = &positions[face->v4][0];
+  for (unsigned int i = 0, size = vertexNodes.size(); i < size; ++i) {
+    if (vertexNodes[i] != -1) {
+      m_softBodyVertexNodes.emplace_back(i, vertexNodes[i]);
+    }
+  }
+}
 
-              int i4 = poly->GetVertexInfo(3).getSoftBodyIndex();
+void CcdPhysicsController::UpdateSoftBody()
+{
+  btSoftBody *sb = GetSoftBody();
+  if (!sb || !(sb->m_pose.m_bframe || sb->m_pose.m_bvolume) || m_softBodyVertexNodes.empty()) {
+    return;
+  }
 
-              MT_Vector3 p4 = ToMoto(nodes.at(i4).m_x - sb->m_pose.m_com);
+  KX_GameObject *gameobj = KX_GameObject::GetClientObject(
+      (KX_ClientObjectInfo *)GetNewClientInfo());
+  Object *ob = gameobj->GetBlenderObject();
+  Mesh *me = (Mesh *)ob->data;
+  // The mesh was changed since the soft body creation.
+  if (me->verts_num != m_softBodyNumVertices) {
+    return;
+  }
 
-              copy_v3_v3(v4, p4.getValue());
+  blender::MutableSpan<blender::float3> positions = me->vert_positions_for_write();
+  const btSoftBody::tNodeArray &nodes = sb->m_nodes;
+  const btVector3 com = sb->m_pose.m_com;
 
-            }
-          }
-        }
-        me->tag_positions_changed();
-        DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
-      }
+  const blender::IndexRange vertices(m_softBodyVertexNodes.size());
+  blender::threading::parallel_for(vertices, 4096, [&](const blender::IndexRange range) {
+    for (const int64_t i : range) {
+      const std::pair<unsigned int, unsigned int> &vertexNode = m_softBodyVertexNodes[i];
+      // Do we need object_to_world? maybe
+      const btVector3 pos = nodes[vertexNode.second].m_x - com;
+      positions[vertexNode.first] = blender::float3(pos.x(), pos.y(), pos.z());
     }
-  }
+  });
+
+  me->tag_positions_changed();
+  // The evaluated mesh used by the render is a copy of the original mesh.
+  DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
 }
 
 void CcdPhysicsController::SetSoftBodyTransform(const MT_Vector3 &pos, const MT_Matrix3x3 &ori)
@@ -1778,7 +1813,7 @@ void CcdPhysicsController::RemoveCompoundChild(PHY_IPhysicsController *child)
         break;
       }
     }
-    delete childCtrl->m_bulletChildShape;
+    DeleteBulletShape(childCtrl->m_bulletChildShape, true);
     childCtrl->m_bulletChildShape = nullptr;
   }
   // recompute inertia of parent
@@ -2003,6 +2038,8 @@ void CcdShapeConstructionInfo::ProcessReplica()
   m_userData = nullptr;
   m_meshObject = nullptr;
   m_triangleIndexVertexArray = nullptr;
+  m_optimizedBvh = nullptr;
+  m_bvhCacheEntry = nullptr;
   m_forceReInstance = false;
   m_shapeProxy = nullptr;
   m_vertexArray.clear();
@@ -2039,7 +2076,8 @@ bool CcdShapeConstructionInfo::SetMesh(class KX_Scene *kxscene,
   Object *ob_eval = DEG_get_evaluated_object(depsgraph, meshobj->GetOriginalObject());
   Mesh *me = (Mesh *)ob_eval->data;
 
-  /* No need to call again ensure_tessface as it was called in BL_DataConversion */
+  /* The tessellation is skipped in BL_DataConversion for meshes restored from the mesh cache. */
+  BKE_mesh_tessface_ensure(me);
 
   const blender::Span<blender::float3> positions = me->vert_positions();
   const MFace *faces = (MFace *)CustomData_get_layer(&me->fdata_legacy, CD_MFACE);
@@ -2137,6 +2175,9 @@ bool CcdShapeConstructionInfo::SetMesh(class KX_Scene *kxscene,
         }
       }
     }
+
+    // Keep only the outer vertices of the hull when the reduction is enabled.
+    CcdShapeCache::ReduceConvexHull(m_vertexArray);
   }
   else {
     unsigned int tot_bt_tris = 0;
@@ -2705,8 +2746,8 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
       break;
 
     case PHY_SHAPE_POLYTOPE:
-      collisionShape = new btConvexHullShape(
-          &m_vertexArray[0], m_vertexArray.size() / 3, 3 * sizeof(btScalar));
+      // The hull points are shared by all the shapes using the same vertices.
+      collisionShape = CcdShapeCache::CreateConvexHull(m_vertexArray);
       collisionShape->setMargin(margin);
       break;
 
@@ -2727,6 +2768,7 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
         if (!m_triangleIndexVertexArray || m_forceReInstance) {
           if (m_triangleIndexVertexArray)
             delete m_triangleIndexVertexArray;
+          FreeOptimizedBvh();
 
           m_triangleIndexVertexArray = new btTriangleIndexVertexArray(m_polygonIndexArray.size(),
                                                                       m_triFaceArray.data(),
@@ -2743,41 +2785,20 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
         collisionShape = gimpactShape;
       }
       else {
-        if (!m_triangleIndexVertexArray || m_forceReInstance) {
-          /// enable welding, only for the objects that need it (such as soft bodies)
-          if (0.0f != m_weldingThreshold1) {
-            btTriangleMesh *collisionMeshData = new btTriangleMesh(true, false);
-            collisionMeshData->m_weldingThreshold = m_weldingThreshold1;
-            bool removeDuplicateVertices = true;
-            // m_vertexArray not in multiple of 3 anymore, use m_triFaceArray
-            for (unsigned int i = 0; i < m_triFaceArray.size(); i += 3) {
-              btScalar *bt = &m_vertexArray[3 * m_triFaceArray[i]];
-              btVector3 v1(bt[0], bt[1], bt[2]);
-              bt = &m_vertexArray[3 * m_triFaceArray[i + 1]];
-              btVector3 v2(bt[0], bt[1], bt[2]);
-              bt = &m_vertexArray[3 * m_triFaceArray[i + 2]];
-              btVector3 v3(bt[0], bt[1], bt[2]);
-              collisionMeshData->addTriangle(v1, v2, v3, removeDuplicateVertices);
-            }
-            m_triangleIndexVertexArray = collisionMeshData;
-          }
-          else {
-            if (m_triangleIndexVertexArray) {
-              delete m_triangleIndexVertexArray;
-            }
-            m_triangleIndexVertexArray = new btTriangleIndexVertexArray(m_polygonIndexArray.size(),
-                                                                        m_triFaceArray.data(),
-                                                                        3 * sizeof(int),
-                                                                        m_vertexArray.size() / 3,
-                                                                        &m_vertexArray[0],
-                                                                        3 * sizeof(btScalar));
-          }
+        UpdateMeshInterface();
 
-          m_forceReInstance = false;
+        btBvhTriangleMeshShape *unscaledShape;
+        if (useBvh) {
+          BuildOptimizedBvh();
+        }
+        // The BVH is built once and shared by all the shapes using this mesh.
+        if (useBvh && m_optimizedBvh) {
+          unscaledShape = new btBvhTriangleMeshShape(m_triangleIndexVertexArray, true, false);
+          unscaledShape->setOptimizedBvh(m_optimizedBvh);
+        }
+        else {
+          unscaledShape = new btBvhTriangleMeshShape(m_triangleIndexVertexArray, true, useBvh);
         }
-
-        btBvhTriangleMeshShape *unscaledShape = new btBvhTriangleMeshShape(
-            m_triangleIndexVertexArray, true, useBvh);
         unscaledShape->setMargin(margin);
         collisionShape = new btScaledBvhTriangleMeshShape(unscaledShape,
                                                           btVector3(1.0f, 1.0f, 1.0f));
@@ -2810,6 +2831,99 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
   return collisionShape;
 }
 
+void CcdShapeConstructionInfo::UpdateMeshInterface()
+{
+  if (m_triangleIndexVertexArray && !m_forceReInstance) {
+    return;
+  }
+
+  // The BVH references the previous mesh interface.
+  FreeOptimizedBvh();
+
+  /// enable welding, only for the objects that need it (such as soft bodies)
+  if (0.0f != m_weldingThreshold1) {
+    btTriangleMesh *collisionMeshData = new btTriangleMesh(true, false);
+    collisionMeshData->m_weldingThreshold = m_weldingThreshold1;
+    bool removeDuplicateVertices = true;
+    // m_vertexArray not in multiple of 3 anymore, use m_triFaceArray
+    for (unsigned int i = 0; i < m_triFaceArray.size(); i += 3) {
+      btScalar *bt = &m_vertexArray[3 * m_triFaceArray[i]];
+      btVector3 v1(bt[0], bt[1], bt[2]);
+      bt = &m_vertexArray[3 * m_triFaceArray[i + 1]];
+      btVector3 v2(bt[0], bt[1], bt[2]);
+      bt = &m_vertexArray[3 * m_triFaceArray[i + 2]];
+      btVector3 v3(bt[0], bt[1], bt[2]);
+      collisionMeshData->addTriangle(v1, v2, v3, removeDuplicateVertices);
+    }
+    m_triangleIndexVertexArray = collisionMeshData;
+  }
+  else {
+    if (m_triangleIndexVertexArray) {
+      delete m_triangleIndexVertexArray;
+    }
+    m_triangleIndexVertexArray = new btTriangleIndexVertexArray(m_polygonIndexArray.size(),
+                                                                m_triFaceArray.data(),
+                                                                3 * sizeof(int),
+                                                                m_vertexArray.size() / 3,
+                                                                &m_vertexArray[0],
+                                                                3 * sizeof(btScalar));
+  }
+
+  m_forceReInstance = false;
+}
+
+void CcdShapeConstructionInfo::BuildOptimizedBvh()
+{
+  if (m_shapeType != PHY_SHAPE_MESH || m_triFaceArray.empty()) {
+    return;
+  }
+
+  UpdateMeshInterface();
+
+  if (m_optimizedBvh) {
+    return;
+  }
+
+  // The welded mesh interface doesn't use the vertex and triangle arrays.
+  const bool useCache = CcdBvhCache::IsEnabled() && m_weldingThreshold1 == 0.0f;
+  CcdBvhCache::Key key = 0;
+  if (useCache) {
+    key = CcdBvhCache::ComputeKey(m_vertexArray, m_triFaceArray, m_polygonIndexArray.size());
+    m_bvhCacheEntry = CcdBvhCache::Load(key);
+    if (m_bvhCacheEntry) {
+      m_optimizedBvh = m_bvhCacheEntry->GetBvh();
+      return;
+    }
+  }
+
+  btVector3 aabbMin;
+  btVector3 aabbMax;
+  m_triangleIndexVertexArray->calculateAabbBruteForce(aabbMin, aabbMax);
+
+  void *mem = btAlignedAlloc(sizeof(btOptimizedBvh), 16);
+  m_optimizedBvh = new (mem) btOptimizedBvh();
+  m_optimizedBvh->build(m_triangleIndexVertexArray, true, aabbMin, aabbMax);
+
+  if (useCache) {
+    CcdBvhCache::Store(key, m_optimizedBvh);
+  }
+}
+
+void CcdShapeConstructionInfo::FreeOptimizedBvh()
+{
+  if (m_bvhCacheEntry) {
+    // The BVH lives in the mapped cache file.
+    delete m_bvhCacheEntry;
+    m_bvhCacheEntry = nullptr;
+    m_optimizedBvh = nullptr;
+  }
+  else if (m_optimizedBvh) {
+    m_optimizedBvh->~btOptimizedBvh();
+    btAlignedFree(m_optimizedBvh);
+    m_optimizedBvh = nullptr;
+  }
+}
+
 void CcdShapeConstructionInfo::AddShape(CcdShapeConstructionInfo *shapeInfo)
 {
   m_shapeArray.push_back(shapeInfo);
@@ -2823,6 +2937,7 @@ CcdShapeConstructionInfo::~CcdShapeConstructionInfo()
   }
   m_shapeArray.clear();
 
+  FreeOptimizedBvh();
   if (m_triangleIndexVertexArray)
     delete m_triangleIndexVertexArray;
   m_vertexArray.clear();
@@ -32,6 +32,7 @@
 #include "btBulletDynamicsCommon.h"
 
 #include "CM_RefCount.h"
+#include "CcdBvhCache.h"
 #include "CcdMathUtils.h"
 #include "PHY_ICharacter.h"
 #include "PHY_IMotionState.h"
@@ -46,6 +47,7 @@ class CcdPhysicsController;
 class btMotionState;
 class RAS_MeshObject;
 struct DerivedMesh;
+struct Mesh;
 class btCollisionShape;
 
 #define CCD_BSB_SHAPE_MATCHING 2
@@ -79,6 +81,8 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
         m_userData(nullptr),
         m_meshObject(nullptr),
         m_triangleIndexVertexArray(nullptr),
+        m_optimizedBvh(nullptr),
+        m_bvhCacheEntry(nullptr),
         m_forceReInstance(false),
         m_weldingThreshold1(0.0f),
         m_shapeProxy(nullptr)
@@ -160,6 +164,12 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
                                       bool useGimpact = false,
                                       bool useBvh = true);
 
+  /** Build the BVH of a triangle mesh shape, shared by all the Bullet shapes created after.
+   * The BVH is loaded from the collision BVH cache when enabled.
+   * It doesn't use any global state and can be called from a worker thread.
+   */
+  void BuildOptimizedBvh();
+
   // member variables
   PHY_ShapeType m_shapeType;
   btScalar m_radius;
@@ -194,6 +204,10 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
   RAS_MeshObject *m_meshObject;
   /// The list of vertexes and indexes for the triangle mesh, shared between Bullet shape.
   btTriangleIndexVertexArray *m_triangleIndexVertexArray;
+  /// The BVH of m_triangleIndexVertexArray, shared between the non-gimpact Bullet shapes.
+  btOptimizedBvh *m_optimizedBvh;
+  /// The cache file m_optimizedBvh is mapped from, nullptr if the BVH was built.
+  CcdBvhCache::Entry *m_bvhCacheEntry;
   /// for compound shapes
   std::vector<CcdShapeConstructionInfo *> m_shapeArray;
   /// use gimpact for concave dynamic/moving collision detection
@@ -202,6 +216,10 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
   float m_weldingThreshold1;
   /// only used for PHY_SHAPE_PROXY, pointer to actual shape info
   CcdShapeConstructionInfo *m_shapeProxy;
+
+  /// Create or recreate the mesh interface of a triangle mesh shape when needed.
+  void UpdateMeshInterface();
+  void FreeOptimizedBvh();
 };
 
 struct CcdConstructionInfo {
@@ -575,6 +593,11 @@ class CcdPhysicsController : public PHY_IPhysicsController {
 
   // some book keeping for replication
   bool m_softbodyMappingDone;
+  /** Soft body node of each Blender mesh vertex written by UpdateSoftBody, as pairs of
+   * vertex and node indices sorted by vertex. */
+  std::vector<std::pair<unsigned int, unsigned int>> m_softBodyVertexNodes;
+  /// Number of vertices of the mesh used to build m_softBodyVertexNodes.
+  int m_softBodyNumVertices;
   bool m_softBodyTransformInitialized;
   bool m_prototypeTransformInitialized;
   btTransform m_softbodyStartTrans;
@@ -597,6 +620,8 @@ class CcdPhysicsController : public PHY_IPhysicsController {
 
   void CreateRigidbody();
   bool CreateSoftbody();
+  /// Build the table of the soft body node of each mesh vertex from the mesh polygons.
+  void CreateSoftBodyVertexNodes(RAS_MeshObject *rasMesh, Mesh *me, unsigned int numNodes);
   bool CreateCharacterController();
 
   bool Register()
@@ -21,8 +21,11 @@
 
 #include "CcdPhysicsEnvironment.h"
 
+#include <algorithm>
+
 #include "BKE_object.hh"
 #include "BLI_bounds_types.hh"
+#include "BLI_task.h"
 #include "DNA_object_force_types.h"
 #include "DNA_scene_types.h"
 
@@ -34,7 +37,9 @@
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
 
 #include "BL_SceneConverter.h"
+#include "CM_FrameArena.h"
 #include "CM_List.h"
+#include "CM_Profiler.h"
 #include "CcdConstraint.h"
 #include "CcdGraphicController.h"
 #include "KX_ClientObjectInfo.h"
@@ -410,6 +415,8 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
       dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
   m_dynamicsWorld->setInternalTickCallback(&CcdPhysicsEnvironment::StaticSimulationSubtickCallback,
                                            this);
+  m_dynamicsWorld->setInternalTickCallback(
+      &CcdPhysicsEnvironment::StaticSimulationPreSubtickCallback, this, true);
   // m_dynamicsWorld->getSolverInfo().m_linearSlop = 0.01f;
   // m_dynamicsWorld->getSolverInfo().m_solverMode=	SOLVER_USE_WARMSTARTING +
   // SOLVER_USE_2_FRICTION_DIRECTIONS +	SOLVER_RANDMIZE_ORDER +	SOLVER_USE_FRICTION_WARMSTARTING;
@@ -719,6 +726,19 @@ void CcdPhysicsEnvironment::SimulationSubtickCallback(btScalar timeStep)
   for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
     (*it)->SimulationTick(timeStep);
   }
+
+  // End the zone started in the pre-tick callback.
+  if (CM_Profiler::IsMeasuring()) {
+    CM_Profiler::EndZone();
+  }
+}
+
+void CcdPhysicsEnvironment::StaticSimulationPreSubtickCallback(btDynamicsWorld * /*world*/,
+                                                               btScalar /*timeStep*/)
+{
+  if (CM_Profiler::IsMeasuring()) {
+    CM_Profiler::BeginZone("Substep");
+  }
 }
 
 bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, float interval)
@@ -1066,6 +1086,21 @@ void CcdPhysicsEnvironment::RemoveConstraintById(int constraintId, bool free)
   }
 }
 
+static bool RayNeedsCollision(PHY_IRayCastFilterCallback &phyRayFilter,
+                              const btCollisionWorld::RayResultCallback &rayCallback,
+                              btBroadphaseProxy *proxy0)
+{
+  if (!(proxy0->m_collisionFilterGroup & rayCallback.m_collisionFilterMask))
+    return false;
+  if (!(rayCallback.m_collisionFilterGroup & proxy0->m_collisionFilterMask))
+    return false;
+  btCollisionObject *object = (btCollisionObject *)proxy0->m_clientObject;
+  CcdPhysicsController *phyCtrl = static_cast<CcdPhysicsController *>(object->getUserPointer());
+  if (phyCtrl == phyRayFilter.m_ignoreController)
+    return false;
+  return phyRayFilter.needBroadphaseRayCast(phyCtrl);
+}
+
 struct FilterClosestRayResultCallback : public btCollisionWorld::ClosestRayResultCallback {
   PHY_IRayCastFilterCallback &m_phyRayFilter;
   const btCollisionShape *m_hitTriangleShape;
@@ -1087,15 +1122,7 @@ struct FilterClosestRayResultCallback : public btCollisionWorld::ClosestRayResul
 
   virtual bool needsCollision(btBroadphaseProxy *proxy0) const
   {
-    if (!(proxy0->m_collisionFilterGroup & m_collisionFilterMask))
-      return false;
-    if (!(m_collisionFilterGroup & proxy0->m_collisionFilterMask))
-      return false;
-    btCollisionObject *object = (btCollisionObject *)proxy0->m_clientObject;
-    CcdPhysicsController *phyCtrl = static_cast<CcdPhysicsController *>(object->getUserPointer());
-    if (phyCtrl == m_phyRayFilter.m_ignoreController)
-      return false;
-    return m_phyRayFilter.needBroadphaseRayCast(phyCtrl);
+    return RayNeedsCollision(m_phyRayFilter, *this, proxy0);
   }
 
   virtual btScalar addSingleResult(btCollisionWorld::LocalRayResult &rayResult,
@@ -1116,6 +1143,74 @@ struct FilterClosestRayResultCallback : public btCollisionWorld::ClosestRayResul
   }
 };
 
+/// Keep the closest hit of every object along the ray.
+struct FilterAllHitsRayResultCallback : public btCollisionWorld::RayResultCallback {
+  struct Hit {
+    const btCollisionObject *m_object;
+    btScalar m_fraction;
+    btVector3 m_hitNormalWorld;
+    const btCollisionShape *m_hitTriangleShape;
+    int m_hitTriangleIndex;
+  };
+
+  PHY_IRayCastFilterCallback &m_phyRayFilter;
+  std::vector<Hit> m_hits;
+
+  FilterAllHitsRayResultCallback(PHY_IRayCastFilterCallback &phyRayFilter)
+      : m_phyRayFilter(phyRayFilter)
+  {
+  }
+
+  virtual ~FilterAllHitsRayResultCallback()
+  {
+  }
+
+  virtual bool needsCollision(btBroadphaseProxy *proxy0) const
+  {
+    return RayNeedsCollision(m_phyRayFilter, *this, proxy0);
+  }
+
+  virtual btScalar addSingleResult(btCollisionWorld::LocalRayResult &rayResult,
+                                   bool normalInWorldSpace)
+  {
+    Hit *hit = nullptr;
+    for (Hit &other : m_hits) {
+      if (other.m_object == rayResult.m_collisionObject) {
+        // A triangle mesh or compound shape reports several hits for the same object.
+        if (other.m_fraction <= rayResult.m_hitFraction) {
+          return m_closestHitFraction;
+        }
+        hit = &other;
+        break;
+      }
+    }
+
+    if (!hit) {
+      m_hits.emplace_back();
+      hit = &m_hits.back();
+      hit->m_object = rayResult.m_collisionObject;
+    }
+
+    hit->m_fraction = rayResult.m_hitFraction;
+    hit->m_hitNormalWorld = normalInWorldSpace ?
+                                rayResult.m_hitNormalLocal :
+                                rayResult.m_collisionObject->getWorldTransform().getBasis() *
+                                    rayResult.m_hitNormalLocal;
+    if (rayResult.m_localShapeInfo) {
+      hit->m_hitTriangleShape = rayResult.m_collisionObject->getCollisionShape();
+      hit->m_hitTriangleIndex = rayResult.m_localShapeInfo->m_triangleIndex;
+    }
+    else {
+      hit->m_hitTriangleShape = nullptr;
+      hit->m_hitTriangleIndex = 0;
+    }
+
+    m_collisionObject = rayResult.m_collisionObject;
+    // Don't shorten the ray to get the objects behind.
+    return m_closestHitFraction;
+  }
+};
+
 static bool GetHitTriangle(btCollisionShape *shape,
                            CcdShapeConstructionInfo *shapeInfo,
                            int hitTriangleIndex,
@@ -1153,6 +1248,142 @@ static bool GetHitTriangle(btCollisionShape *shape,
   return true;
 }
 
+/// Fill the ray cast result of a hit, retrieving the mesh polygon, UV and face normal if needed.
+static void GetRayCastResult(PHY_IRayCastFilterCallback &filterCallback,
+                             const btCollisionObject *collisionObject,
+                             const btVector3 &hitPointWorld,
+                             btVector3 hitNormalWorld,
+                             const btCollisionShape *hitTriangleShape,
+                             int hitTriangleIndex,
+                             PHY_RayCastResult &result)
+{
+  CcdPhysicsController *controller = static_cast<CcdPhysicsController *>(
+      collisionObject->getUserPointer());
+  result.m_controller = controller;
+  result.m_hitPoint[0] = hitPointWorld.getX();
+  result.m_hitPoint[1] = hitPointWorld.getY();
+  result.m_hitPoint[2] = hitPointWorld.getZ();
+
+  if (hitTriangleShape != nullptr) {
+    // identify the mesh polygon
+    CcdShapeConstructionInfo *shapeInfo = controller->GetShapeInfo();
+    if (shapeInfo) {
+      btCollisionShape *shape = controller->GetCollisionObject()->getCollisionShape();
+      if (shape->isCompound()) {
+        btCompoundShape *compoundShape = (btCompoundShape *)shape;
+        CcdShapeConstructionInfo *compoundShapeInfo = shapeInfo;
+        // need to search which sub-shape has been hit
+        for (int i = 0; i < compoundShape->getNumChildShapes(); i++) {
+          shapeInfo = compoundShapeInfo->GetChildShape(i);
+          shape = compoundShape->getChildShape(i);
+          if (shape == hitTriangleShape)
+            break;
+        }
+      }
+      if (shape == hitTriangleShape && hitTriangleIndex < shapeInfo->m_polygonIndexArray.size()) {
+        // save original collision shape triangle for soft body
+        const int shapeTriangleIndex = hitTriangleIndex;
+
+        result.m_meshObject = shapeInfo->GetMesh();
+        if (shape->isSoftBody()) {
+          // soft body using different face numbering because of randomization
+          // hopefully we have stored the original face number in m_tag
+          const btSoftBody *softBody = static_cast<const btSoftBody *>(collisionObject);
+          if (softBody->m_faces[shapeTriangleIndex].m_tag != 0) {
+            hitTriangleIndex = (int)((uintptr_t)(softBody->m_faces[shapeTriangleIndex].m_tag) -
+                                     1);
+          }
+        }
+        // retrieve the original mesh polygon (in case of quad->tri conversion)
+        result.m_polygon = shapeInfo->m_polygonIndexArray.at(hitTriangleIndex);
+        // hit triangle in world coordinate, for face normal and UV coordinate
+        btVector3 triangle[3];
+        bool triangleOK = false;
+        if (filterCallback.m_faceUV &&
+            (3 * hitTriangleIndex) < shapeInfo->m_triFaceUVcoArray.size()) {
+          // interpolate the UV coordinate of the hit point
+          CcdShapeConstructionInfo::UVco *uvCo =
+              &shapeInfo->m_triFaceUVcoArray[3 * hitTriangleIndex];
+          // 1. get the 3 coordinate of the triangle in world space
+          btVector3 v1, v2, v3;
+          if (shape->isSoftBody()) {
+            // soft body give points directly in world coordinate
+            const btSoftBody *softBody = static_cast<const btSoftBody *>(collisionObject);
+            v1 = softBody->m_faces[shapeTriangleIndex].m_n[0]->m_x;
+            v2 = softBody->m_faces[shapeTriangleIndex].m_n[1]->m_x;
+            v3 = softBody->m_faces[shapeTriangleIndex].m_n[2]->m_x;
+          }
+          else {
+            // for rigid body we must apply the world transform
+            triangleOK = GetHitTriangle(shape, shapeInfo, shapeTriangleIndex, triangle);
+            if (!triangleOK)
+              // if we cannot get the triangle, no use to continue
+              goto SKIP_UV_NORMAL;
+            v1 = collisionObject->getWorldTransform()(triangle[0]);
+            v2 = collisionObject->getWorldTransform()(triangle[1]);
+            v3 = collisionObject->getWorldTransform()(triangle[2]);
+          }
+          // 2. compute barycentric coordinate of the hit point
+          btVector3 v = v2 - v1;
+          btVector3 w = v3 - v1;
+          btVector3 u = v.cross(w);
+          btScalar A = u.length();
+
+          v = v2 - hitPointWorld;
+          w = v3 - hitPointWorld;
+          u = v.cross(w);
+          btScalar A1 = u.length();
+
+          v = hitPointWorld - v1;
+          w = v3 - v1;
+          u = v.cross(w);
+          btScalar A2 = u.length();
+
+          btVector3 baryCo;
+          baryCo.setX(A1 / A);
+          baryCo.setY(A2 / A);
+          baryCo.setZ(1.0f - baryCo.getX() - baryCo.getY());
+          // 3. compute UV coordinate
+          result.m_hitUV[0] = baryCo.getX() * uvCo[0].uv[0] + baryCo.getY() * uvCo[1].uv[0] +
+                              baryCo.getZ() * uvCo[2].uv[0];
+          result.m_hitUV[1] = baryCo.getX() * uvCo[0].uv[1] + baryCo.getY() * uvCo[1].uv[1] +
+                              baryCo.getZ() * uvCo[2].uv[1];
+          result.m_hitUVOK = 1;
+        }
+
+        // Bullet returns the normal from "outside".
+        // If the user requests the real normal, compute it now
+        if (filterCallback.m_faceNormal) {
+          if (shape->isSoftBody()) {
+            // we can get the real normal directly from the body
+            const btSoftBody *softBody = static_cast<const btSoftBody *>(collisionObject);
+            hitNormalWorld = softBody->m_faces[shapeTriangleIndex].m_normal;
+          }
+          else {
+            if (!triangleOK)
+              triangleOK = GetHitTriangle(shape, shapeInfo, shapeTriangleIndex, triangle);
+            if (triangleOK) {
+              btVector3 triangleNormal;
+              triangleNormal = (triangle[1] - triangle[0]).cross(triangle[2] - triangle[0]);
+              hitNormalWorld = collisionObject->getWorldTransform().getBasis() * triangleNormal;
+            }
+          }
+        }
+      SKIP_UV_NORMAL:;
+      }
+    }
+  }
+  if (hitNormalWorld.length2() > (SIMD_EPSILON * SIMD_EPSILON)) {
+    hitNormalWorld.normalize();
+  }
+  else {
+    hitNormalWorld.setValue(1.0f, 0.0f, 0.0f);
+  }
+  result.m_hitNormal[0] = hitNormalWorld.getX();
+  result.m_hitNormal[1] = hitNormalWorld.getY();
+  result.m_hitNormal[2] = hitNormalWorld.getZ();
+}
+
 PHY_IPhysicsController *CcdPhysicsEnvironment::RayTest(PHY_IRayCastFilterCallback &filterCallback,
                                                        float fromX,
                                                        float fromY,
@@ -1164,8 +1395,6 @@ PHY_IPhysicsController *CcdPhysicsEnvironment::RayTest(PHY_IRayCastFilterCallbac
   btVector3 rayFrom(fromX, fromY, fromZ);
   btVector3 rayTo(toX, toY, toZ);
 
-  btVector3 hitPointWorld, normalWorld;
-
   // Either Ray Cast with or without filtering
 
   // btCollisionWorld::ClosestRayResultCallback rayCallback(rayFrom,rayTo);
@@ -1182,142 +1411,59 @@ PHY_IPhysicsController *CcdPhysicsEnvironment::RayTest(PHY_IRayCastFilterCallbac
 
   m_dynamicsWorld->rayTest(rayFrom, rayTo, rayCallback);
   if (rayCallback.hasHit()) {
-    CcdPhysicsController *controller = static_cast<CcdPhysicsController *>(
-        rayCallback.m_collisionObject->getUserPointer());
-    result.m_controller = controller;
-    result.m_hitPoint[0] = rayCallback.m_hitPointWorld.getX();
-    result.m_hitPoint[1] = rayCallback.m_hitPointWorld.getY();
-    result.m_hitPoint[2] = rayCallback.m_hitPointWorld.getZ();
-
-    if (rayCallback.m_hitTriangleShape != nullptr) {
-      // identify the mesh polygon
-      CcdShapeConstructionInfo *shapeInfo = controller->m_shapeInfo;
-      if (shapeInfo) {
-        btCollisionShape *shape = controller->GetCollisionObject()->getCollisionShape();
-        if (shape->isCompound()) {
-          btCompoundShape *compoundShape = (btCompoundShape *)shape;
-          CcdShapeConstructionInfo *compoundShapeInfo = shapeInfo;
-          // need to search which sub-shape has been hit
-          for (int i = 0; i < compoundShape->getNumChildShapes(); i++) {
-            shapeInfo = compoundShapeInfo->GetChildShape(i);
-            shape = compoundShape->getChildShape(i);
-            if (shape == rayCallback.m_hitTriangleShape)
-              break;
-          }
-        }
-        if (shape == rayCallback.m_hitTriangleShape &&
-            rayCallback.m_hitTriangleIndex < shapeInfo->m_polygonIndexArray.size()) {
-          // save original collision shape triangle for soft body
-          int hitTriangleIndex = rayCallback.m_hitTriangleIndex;
-
-          result.m_meshObject = shapeInfo->GetMesh();
-          if (shape->isSoftBody()) {
-            // soft body using different face numbering because of randomization
-            // hopefully we have stored the original face number in m_tag
-            const btSoftBody *softBody = static_cast<const btSoftBody *>(
-                rayCallback.m_collisionObject);
-            if (softBody->m_faces[hitTriangleIndex].m_tag != 0) {
-              rayCallback.m_hitTriangleIndex =
-                  (int)((uintptr_t)(softBody->m_faces[hitTriangleIndex].m_tag) - 1);
-            }
-          }
-          // retrieve the original mesh polygon (in case of quad->tri conversion)
-          result.m_polygon = shapeInfo->m_polygonIndexArray.at(rayCallback.m_hitTriangleIndex);
-          // hit triangle in world coordinate, for face normal and UV coordinate
-          btVector3 triangle[3];
-          bool triangleOK = false;
-          if (filterCallback.m_faceUV &&
-              (3 * rayCallback.m_hitTriangleIndex) < shapeInfo->m_triFaceUVcoArray.size()) {
-            // interpolate the UV coordinate of the hit point
-            CcdShapeConstructionInfo::UVco *uvCo =
-                &shapeInfo->m_triFaceUVcoArray[3 * rayCallback.m_hitTriangleIndex];
-            // 1. get the 3 coordinate of the triangle in world space
-            btVector3 v1, v2, v3;
-            if (shape->isSoftBody()) {
-              // soft body give points directly in world coordinate
-              const btSoftBody *softBody = static_cast<const btSoftBody *>(
-                  rayCallback.m_collisionObject);
-              v1 = softBody->m_faces[hitTriangleIndex].m_n[0]->m_x;
-              v2 = softBody->m_faces[hitTriangleIndex].m_n[1]->m_x;
-              v3 = softBody->m_faces[hitTriangleIndex].m_n[2]->m_x;
-            }
-            else {
-              // for rigid body we must apply the world transform
-              triangleOK = GetHitTriangle(shape, shapeInfo, hitTriangleIndex, triangle);
-              if (!triangleOK)
-                // if we cannot get the triangle, no use to continue
-                goto SKIP_UV_NORMAL;
-              v1 = rayCallback.m_collisionObject->getWorldTransform()(triangle[0]);
-              v2 = rayCallback.m_collisionObject->getWorldTransform()(triangle[1]);
-              v3 = rayCallback.m_collisionObject->getWorldTransform()(triangle[2]);
-            }
-            // 2. compute barycentric coordinate of the hit point
-            btVector3 v = v2 - v1;
-            btVector3 w = v3 - v1;
-            btVector3 u = v.cross(w);
-            btScalar A = u.length();
-
-            v = v2 - rayCallback.m_hitPointWorld;
-            w = v3 - rayCallback.m_hitPointWorld;
-            u = v.cross(w);
-            btScalar A1 = u.length();
-
-            v = rayCallback.m_hitPointWorld - v1;
-            w = v3 - v1;
-            u = v.cross(w);
-            btScalar A2 = u.length();
-
-            btVector3 baryCo;
-            baryCo.setX(A1 / A);
-            baryCo.setY(A2 / A);
-            baryCo.setZ(1.0f - baryCo.getX() - baryCo.getY());
-            // 3. compute UV coordinate
-            result.m_hitUV[0] = baryCo.getX() * uvCo[0].uv[0] + baryCo.getY() * uvCo[1].uv[0] +
-                                baryCo.getZ() * uvCo[2].uv[0];
-            result.m_hitUV[1] = baryCo.getX() * uvCo[0].uv[1] + baryCo.getY() * uvCo[1].uv[1] +
-                                baryCo.getZ() * uvCo[2].uv[1];
-            result.m_hitUVOK = 1;
-          }
-
-          // Bullet returns the normal from "outside".
-          // If the user requests the real normal, compute it now
-          if (filterCallback.m_faceNormal) {
-            if (shape->isSoftBody()) {
-              // we can get the real normal directly from the body
-              const btSoftBody *softBody = static_cast<const btSoftBody *>(
-                  rayCallback.m_collisionObject);
-              rayCallback.m_hitNormalWorld = softBody->m_faces[hitTriangleIndex].m_normal;
-            }
-            else {
-              if (!triangleOK)
-                triangleOK = GetHitTriangle(shape, shapeInfo, hitTriangleIndex, triangle);
-              if (triangleOK) {
-                btVector3 triangleNormal;
-                triangleNormal = (triangle[1] - triangle[0]).cross(triangle[2] - triangle[0]);
-                rayCallback.m_hitNormalWorld =
-                    rayCallback.m_collisionObject->getWorldTransform().getBasis() * triangleNormal;
-              }
-            }
-          }
-        SKIP_UV_NORMAL:;
-        }
-      }
-    }
-    if (rayCallback.m_hitNormalWorld.length2() > (SIMD_EPSILON * SIMD_EPSILON)) {
-      rayCallback.m_hitNormalWorld.normalize();
-    }
-    else {
-      rayCallback.m_hitNormalWorld.setValue(1.0f, 0.0f, 0.0f);
-    }
-    result.m_hitNormal[0] = rayCallback.m_hitNormalWorld.getX();
-    result.m_hitNormal[1] = rayCallback.m_hitNormalWorld.getY();
-    result.m_hitNormal[2] = rayCallback.m_hitNormalWorld.getZ();
+    GetRayCastResult(filterCallback,
+                     rayCallback.m_collisionObject,
+                     rayCallback.m_hitPointWorld,
+                     rayCallback.m_hitNormalWorld,
+                     rayCallback.m_hitTriangleShape,
+                     rayCallback.m_hitTriangleIndex,
+                     result);
     filterCallback.reportHit(&result);
   }
 
   return result.m_controller;
 }
 
+void CcdPhysicsEnvironment::RayTestAll(PHY_IRayCastFilterCallback &filterCallback,
+                                       float fromX,
+                                       float fromY,
+                                       float fromZ,
+                                       float toX,
+                                       float toY,
+                                       float toZ)
+{
+  btVector3 rayFrom(fromX, fromY, fromZ);
+  btVector3 rayTo(toX, toY, toZ);
+
+  FilterAllHitsRayResultCallback rayCallback(filterCallback);
+
+  // Same filtering and precision as RayTest().
+  rayCallback.m_collisionFilterMask = CcdConstructionInfo::AllFilter ^
+                                      CcdConstructionInfo::SensorFilter;
+  rayCallback.m_flags |= btTriangleRaycastCallback::kF_UseSubSimplexConvexCastRaytest;
+
+  m_dynamicsWorld->rayTest(rayFrom, rayTo, rayCallback);
+
+  std::sort(rayCallback.m_hits.begin(),
+            rayCallback.m_hits.end(),
+            [](const FilterAllHitsRayResultCallback::Hit &hit1,
+               const FilterAllHitsRayResultCallback::Hit &hit2) {
+              return hit1.m_fraction < hit2.m_fraction;
+            });
+
+  for (const FilterAllHitsRayResultCallback::Hit &hit : rayCallback.m_hits) {
+    PHY_RayCastResult result;
+    GetRayCastResult(filterCallback,
+                     hit.m_object,
+                     rayFrom.lerp(rayTo, hit.m_fraction),
+                     hit.m_hitNormalWorld,
+                     hit.m_hitTriangleShape,
+                     hit.m_hitTriangleIndex,
+                     result);
+    filterCallback.reportHit(&result);
+  }
+}
+
 // Handles occlusion culling.
 // The implementation is based on the CDTestFramework
 struct OcclusionBuffer {
@@ -1949,6 +2095,31 @@ int CcdPhysicsEnvironment::GetNumContactPoints()
   return 0;
 }
 
+unsigned int CcdPhysicsEnvironment::GetNumControllers() const
+{
+  return m_controllers.size();
+}
+
+unsigned int CcdPhysicsEnvironment::GetNumActiveBodies() const
+{
+  const btCollisionObjectArray &objects = m_dynamicsWorld->getCollisionObjectArray();
+
+  unsigned int count = 0;
+  for (int i = 0, size = objects.size(); i < size; ++i) {
+    const btCollisionObject *object = objects[i];
+    if (!object->isStaticOrKinematicObject() && object->isActive()) {
+      ++count;
+    }
+  }
+
+  return count;
+}
+
+unsigned int CcdPhysicsEnvironment::GetNumContactManifolds() const
+{
+  return m_dynamicsWorld->getDispatcher()->getNumManifolds();
+}
+
 void CcdPhysicsEnvironment::GetContactPoint(
     int i, float &hitX, float &hitY, float &hitZ, float &normalX, float &normalY, float &normalZ)
 {
@@ -2112,7 +2283,8 @@ void CcdPhysicsEnvironment::CallbackTriggers()
       manifold->clearManifold();  // refreshContactPoints(rb0->getCenterOfMassTransform(),rb1->getCenterOfMassTransform());
     }
 
-    const CcdCollData *coll_data = new CcdCollData(manifold);
+    // The collision data is read by the logic of the next frame and released with its arena.
+    const CcdCollData *coll_data = CM_FrameArena::GetActive()->New<CcdCollData>(manifold);
     m_triggerCallbacks[PHY_OBJECT_RESPONSE](m_triggerCallbacksUserPtrs[PHY_OBJECT_RESPONSE], ctrl0, ctrl1, coll_data, first);
   }
 }
@@ -3267,6 +3439,64 @@ void CcdPhysicsEnvironment::ConvertObject(BL_SceneConverter *converter,
   physicscontroller->SetParentRoot(parentCtrl);
 }
 
+static void build_mesh_bvh_task(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  ((CcdShapeConstructionInfo *)taskdata)->BuildOptimizedBvh();
+}
+
+void CcdPhysicsEnvironment::PrepareMeshShapes(KX_Scene *kxscene,
+                                              const std::vector<KX_GameObject *> &objects)
+{
+  for (KX_GameObject *gameobj : objects) {
+    Object *blenderobject = gameobj->GetBlenderObject();
+    if (!blenderobject || blenderobject->type != OB_MESH || gameobj->GetMeshCount() == 0) {
+      continue;
+    }
+
+    // Only the static triangle mesh shapes use a BVH, see ConvertObject.
+    const int gameflag = blenderobject->gameflag;
+    if (!(gameflag & OB_COLLISION) ||
+        (gameflag & (OB_DYNAMIC | OB_SENSOR | OB_SOFT_BODY | OB_CHARACTER))) {
+      continue;
+    }
+    if ((gameflag & OB_BOUNDS) && blenderobject->collision_boundtype != OB_BOUND_TRIANGLE_MESH) {
+      continue;
+    }
+
+    RAS_MeshObject *meshobj = gameobj->GetMesh(0);
+    if (CcdShapeConstructionInfo::FindMesh(meshobj, false)) {
+      continue;
+    }
+
+    // The shape is registered for sharing and found by ConvertObject.
+    CcdShapeConstructionInfo *shapeInfo = new CcdShapeConstructionInfo();
+    if (!shapeInfo->SetMesh(kxscene, meshobj, false)) {
+      shapeInfo->Release();
+      continue;
+    }
+    m_preparedMeshShapes.push_back(shapeInfo);
+  }
+
+  if (m_preparedMeshShapes.empty()) {
+    return;
+  }
+
+  TaskPool *pool = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
+  for (CcdShapeConstructionInfo *shapeInfo : m_preparedMeshShapes) {
+    BLI_task_pool_push(pool, build_mesh_bvh_task, shapeInfo, false, nullptr);
+  }
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
+}
+
+void CcdPhysicsEnvironment::ClearPreparedMeshShapes()
+{
+  for (CcdShapeConstructionInfo *shapeInfo : m_preparedMeshShapes) {
+    shapeInfo->Release();
+  }
+  m_preparedMeshShapes.clear();
+}
+
 void CcdPhysicsEnvironment::SetupObjectConstraints(KX_GameObject *obj_src,
                                                    KX_GameObject *obj_dest,
                                                    bRigidBodyJointConstraint *dat,
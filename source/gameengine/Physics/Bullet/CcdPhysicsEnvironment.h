@@ -129,6 +129,10 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
     return m_numTimeSubSteps;
   }
 
+  virtual unsigned int GetNumControllers() const;
+  virtual unsigned int GetNumActiveBodies() const;
+  virtual unsigned int GetNumContactManifolds() const;
+
   /// Perform an integration step of duration 'timeStep'.
   virtual bool ProceedDeltaTime(double curTime, float timeStep, float interval);
 
@@ -141,6 +145,8 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
    */
   static void StaticSimulationSubtickCallback(btDynamicsWorld *world, btScalar timeStep);
   void SimulationSubtickCallback(btScalar timeStep);
+  /// Called by Bullet before every (sub)tick, to profile the ticks.
+  static void StaticSimulationPreSubtickCallback(btDynamicsWorld *world, btScalar timeStep);
 
   virtual void DebugDrawWorld();
   //		virtual bool		proceedDeltaTimeOneStep(float timeStep);
@@ -200,6 +206,13 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ);
+  virtual void RayTestAll(PHY_IRayCastFilterCallback &filterCallback,
+                          float fromX,
+                          float fromY,
+                          float fromZ,
+                          float toX,
+                          float toY,
+                          float toZ);
   virtual bool CullingTest(PHY_CullingCallback callback,
                            void *userData,
                            const std::array<MT_Vector4, 6> &planes,
@@ -292,6 +305,9 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
                              bool isCompoundChild,
                              bool hasCompoundChildren);
 
+  virtual void PrepareMeshShapes(KX_Scene *kxscene, const std::vector<KX_GameObject *> &objects);
+  virtual void ClearPreparedMeshShapes();
+
   /* Set the rigid body joints constraints values for converted objects and replicated group
    * instances. */
   virtual void SetupObjectConstraints(KX_GameObject *obj_src,
@@ -307,6 +323,9 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   std::vector<WrapperVehicle *> m_wrapperVehicles;
 
+  /// Mesh shapes referenced between PrepareMeshShapes and ClearPreparedMeshShapes.
+  std::vector<CcdShapeConstructionInfo *> m_preparedMeshShapes;
+
   /** use explicit btSoftRigidDynamicsWorld/btDiscreteDynamicsWorld* so that we have access to
    * btDiscreteDynamicsWorld::addRigidBody(body,filter,group)
    * so that we can set the body collision filter/group at the time of creation
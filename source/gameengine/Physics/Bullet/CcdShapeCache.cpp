@@ -0,0 +1,194 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Physics/Bullet/CcdShapeCache.cpp
+ *  \ingroup physbullet
+ */
+
+#include "CcdShapeCache.h"
+
+#include <xxhash.h>
+
+#include "LinearMath/btConvexHull.h"
+
+#include "CM_Message.h"
+
+std::unordered_multimap<CcdShapeCache::Key, CcdShapeCache::HullEntry *> CcdShapeCache::m_hulls;
+std::unordered_map<const btVector3 *, CcdShapeCache::HullEntry *> CcdShapeCache::m_hullPoints;
+CM_ThreadMutex CcdShapeCache::m_mutex;
+unsigned int CcdShapeCache::m_hullMaxVertices = 0;
+unsigned int CcdShapeCache::m_numShapes = 0;
+
+static bool hull_points_equal(const btAlignedObjectArray<btVector3> &points,
+                              const btAlignedObjectArray<btScalar> &vertices)
+{
+  if (points.size() * 3 != vertices.size()) {
+    return false;
+  }
+
+  for (int i = 0, size = points.size(); i < size; ++i) {
+    const btScalar *vert = &vertices[i * 3];
+    if (points[i] != btVector3(vert[0], vert[1], vert[2])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+btConvexPointCloudShape *CcdShapeCache::CreateConvexHull(
+    const btAlignedObjectArray<btScalar> &vertices)
+{
+  const int numPoints = vertices.size() / 3;
+  const Key key = XXH3_64bits(&vertices[0], vertices.size() * sizeof(btScalar));
+
+  m_mutex.Lock();
+
+  HullEntry *entry = nullptr;
+  const auto range = m_hulls.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (hull_points_equal(it->second->m_points, vertices)) {
+      entry = it->second;
+      break;
+    }
+  }
+
+  if (!entry) {
+    entry = new HullEntry();
+    entry->m_key = key;
+    entry->m_users = 0;
+    entry->m_points.resize(numPoints);
+    for (int i = 0; i < numPoints; ++i) {
+      const btScalar *vert = &vertices[i * 3];
+      entry->m_points[i].setValue(vert[0], vert[1], vert[2]);
+    }
+
+    m_hulls.emplace(key, entry);
+    m_hullPoints[&entry->m_points[0]] = entry;
+  }
+
+  ++entry->m_users;
+  ++m_numShapes;
+
+  m_mutex.Unlock();
+
+  return new btConvexPointCloudShape(&entry->m_points[0], numPoints, btVector3(1.0f, 1.0f, 1.0f));
+}
+
+bool CcdShapeCache::ReleaseShape(btCollisionShape *shape)
+{
+  if (shape->getShapeType() != CONVEX_POINT_CLOUD_SHAPE_PROXYTYPE) {
+    return false;
+  }
+
+  const btVector3 *points = static_cast<btConvexPointCloudShape *>(shape)->getUnscaledPoints();
+
+  m_mutex.Lock();
+
+  const auto it = m_hullPoints.find(points);
+  if (it == m_hullPoints.end()) {
+    m_mutex.Unlock();
+    return false;
+  }
+
+  HullEntry *entry = it->second;
+  --m_numShapes;
+  if (--entry->m_users == 0) {
+    m_hullPoints.erase(it);
+    const auto range = m_hulls.equal_range(entry->m_key);
+    for (auto hit = range.first; hit != range.second; ++hit) {
+      if (hit->second == entry) {
+        m_hulls.erase(hit);
+        break;
+      }
+    }
+    delete entry;
+  }
+
+  m_mutex.Unlock();
+
+  return true;
+}
+
+unsigned int CcdShapeCache::GetHullMaxVertices()
+{
+  return m_hullMaxVertices;
+}
+
+void CcdShapeCache::SetHullMaxVertices(unsigned int maxVertices)
+{
+  m_hullMaxVertices = maxVertices;
+}
+
+bool CcdShapeCache::ReduceConvexHull(btAlignedObjectArray<btScalar> &vertices)
+{
+  const unsigned int numVertices = vertices.size() / 3;
+  if (m_hullMaxVertices == 0 || numVertices <= 4) {
+    return false;
+  }
+
+  HullDesc desc(QF_TRIANGLES,
+                numVertices,
+                (const btVector3 *)&vertices[0],
+                3 * sizeof(btScalar));
+  desc.mMaxVertices = m_hullMaxVertices;
+
+  HullResult result;
+  HullLibrary library;
+  if (library.CreateConvexHull(desc, result) != QE_OK) {
+    return false;
+  }
+
+  const unsigned int numOutput = result.mNumOutputVertices;
+  // A degenerated hull keeps the original vertices.
+  const bool reduced = (numOutput >= 4 && numOutput < numVertices);
+  if (reduced) {
+    vertices.resize(numOutput * 3);
+    for (unsigned int i = 0; i < numOutput; ++i) {
+      const btVector3 &point = result.m_OutputVertices[i];
+      vertices[i * 3] = point.x();
+      vertices[i * 3 + 1] = point.y();
+      vertices[i * 3 + 2] = point.z();
+    }
+  }
+
+  library.ReleaseResult(result);
+
+  return reduced;
+}
+
+void CcdShapeCache::PrintStats()
+{
+  m_mutex.Lock();
+
+  unsigned int numPoints = 0;
+  for (const auto &pair : m_hulls) {
+    numPoints += pair.second->m_points.size();
+  }
+
+  CM_Message(std::endl << "Shared convex hulls:");
+  CM_Message("\t hulls: " << m_hulls.size());
+  CM_Message("\t shapes: " << m_numShapes);
+  CM_Message("\t points: " << numPoints);
+
+  m_mutex.Unlock();
+}
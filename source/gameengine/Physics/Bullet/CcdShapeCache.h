@@ -0,0 +1,87 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CcdShapeCache.h
+ *  \ingroup physbullet
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "BulletCollision/CollisionShapes/btConvexPointCloudShape.h"
+#include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btVector3.h"
+
+#include "CM_Thread.h"
+
+/** Shared storage of the convex hull collision shapes.
+ *
+ * The hull points are stored once for all the shapes with an identical point set and each
+ * controller gets a light btConvexPointCloudShape referencing them, so its local scaling and
+ * margin remain private. The points are freed when the last shape using them is released.
+ */
+class CcdShapeCache {
+ private:
+  typedef uint64_t Key;
+
+  struct HullEntry {
+    Key m_key;
+    btAlignedObjectArray<btVector3> m_points;
+    unsigned int m_users;
+  };
+
+  /// Hulls by hash of their points, different point sets can share a hash.
+  static std::unordered_multimap<Key, HullEntry *> m_hulls;
+  /// Hulls by address of their points, to release them from a shape.
+  static std::unordered_map<const btVector3 *, HullEntry *> m_hullPoints;
+  /// The shapes can be created by the asynchronous scene conversions.
+  static CM_ThreadMutex m_mutex;
+
+  /// Maximum number of vertices of the reduced hulls, 0 to disable the reduction.
+  static unsigned int m_hullMaxVertices;
+
+  static unsigned int m_numShapes;
+
+ public:
+  /** Create a convex hull shape from a vertex array of 3 scalars per vertex,
+   * sharing its points with the other shapes created from identical vertices.
+   */
+  static btConvexPointCloudShape *CreateConvexHull(const btAlignedObjectArray<btScalar> &vertices);
+
+  /** Release the shared data of a shape created by the cache.
+   * \return False if the shape doesn't use shared data.
+   */
+  static bool ReleaseShape(btCollisionShape *shape);
+
+  static unsigned int GetHullMaxVertices();
+  static void SetHullMaxVertices(unsigned int maxVertices);
+
+  /** Replace the vertices of a convex hull by the vertices of its outer surface,
+   * limited to the maximum number of vertices set by SetHullMaxVertices().
+   * \return False if the reduction is disabled or failed, the vertices are unchanged.
+   */
+  static bool ReduceConvexHull(btAlignedObjectArray<btScalar> &vertices);
+
+  static void PrintStats();
+};
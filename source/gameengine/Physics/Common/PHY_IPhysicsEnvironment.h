@@ -38,6 +38,7 @@
 #include "PHY_DynamicTypes.h"
 
 #include <array>
+#include <vector>
 
 class PHY_IConstraint;
 class PHY_IVehicle;
@@ -152,6 +153,21 @@ class PHY_IPhysicsEnvironment {
   {
     return 0;
   }
+  /// Number of physics controllers in the environment.
+  virtual unsigned int GetNumControllers() const
+  {
+    return 0;
+  }
+  /// Number of dynamic bodies not sleeping.
+  virtual unsigned int GetNumActiveBodies() const
+  {
+    return 0;
+  }
+  /// Number of contact manifolds of the colliding pairs.
+  virtual unsigned int GetNumContactManifolds() const
+  {
+    return 0;
+  }
   /// setDeactivationTime sets the minimum time that an objects has to stay within the velocity
   /// tresholds until it gets fully deactivated
   virtual void SetDeactivationTime(float dTime)
@@ -240,6 +256,17 @@ class PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ) = 0;
+  /** Ray test reporting every object hit along the ray instead of the closest one.
+   * filterCallback.reportHit() is called once per object with its closest hit point, from the
+   * closest object to the farthest.
+   */
+  virtual void RayTestAll(PHY_IRayCastFilterCallback &filterCallback,
+                          float fromX,
+                          float fromY,
+                          float fromZ,
+                          float toX,
+                          float toY,
+                          float toZ) = 0;
 
   // culling based on physical broad phase
   // the plane number must be set as follow: near, far, left, right, top, botton
@@ -280,6 +307,17 @@ class PHY_IPhysicsEnvironment {
                              bool isCompoundChild,
                              bool hasCompoundChildren) = 0;
 
+  /** Prepare the shared mesh shapes of objects about to be converted, this is used to build
+   * their collision data in parallel before converting the objects one by one.
+   */
+  virtual void PrepareMeshShapes(KX_Scene *kxscene, const std::vector<KX_GameObject *> &objects)
+  {
+  }
+  /// Release the prepared mesh shapes, the shapes not used by a converted object are freed.
+  virtual void ClearPreparedMeshShapes()
+  {
+  }
+
   /* Set the rigid body joints constraints values for converted objects and replicated group
    * instances. */
   virtual void SetupObjectConstraints(KX_GameObject *obj_src,
@@ -122,3 +122,13 @@ PHY_IPhysicsController *DummyPhysicsEnvironment::RayTest(
   // collision detection / raytesting
   return nullptr;
 }
+
+void DummyPhysicsEnvironment::RayTestAll(PHY_IRayCastFilterCallback &filterCallback,
+                                         float fromX,
+                                         float fromY,
+                                         float fromZ,
+                                         float toX,
+                                         float toY,
+                                         float toZ)
+{
+}
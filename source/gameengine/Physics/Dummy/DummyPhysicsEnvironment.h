@@ -98,6 +98,13 @@ class DummyPhysicsEnvironment : public PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ);
+  virtual void RayTestAll(PHY_IRayCastFilterCallback &filterCallback,
+                          float fromX,
+                          float fromY,
+                          float fromZ,
+                          float toX,
+                          float toY,
+                          float toZ);
   virtual bool CullingTest(PHY_CullingCallback callback,
                            void *userData,
                            const std::array<MT_Vector4, 6> &planes,
@@ -7,6 +7,10 @@
 
 #include "SG_Frustum.h"
 
+#include <algorithm>
+
+#include "BLI_simd.h"
+
 #include "MT_Frustum.h"
 
 SG_Frustum::SG_Frustum(const MT_Matrix4x4 &matrix) : m_matrix(matrix)
@@ -56,17 +60,20 @@ SG_Frustum::TestType SG_Frustum::PointInsideFrustum(const MT_Vector3 &point) con
 
 SG_Frustum::TestType SG_Frustum::SphereInsideFrustum(const MT_Vector3 &center, float radius) const
 {
+  TestType result = INSIDE;
+
   for (const MT_Vector4 &plane : m_planes) {
     const float distance = plane.dot(center);
     if (distance < -radius) {
       return OUTSIDE;
     }
+    // Keep testing the other planes, the sphere can still be outside of one of them.
     else if (fabs(distance) <= radius) {
-      return INTERSECT;
+      result = INTERSECT;
     }
   }
 
-  return INSIDE;
+  return result;
 }
 
 SG_Frustum::TestType SG_Frustum::BoxInsideFrustum(const std::array<MT_Vector3, 8> &box) const
@@ -279,3 +286,118 @@ SG_Frustum::TestType SG_Frustum::FrustumInsideFrustum(const SG_Frustum &frustum)
 
   return INSIDE;
 }
+
+static inline void setVisibleBits(uint32_t *mask, unsigned int index, uint32_t bits)
+{
+  // The blocks of 4 items never overlap two words.
+  mask[index / 32] |= bits << (index % 32);
+}
+
+#if BLI_HAVE_SSE2
+static inline __m128 planeDistance4(const MT_Vector4 &plane,
+                                    const __m128 &x,
+                                    const __m128 &y,
+                                    const __m128 &z)
+{
+  const __m128 dx = _mm_mul_ps(_mm_set1_ps(plane[0]), x);
+  const __m128 dy = _mm_mul_ps(_mm_set1_ps(plane[1]), y);
+  const __m128 dz = _mm_mul_ps(_mm_set1_ps(plane[2]), z);
+  // Same order of additions as MT_Vector4::dot, for the same rounding as the per object tests.
+  return _mm_add_ps(_mm_add_ps(_mm_add_ps(dx, dy), dz), _mm_set1_ps(plane[3]));
+}
+#endif
+
+void SG_Frustum::SpheresInsideFrustum(const float *x,
+                                      const float *y,
+                                      const float *z,
+                                      const float *radius,
+                                      unsigned int count,
+                                      uint32_t *mask) const
+{
+  std::fill(mask, mask + (count + 31) / 32, 0);
+
+  unsigned int i = 0;
+#if BLI_HAVE_SSE2
+  for (; i + 4 <= count; i += 4) {
+    const __m128 px = _mm_loadu_ps(x + i);
+    const __m128 py = _mm_loadu_ps(y + i);
+    const __m128 pz = _mm_loadu_ps(z + i);
+    const __m128 negradius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+    __m128 outside = _mm_setzero_ps();
+    for (const MT_Vector4 &plane : m_planes) {
+      outside = _mm_or_ps(outside, _mm_cmplt_ps(planeDistance4(plane, px, py, pz), negradius));
+    }
+
+    setVisibleBits(mask, i, ~_mm_movemask_ps(outside) & 0xF);
+  }
+#endif
+
+  for (; i < count; ++i) {
+    bool outside = false;
+    for (const MT_Vector4 &plane : m_planes) {
+      if (plane.dot(MT_Vector3(x[i], y[i], z[i])) < -radius[i]) {
+        outside = true;
+        break;
+      }
+    }
+
+    if (!outside) {
+      setVisibleBits(mask, i, 1);
+    }
+  }
+}
+
+void SG_Frustum::AabbsInsideFrustum(const float *minx,
+                                    const float *miny,
+                                    const float *minz,
+                                    const float *maxx,
+                                    const float *maxy,
+                                    const float *maxz,
+                                    unsigned int count,
+                                    uint32_t *mask) const
+{
+  std::fill(mask, mask + (count + 31) / 32, 0);
+
+  /* For each plane only the AABB vertex the furthest on the positive side is tested, the
+   * bound of each axis is selected once from the sign of the plane normal. */
+  std::array<std::array<const float *, 3>, 6> farBounds;
+  for (unsigned short i = 0; i < 6; ++i) {
+    const MT_Vector4 &plane = m_planes[i];
+    farBounds[i] = {{(plane[0] < 0.0f) ? minx : maxx,
+                     (plane[1] < 0.0f) ? miny : maxy,
+                     (plane[2] < 0.0f) ? minz : maxz}};
+  }
+
+  unsigned int i = 0;
+#if BLI_HAVE_SSE2
+  for (; i + 4 <= count; i += 4) {
+    __m128 outside = _mm_setzero_ps();
+    for (unsigned short j = 0; j < 6; ++j) {
+      const std::array<const float *, 3> &bounds = farBounds[j];
+      const __m128 dist = planeDistance4(m_planes[j],
+                                         _mm_loadu_ps(bounds[0] + i),
+                                         _mm_loadu_ps(bounds[1] + i),
+                                         _mm_loadu_ps(bounds[2] + i));
+      outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, _mm_setzero_ps()));
+    }
+
+    setVisibleBits(mask, i, ~_mm_movemask_ps(outside) & 0xF);
+  }
+#endif
+
+  for (; i < count; ++i) {
+    bool outside = false;
+    for (unsigned short j = 0; j < 6; ++j) {
+      const std::array<const float *, 3> &bounds = farBounds[j];
+      if (m_planes[j].dot(MT_Vector3(bounds[0][i], bounds[1][i], bounds[2][i])) < 0.0f) {
+        outside = true;
+        break;
+      }
+    }
+
+    if (!outside) {
+      setVisibleBits(mask, i, 1);
+    }
+  }
+}
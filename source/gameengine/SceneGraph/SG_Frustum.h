@@ -8,6 +8,7 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 
 #include "MT_Matrix4x4.h"
 
@@ -36,4 +37,28 @@ class SG_Frustum {
                              const MT_Vector3 &max,
                              const MT_Matrix4x4 &mat) const;
   TestType FrustumInsideFrustum(const SG_Frustum &frustum) const;
+
+  /** Test an array of spheres in world space, given as separate arrays of center coordinates
+   * and radius, against all the frustum planes.
+   * \param mask The visibility bits, (count + 31) / 32 words, a bit is set when the
+   * sphere is not outside the frustum.
+   */
+  void SpheresInsideFrustum(const float *x,
+                            const float *y,
+                            const float *z,
+                            const float *radius,
+                            unsigned int count,
+                            uint32_t *mask) const;
+  /** Test an array of AABB in world space, given as separate arrays of bound coordinates,
+   * against all the frustum planes.
+   * \param mask The visibility bits, same as for SpheresInsideFrustum.
+   */
+  void AabbsInsideFrustum(const float *minx,
+                          const float *miny,
+                          const float *minz,
+                          const float *maxx,
+                          const float *maxy,
+                          const float *maxz,
+                          unsigned int count,
+                          uint32_t *mask) const;
 };
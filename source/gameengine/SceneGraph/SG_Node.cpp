@@ -386,6 +386,11 @@ void SG_Node::ClearDirty(DirtyFlag flag)
   m_dirty &= ~flag;
 }
 
+void SG_Node::SetDirty(DirtyFlag flag)
+{
+  m_dirty |= flag;
+}
+
 void SG_Node::SetParentRelation(SG_ParentRelation *relation)
 {
   m_parent_relation.reset(relation);
@@ -10,6 +10,7 @@
 #include <memory>
 #include <vector>
 
+#include "CM_PoolAllocator.h"
 #include "CM_Thread.h"
 #include "MT_Transform.h"
 #include "SG_ParentRelation.h"
@@ -83,13 +84,16 @@ class SG_Node : public SG_QList {
     DIRTY_NONE = 0,
     DIRTY_ALL = 0xFF,
     DIRTY_RENDER = (1 << 0),
-    DIRTY_CULLING = (1 << 1)
+    DIRTY_CULLING = (1 << 1),
+    DIRTY_ACTIVITY = (1 << 2)
   };
 
   SG_Node(void *clientobj, void *clientinfo, SG_Callbacks &callbacks);
   SG_Node(const SG_Node &other);
   virtual ~SG_Node();
 
+  CM_POOL_ALLOC_FUNCS
+
   /**
    * Add a child to this object. This also informs the child of
    * it's parent.
@@ -267,6 +271,7 @@ class SG_Node : public SG_QList {
   void ClearModified();
   void SetModified();
   void ClearDirty(DirtyFlag flag);
+  void SetDirty(DirtyFlag flag);
 
   /**
    * Define the relationship this node has with it's parent
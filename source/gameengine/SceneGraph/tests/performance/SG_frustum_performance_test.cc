@@ -0,0 +1,212 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cmath>
+#include <vector>
+
+#include "BLI_rand.hh"
+#include "BLI_timeit.hh"
+
+#include "MT_Transform.h"
+
+#include "SG_Frustum.h"
+
+/* Compare the culling of the objects by the batched frustum tests with the per object tests.
+ * The objects are spread in a cube of size 60 centered at the origin, so that most of them are
+ * culled as in a scene larger than the view. The batched tests must never cull an object kept by
+ * the per object tests, and keep exactly the same spheres. */
+
+static constexpr unsigned int OBJECTS_NUM = 100000;
+static constexpr unsigned int REPEAT_NUM = 100;
+
+/** A cube of size 20 centered at the origin. */
+static MT_Matrix4x4 orthoMatrix()
+{
+  return MT_Matrix4x4(0.1f,
+                      0.0f,
+                      0.0f,
+                      0.0f,
+                      0.0f,
+                      0.1f,
+                      0.0f,
+                      0.0f,
+                      0.0f,
+                      0.0f,
+                      0.1f,
+                      0.0f,
+                      0.0f,
+                      0.0f,
+                      0.0f,
+                      1.0f);
+}
+
+/** A perspective camera inside the objects, rotated on all the axes. */
+static MT_Matrix4x4 perspectiveMatrix()
+{
+  const float nearClip = 0.5f;
+  const float farClip = 40.0f;
+  const float aspect = 16.0f / 9.0f;
+  const float focal = 1.0f / tanf(0.5f * 1.0471976f);
+  const MT_Matrix4x4 projection(focal / aspect,
+                                0.0f,
+                                0.0f,
+                                0.0f,
+                                0.0f,
+                                focal,
+                                0.0f,
+                                0.0f,
+                                0.0f,
+                                0.0f,
+                                (farClip + nearClip) / (nearClip - farClip),
+                                2.0f * farClip * nearClip / (nearClip - farClip),
+                                0.0f,
+                                0.0f,
+                                -1.0f,
+                                0.0f);
+
+  const MT_Quaternion rotation(MT_Vector3(0.3f, -0.5f, 0.8f).normalized(), 0.9f);
+  const MT_Transform camera(MT_Vector3(5.0f, -3.0f, 8.0f), MT_Matrix3x3(rotation));
+
+  return projection * MT_Matrix4x4(camera).inverse();
+}
+
+struct FrustumTestData {
+  SG_Frustum frustum;
+  std::vector<float> x, y, z, radius;
+  std::vector<float> minx, miny, minz, maxx, maxy, maxz;
+  std::vector<uint32_t> mask;
+
+  FrustumTestData(const MT_Matrix4x4 &matrix) : frustum(matrix), mask((OBJECTS_NUM + 31) / 32)
+  {
+    blender::RandomNumberGenerator rng(0);
+    for (unsigned int i = 0; i < OBJECTS_NUM; ++i) {
+      const float cx = rng.get_float() * 60.0f - 30.0f;
+      const float cy = rng.get_float() * 60.0f - 30.0f;
+      const float cz = rng.get_float() * 60.0f - 30.0f;
+      const float extent = rng.get_float() * 2.0f;
+      x.push_back(cx);
+      y.push_back(cy);
+      z.push_back(cz);
+      radius.push_back(extent * 1.7320508f);
+      minx.push_back(cx - extent);
+      miny.push_back(cy - extent);
+      minz.push_back(cz - extent);
+      maxx.push_back(cx + extent);
+      maxy.push_back(cy + extent);
+      maxz.push_back(cz + extent);
+    }
+  }
+
+  bool IsVisible(unsigned int i) const
+  {
+    return (mask[i / 32] >> (i % 32)) & 1;
+  }
+};
+
+static void testSpheres(const MT_Matrix4x4 &matrix)
+{
+  FrustumTestData data(matrix);
+
+  {
+    SCOPED_TIMER("spheres batched");
+    for (unsigned int r = 0; r < REPEAT_NUM; ++r) {
+      data.frustum.SpheresInsideFrustum(data.x.data(),
+                                        data.y.data(),
+                                        data.z.data(),
+                                        data.radius.data(),
+                                        OBJECTS_NUM,
+                                        data.mask.data());
+    }
+  }
+
+  std::vector<bool> visible(OBJECTS_NUM);
+  {
+    SCOPED_TIMER("spheres per object");
+    for (unsigned int r = 0; r < REPEAT_NUM; ++r) {
+      for (unsigned int i = 0; i < OBJECTS_NUM; ++i) {
+        const MT_Vector3 center(data.x[i], data.y[i], data.z[i]);
+        visible[i] = (data.frustum.SphereInsideFrustum(center, data.radius[i]) !=
+                      SG_Frustum::OUTSIDE);
+      }
+    }
+  }
+
+  unsigned int visibleNum = 0;
+  for (unsigned int i = 0; i < OBJECTS_NUM; ++i) {
+    EXPECT_EQ(data.IsVisible(i), visible[i]) << "sphere " << i;
+    visibleNum += visible[i];
+  }
+
+  /* Both the culled and the kept objects are tested. */
+  EXPECT_GT(visibleNum, 0);
+  EXPECT_LT(visibleNum, OBJECTS_NUM / 2);
+}
+
+static void testAabbs(const MT_Matrix4x4 &matrix)
+{
+  FrustumTestData data(matrix);
+  MT_Matrix4x4 identity;
+  identity.setIdentity();
+
+  {
+    SCOPED_TIMER("aabbs batched");
+    for (unsigned int r = 0; r < REPEAT_NUM; ++r) {
+      data.frustum.AabbsInsideFrustum(data.minx.data(),
+                                      data.miny.data(),
+                                      data.minz.data(),
+                                      data.maxx.data(),
+                                      data.maxy.data(),
+                                      data.maxz.data(),
+                                      OBJECTS_NUM,
+                                      data.mask.data());
+    }
+  }
+
+  std::vector<bool> visible(OBJECTS_NUM);
+  {
+    SCOPED_TIMER("aabbs per object");
+    for (unsigned int r = 0; r < REPEAT_NUM; ++r) {
+      for (unsigned int i = 0; i < OBJECTS_NUM; ++i) {
+        const MT_Vector3 min(data.minx[i], data.miny[i], data.minz[i]);
+        const MT_Vector3 max(data.maxx[i], data.maxy[i], data.maxz[i]);
+        visible[i] = (data.frustum.AabbInsideFrustum(min, max, identity) != SG_Frustum::OUTSIDE);
+      }
+    }
+  }
+
+  /* The per object test also culls the boxes outside of the frustum bounding box, the batched
+   * test only tests the planes and can keep more boxes. */
+  unsigned int visibleNum = 0;
+  unsigned int visibleBatchedNum = 0;
+  for (unsigned int i = 0; i < OBJECTS_NUM; ++i) {
+    if (visible[i]) {
+      EXPECT_TRUE(data.IsVisible(i)) << "aabb " << i;
+    }
+    visibleNum += visible[i];
+    visibleBatchedNum += data.IsVisible(i);
+  }
+
+  EXPECT_GT(visibleNum, 0);
+  EXPECT_LT(visibleBatchedNum, OBJECTS_NUM / 2);
+}
+
+TEST(sg_frustum, SpheresInsideFrustumOrtho)
+{
+  testSpheres(orthoMatrix());
+}
+
+TEST(sg_frustum, SpheresInsideFrustumPerspective)
+{
+  testSpheres(perspectiveMatrix());
+}
+
+TEST(sg_frustum, AabbsInsideFrustumOrtho)
+{
+  testAabbs(orthoMatrix());
+}
+
+TEST(sg_frustum, AabbsInsideFrustumPerspective)
+{
+  testAabbs(perspectiveMatrix());
+}